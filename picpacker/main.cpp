@@ -0,0 +1,155 @@
+// This file is part of openCaesar3.
+//
+// openCaesar3 is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// openCaesar3 is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with openCaesar3.  If not, see <http://www.gnu.org/licenses/>.
+
+// Decodes png pictures of game archives once and writes them into pack,
+// which game maps into memory instead of decoding pictures on start.
+//
+//   picpacker <resources dir> <pack file>
+
+#include "gfx/engine.hpp"
+#include "gfx/picture_bank.hpp"
+#include "gfx/picture_pack.hpp"
+#include "vfs/filesystem.hpp"
+#include "vfs/filelist.hpp"
+#include "core/exception.hpp"
+#include "core/logger.hpp"
+#include "core/foreach.hpp"
+
+#include <SDL.h>
+#include <set>
+#include <cstdio>
+
+// engine without screen, keeps pictures in format of pack
+class PackerEngine : public GfxEngine
+{
+public:
+  PackerEngine() { _instance = this; }
+  virtual ~PackerEngine() { _instance = 0; }
+
+  virtual void init() {}
+  virtual void exit() {}
+  virtual void delay( const unsigned int ) {}
+  virtual bool haveEvent( NEvent& ) { return false; }
+
+  virtual void loadPicture( Picture& ) {}
+  virtual void unloadPicture( Picture& ioPicture )
+  {
+    SDL_FreeSurface( ioPicture.getSurface() );
+    ioPicture = Picture();
+  }
+
+  virtual void startRenderFrame() {}
+  virtual void endRenderFrame() {}
+
+  virtual void drawPicture( const Picture&, const int, const int, Rect* ) {}
+  virtual void drawPicture( const Picture&, const Point&, Rect* ) {}
+
+  virtual void setTileDrawMask( int, int, int, int ) {}
+  virtual void resetTileDrawMask() {}
+
+  virtual void deletePicture( Picture* pic )
+  {
+    if( pic )
+      unloadPicture( *pic );
+  }
+
+  virtual Picture* createPicture( const Size& size )
+  {
+    SDL_Surface* img = SDL_CreateRGBSurface( SDL_SWSURFACE, size.getWidth(), size.getHeight(), 32,
+                                             0x00ff0000, 0x0000ff00, 0x000000ff, 0xff000000 );
+    if( img == NULL )
+    {
+      THROW( "Cannot make surface, size=" << size.getWidth() << "x" << size.getHeight() );
+    }
+
+    Picture *pic = new Picture();
+    pic->init( img, Point( 0, 0 ) );
+    return pic;
+  }
+
+  virtual void createScreenshot( const std::string& ) {}
+  virtual unsigned int getFps() const { return 0; }
+  virtual Modes getAvailableModes() const { return Modes(); }
+};
+
+int main( int argc, char* argv[] )
+{
+  if( argc < 3 )
+  {
+    printf( "Usage: picpacker <resources dir> <pack file>\n" );
+    return 1;
+  }
+
+  try
+  {
+    PackerEngine engine;
+
+    std::string rcDir( argv[1] );
+    io::FileSystem& fs = io::FileSystem::instance();
+
+    const char* archives[] = { "/pics/pics_wait.zip", "/pics/pics.zip", "/pics/pics_oc3.zip", 0 };
+
+    // archives mounted first override pictures of next ones, as in game
+    std::set< std::string > names;
+    for( int i=0; archives[ i ] != 0; i++ )
+    {
+      io::ArchivePtr archive = fs.mountArchive( rcDir + archives[ i ] );
+      if( archive.isNull() )
+      {
+        Logger::warning( "picpacker: can't open %s", archives[ i ] );
+        continue;
+      }
+
+      const io::FileList* files = archive->getFileList();
+      for( unsigned int k=0; k < files->getFileCount(); k++ )
+      {
+        const io::FilePath& name = files->getFileName( k );
+        if( !files->isDirectory( k ) && name.isExtension( ".png", false ) )
+        {
+          names.insert( name.toString() );
+        }
+      }
+    }
+
+    PicturePackWriter writer;
+    if( !writer.open( io::FilePath( argv[2] ) ) )
+      return 1;
+
+    unsigned int packed = 0;
+    foreach( const std::string& name, names )
+    {
+      Picture& pic = PictureBank::instance().getPicture( name );
+      if( pic.isValid() && writer.append( name, pic ) )
+      {
+        packed++;
+      }
+    }
+
+    if( !writer.close() )
+    {
+      Logger::warning( "picpacker: can't write %s", argv[2] );
+      return 1;
+    }
+
+    Logger::warning( "picpacker: %d of %d pictures packed", packed, names.size() );
+  }
+  catch( Exception e )
+  {
+    Logger::warning( "FATAL ERROR: %s", e.getDescription().c_str() );
+    return 1;
+  }
+
+  return 0;
+}
@@ -31,6 +31,7 @@
 #include "events/event.hpp"
 #include "core/logger.hpp"
 #include "constants.hpp"
+#include "game/tickscheduler.hpp"
 
 using namespace constants;
 
@@ -55,15 +56,21 @@ void Building::initTerrain( Tile &tile )
 
 void Building::timeStep(const unsigned long time)
 {
-   if (time % 64 == 0)
-   {
-      updateState( Construction::damage, _damageIncrement );
-      updateState( Construction::fire, _fireIncrement );
-   }
-
    Construction::timeStep(time);
 }
 
+void Building::scheduleJobs( TickScheduler& scheduler )
+{
+   Construction::scheduleJobs( scheduler );
+   scheduler.add( this, 64, makeDelegate( this, &Building::_updateDamage ) );
+}
+
+void Building::_updateDamage( unsigned int time )
+{
+   updateState( Construction::damage, _damageIncrement );
+   updateState( Construction::fire, _fireIncrement );
+}
+
 void Building::storeGoods(GoodStock &stock, const int amount)
 {
    _OC3_DEBUG_BREAK_IF("This building should not store any goods");
@@ -230,6 +237,11 @@ void Dock::timeStep(const unsigned long time)
   _fgPicturesRef().at(0) = _animationRef().getFrame();
 }
 
+void Dock::scheduleJobs( TickScheduler& scheduler )
+{
+  // dock isn't damaged
+}
+
 // second arch pictures is land3a 45 + 46	
 
 TriumphalArch::TriumphalArch() : Building( building::triumphalArch, Size(3) )
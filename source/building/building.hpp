@@ -42,6 +42,7 @@ public:
   virtual void initTerrain(Tile& terrain);
 
   virtual void timeStep(const unsigned long time);
+  virtual void scheduleJobs( TickScheduler& scheduler );
   virtual void storeGoods(GoodStock &stock, const int amount = -1);
   // evaluate the given service
   virtual float evaluateService(ServiceWalkerPtr walker);
@@ -56,6 +57,8 @@ public:
   void applyTrainee( constants::walker::Type traineeType); // trainee arrives
 
 protected:
+  void _updateDamage( unsigned int time );
+
   float _damageIncrement;
   float _fireIncrement;
   typedef std::map< constants::walker::Type, int> TraineeMap;
@@ -102,6 +105,7 @@ class Dock : public Building
 public:
   Dock();
   void timeStep(const unsigned long time);
+  void scheduleJobs( TickScheduler& scheduler );
 };
 
 #endif
@@ -32,6 +32,7 @@
 #include "game/city.hpp"
 #include "core/foreach.hpp"
 #include "constants.hpp"
+#include "game/tickscheduler.hpp"
 
 using namespace constants;
 
@@ -109,13 +110,6 @@ void Factory::timeStep(const unsigned long time)
 {
    WorkingBuilding::timeStep(time);
 
-   //try get good from storage building for us
-   if( time % 22 == 1 && getWorkersCount() > 0 && getWalkers().size() == 0 )
-   {
-     receiveGood(); 
-     deliverGood();      
-   }
-
    //start/stop animation when workers found
    bool mayAnimate = mayWork();
 
@@ -184,6 +178,22 @@ void Factory::timeStep(const unsigned long time)
    }
 }
 
+void Factory::scheduleJobs( TickScheduler& scheduler )
+{
+  WorkingBuilding::scheduleJobs( scheduler );
+  scheduler.add( this, 22, makeDelegate( this, &Factory::_exchangeGoods ) );
+}
+
+void Factory::_exchangeGoods( unsigned int time )
+{
+  //try get good from storage building for us
+  if( getWorkersCount() > 0 && getWalkers().size() == 0 )
+  {
+    receiveGood();
+    deliverGood();
+  }
+}
+
 void Factory::deliverGood()
 {
   // make a cart pusher and send him away
@@ -54,6 +54,7 @@ public:
   virtual bool standIdle() const;
 
   virtual void timeStep(const unsigned long time);
+  virtual void scheduleJobs( TickScheduler& scheduler );
 
   virtual void save( VariantMap& stream) const;
   virtual void load( const VariantMap& stream);
@@ -64,6 +65,7 @@ public:
 
 protected:  
   virtual bool _mayDeliverGood() const;
+  void _exchangeGoods( unsigned int time );
   void _setError( const std::string& err );
 
 protected:
@@ -21,6 +21,7 @@
 #include "game/goodstore_simple.hpp"
 #include "game/city.hpp"
 #include "constants.hpp"
+#include "game/tickscheduler.hpp"
 
 class GranaryGoodStore : public SimpleGoodStore
 {
@@ -111,12 +112,21 @@ void Granary::timeStep(const unsigned long time)
     _animationRef().update( time );
 
     _fgPicturesRef().at(5) = _animationRef().getFrame();
+  }
+}
 
-    if( time % 22 == 1 && _d->goodStore.isDevastation() 
-        && (_d->goodStore.getCurrentQty() > 0) && getWalkers().empty() )
-    {
-      _tryDevastateGranary();
-    }
+void Granary::scheduleJobs( TickScheduler& scheduler )
+{
+  WorkingBuilding::scheduleJobs( scheduler );
+  scheduler.add( this, 22, makeDelegate( this, &Granary::_checkDevastation ) );
+}
+
+void Granary::_checkDevastation( unsigned int time )
+{
+  if( getWorkersCount() > 0 && _d->goodStore.isDevastation()
+      && (_d->goodStore.getCurrentQty() > 0) && getWalkers().empty() )
+  {
+    _tryDevastateGranary();
   }
 }
 
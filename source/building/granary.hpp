@@ -25,6 +25,7 @@ public:
   Granary();
 
   virtual void timeStep(const unsigned long time);
+  virtual void scheduleJobs( TickScheduler& scheduler );
   void computePictures();
   GoodStore& getGoodStore();
 
@@ -33,6 +34,7 @@ public:
 
 private:
   void _tryDevastateGranary();
+  void _checkDevastation( unsigned int time );
 
   class Impl;
   ScopedPtr< Impl > _d;
@@ -18,6 +18,7 @@
 #include "core/position.hpp"
 #include "gfx/tile.hpp"
 #include "constants.hpp"
+#include "game/tickscheduler.hpp"
 
 using namespace constants;
 
@@ -55,24 +56,25 @@ unsigned int Baths::getWalkerDistance() const
   return 35;
 }
 
-void Baths::timeStep(const unsigned long time)
+void Baths::scheduleJobs( TickScheduler& scheduler )
 {
-  if( time % 22 == 1 )
+  ServiceBuilding::scheduleJobs( scheduler );
+  scheduler.add( this, 22, makeDelegate( this, &Baths::_checkWater ) );
+}
+
+void Baths::_checkWater( unsigned int time )
+{
+  if( getTile().getWaterService( WTR_RESERVOIR ) > 0 && getWorkersCount() > 0 )
   {
-    if( getTile().getWaterService( WTR_RESERVOIR ) > 0 && getWorkersCount() > 0 )
-    {
-      _animationRef().start();
-      _haveReservorWater = true;
-    }
-    else
-    {
-      _animationRef().stop();
-      _haveReservorWater = false;
-      _fgPicturesRef().at(0) = Picture::getInvalid();
-    }
+    _animationRef().start();
+    _haveReservorWater = true;
+  }
+  else
+  {
+    _animationRef().stop();
+    _haveReservorWater = false;
+    _fgPicturesRef().at(0) = Picture::getInvalid();
   }
-
-  ServiceBuilding::timeStep( time );
 }
 
 void Baths::deliverService()
@@ -38,12 +38,13 @@ class Baths : public ServiceBuilding
 public:
   Baths();
 
-  virtual void timeStep(const unsigned long time);
+  virtual void scheduleJobs( TickScheduler& scheduler );
   virtual void deliverService();
   unsigned int getWalkerDistance() const;
 
 protected:
   void _initAnimation();
+  void _checkWater( unsigned int time );
 
   bool _haveReservorWater;
 };
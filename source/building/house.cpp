@@ -35,6 +35,7 @@
 #include "constants.hpp"
 #include "events/event.hpp"
 #include "events/fireworkers.hpp"
+#include "game/tickscheduler.hpp"
 
 class House::Impl
 {
@@ -53,6 +54,7 @@ public:
   std::string condition4Up;  
   CitizenGroup habitants;
   int currentYear;
+  bool walkable;  // last walkability seen by tilemap caches
 
   bool mayPayTax()
   {
@@ -125,6 +127,7 @@ House::House(const int houseId) : Building( constants::building::house ), _d( ne
   _d->desirability.range = 3;
   _d->desirability.step = 1;
   _d->currentYear = GameDate::current().getYear();
+  _d->walkable = false;
   updateState( Construction::fire, 0, false );
 
   _d->initGoodStore( 1 );
@@ -144,6 +147,8 @@ House::House(const int houseId) : Building( constants::building::house ), _d( ne
 
 void House::timeStep(const unsigned long time)
 {
+  _checkWalkable();
+
   if( _d->habitants.empty()  )
     return;
 
@@ -153,58 +158,77 @@ void House::timeStep(const unsigned long time)
     _d->makeOldHabitants();
   }
 
-  if( time % 16 == 0 )
+  Building::timeStep( time );
+}
+
+void House::scheduleJobs( TickScheduler& scheduler )
+{
+  // damage is updated by _checkHouse(), only inhabited houses get it
+  scheduler.add( this, 16, makeDelegate( this, &House::_updateServices ) );
+  scheduler.add( this, 32, makeDelegate( this, &House::_updateCrime ) );
+  scheduler.add( this, 64, makeDelegate( this, &House::_checkHouse ) );
+}
+
+void House::_updateServices( unsigned int time )
+{
+  if( _d->habitants.empty() )
+    return;
+
+  _d->consumeServices();
+  _d->updateHealthLevel();
+}
+
+void House::_updateCrime( unsigned int time )
+{
+  if( _d->habitants.empty() )
+    return;
+
+  appendServiceValue( Service::crime, _d->spec.getCrime() + 2 );
+}
+
+void House::_checkHouse( unsigned int time )
+{
+  if( _d->habitants.empty() )
+    return;
+
+  // consume goods
+  for( int i = 0; i < Good::goodCount; ++i)
   {
-    _d->consumeServices();
-    _d->updateHealthLevel();    
+     Good::Type goodType = (Good::Type) i;
+     int montlyGoodsQty = _d->spec.computeMonthlyConsumption( *this, goodType, true );
+     _d->goodStore.setCurrentQty( goodType, std::max( _d->goodStore.getCurrentQty(goodType) - montlyGoodsQty, 0) );
   }
 
-  if( time % 32 == 0 )
+  bool validate = _d->spec.checkHouse( this );
+  if( !validate )
   {
-    appendServiceValue( Service::crime, _d->spec.getCrime() + 2 );
+    levelDown();
   }
-
-  if( time % 64 == 0 )
+  else
   {
-    // consume goods
-    for( int i = 0; i < Good::goodCount; ++i)
+    _d->condition4Up = "";
+    if( _d->spec.next().checkHouse( this, &_d->condition4Up ) )
     {
-       Good::Type goodType = (Good::Type) i;
-       int montlyGoodsQty = _d->spec.computeMonthlyConsumption( *this, goodType, true );
-       _d->goodStore.setCurrentQty( goodType, std::max( _d->goodStore.getCurrentQty(goodType) - montlyGoodsQty, 0) );
+       levelUp();
     }
+  }
 
-    bool validate = _d->spec.checkHouse( this );
-    if( !validate )
-    {
-      levelDown();
-    }
-    else
-    {
-      _d->condition4Up = "";
-      if( _d->spec.next().checkHouse( this, &_d->condition4Up ) )
-      {
-         levelUp();
-      }
-    }
+  int homelessCount = math::clamp( _d->habitants.count() - _d->maxHabitants, 0, 0xff );
+  if( homelessCount > 0 )
+  {
+    CitizenGroup homeless = _d->habitants.retrieve( homelessCount );
 
-    int homelessCount = math::clamp( _d->habitants.count() - _d->maxHabitants, 0, 0xff );
-    if( homelessCount > 0 )
+    int workersFireCount = homeless.count( CitizenGroup::mature );
+    if( workersFireCount > 0 )
     {
-      CitizenGroup homeless = _d->habitants.retrieve( homelessCount );
-
-      int workersFireCount = homeless.count( CitizenGroup::mature );
-      if( workersFireCount > 0 )
-      {
-        events::GameEventPtr e = events::FireWorkers::create( getTilePos(), workersFireCount );
-        e->dispatch();
-      }
-
-      Immigrant::send2City( _getCity(), homeless, getTile() );
+      events::GameEventPtr e = events::FireWorkers::create( getTilePos(), workersFireCount );
+      e->dispatch();
     }
+
+    Immigrant::send2City( _getCity(), homeless, getTile() );
   }
 
-  Building::timeStep( time );
+  _updateDamage( time );
 }
 
 GoodStore& House::getGoodStore()
@@ -631,6 +655,22 @@ void House::_update()
   setSize( Size( (pic.getWidth() + 2 ) / 60 ) );
   _d->maxHabitants = _d->spec.getMaxHabitantsByTile() * getSize().getArea();
   _d->initGoodStore( getSize().getArea() );
+  _checkWalkable();
+}
+
+void House::_checkWalkable()
+{
+  // empty hovel may be walked through, pathfinder caches see it by revisions of tiles
+  bool walkable = isWalkable();
+  if( walkable == _d->walkable )
+    return;
+
+  _d->walkable = walkable;
+  CityPtr city = _getCity();
+  if( city.isValid() )
+  {
+    city->getTilemap().invalidate( getTilePos(), getSize() );
+  }
 }
 
 int House::getRoadAccessDistance() const
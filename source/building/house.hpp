@@ -34,6 +34,7 @@ public:
   House( const int houseId=smallHovel );
 
   virtual void timeStep(const unsigned long time);
+  virtual void scheduleJobs( TickScheduler& scheduler );
 
   virtual GoodStore& getGoodStore();
 
@@ -82,6 +83,10 @@ public:
 private:
 
   void _update();
+  void _checkWalkable();
+  void _updateServices( unsigned int time );
+  void _updateCrime( unsigned int time );
+  void _checkHouse( unsigned int time );
   void _tryUpdate_1_to_11_lvl( int level, int startSmallPic, int startBigPic, const char desirability );
   void _tryDegrage_11_to_2_lvl( int smallPic, int bigPic, const char desirability );
 
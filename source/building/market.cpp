@@ -22,6 +22,7 @@
 #include "game/city.hpp"
 #include "walker/serviceman.hpp"
 #include "building/constants.hpp"
+#include "game/tickscheduler.hpp"
 
 
 class Market::Impl
@@ -147,20 +148,21 @@ void Market::load( const VariantMap& stream)
   _d->initStore();
 }
 
-void Market::timeStep(const unsigned long time)
+void Market::scheduleJobs( TickScheduler& scheduler )
 {
-  if( time % 16 == 0 )
+  ServiceBuilding::scheduleJobs( scheduler );
+  scheduler.add( this, 16, makeDelegate( this, &Market::_checkBuyer ) );
+}
+
+void Market::_checkBuyer( unsigned int time )
+{
+  WalkerList walkers = getWalkers();
+  if( walkers.size() > 0 && _d->goodStore.getCurrentQty() == 0 )
   {
-    WalkerList walkers = getWalkers();
-    if( walkers.size() > 0 && _d->goodStore.getCurrentQty() == 0 )
+    ServiceWalkerPtr walker = walkers.front().as<ServiceWalker>();
+    if( walker.isValid() )
     {
-      ServiceWalkerPtr walker = walkers.front().as<ServiceWalker>();
-      if( walker.isValid() )
-      {
-        walker->return2Base();
-      }
+      walker->return2Base();
     }
   }
-
-  ServiceBuilding::timeStep( time );
 }
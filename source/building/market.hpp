@@ -35,13 +35,15 @@ public:
   void save( VariantMap& stream) const;
   void load( const VariantMap& stream);
 
-  void timeStep(const unsigned long time);
+  void scheduleJobs( TickScheduler& scheduler );
 
   void deliverService();
 
   virtual unsigned int getWalkerDistance() const;
 
 private:
+  void _checkBuyer( unsigned int time );
+
   class Impl;
   ScopedPtr< Impl > _d;
 };
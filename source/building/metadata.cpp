@@ -20,6 +20,7 @@
 #include <map>
 #include "core/gettext.hpp"
 #include "core/saveadapter.hpp"
+#include "core/json.hpp"
 #include "core/stringhelper.hpp"
 #include "core/enumerator.hpp"
 #include "core/foreach.hpp"
@@ -320,55 +321,58 @@ void MetaDataHolder::initialize( const io::FilePath& filename )
   _d->mapBuildingByInGood[Good::olive]  = building::creamery;
   _d->mapBuildingByInGood[Good::grape]  = building::winery;
 
-  VariantMap constructions = SaveAdapter::load( filename.toString() );
+  // constructions are read one by one while file is parsed
+  JsonObjectReader reader;
+  CONNECT( &reader, onMember(), this, MetaDataHolder::_initConstruction );
+  SaveAdapter::load( filename.toString(), reader );
+}
+
+void MetaDataHolder::_initConstruction( const std::string& name, const Variant& stream )
+{
+  VariantMap options = stream.toMap();
+
+  const TileOverlay::Type btype = getType( name );
+  if( btype == building::unknown )
+  {
+    Logger::warning( "!!!Warning: can't associate type with %s", name.c_str() );
+    return;
+  }
+
+  Impl::BuildingsMap::const_iterator bdataIt = _d->buildings.find( btype );
+  if( bdataIt != _d->buildings.end() )
+  {
+    Logger::warning( "!!!Warning: type %s also initialized", name.c_str() );
+    return;
+  }
+
+  MetaData bData( btype, name );
+  const std::string pretty = options[ "pretty" ].toString();
+  if( !pretty.empty() )
+  {
+    bData._prettyName = pretty;
+  }
+
+  bData._d->options = options;
+  VariantMap desMap = options[ "desirability" ].toMap();
+  bData._d->desirability.base = (int)desMap[ "base" ];
+  bData._d->desirability.range = (int)desMap[ "range" ];
+  bData._d->desirability.step  = (int)desMap[ "step" ];
 
-  foreach( VariantMap::value_type& mapItem, constructions )
+  Variant prettyName = options[ "prettyName" ];
+  if( prettyName.isValid() )
   {
-    VariantMap options = mapItem.second.toMap();
-
-    const TileOverlay::Type btype = getType( mapItem.first );
-    if( btype == building::unknown )
-    {
-      Logger::warning( "!!!Warning: can't associate type with %s", mapItem.first.c_str() );
-      continue;
-    }
-
-    Impl::BuildingsMap::const_iterator bdataIt = _d->buildings.find( btype );
-    if( bdataIt != _d->buildings.end() )
-    {
-      Logger::warning( "!!!Warning: type %s also initialized", mapItem.first.c_str() );
-      continue;
-    }
-
-    MetaData bData( btype, mapItem.first );
-    const std::string pretty = options[ "pretty" ].toString();
-    if( !pretty.empty() )
-    {
-      bData._prettyName = pretty;
-    }
-
-    bData._d->options = options;
-    VariantMap desMap = options[ "desirability" ].toMap();
-    bData._d->desirability.base = (int)desMap[ "base" ];
-    bData._d->desirability.range = (int)desMap[ "range" ];
-    bData._d->desirability.step  = (int)desMap[ "step" ];
-
-    Variant prettyName = options[ "prettyName" ];
-    if( prettyName.isValid() )
-    {
-      bData._prettyName = prettyName.toString();
-    }
-
-    bData._group = getClass( options[ "class" ].toString() );
-
-    VariantList basePic = options[ "image" ].toList();
-    if( !basePic.empty() )
-    {
-      bData._basePicture = Picture::load( basePic.get( 0 ).toString(), basePic.get( 1 ).toInt() );
-    }
-
-    addData( bData );
+    bData._prettyName = prettyName.toString();
   }
+
+  bData._group = getClass( options[ "class" ].toString() );
+
+  VariantList basePic = options[ "image" ].toList();
+  if( !basePic.empty() )
+  {
+    bData._basePicture = Picture::load( basePic.get( 0 ).toString(), basePic.get( 1 ).toInt() );
+  }
+
+  addData( bData );
 }
 
 TileOverlay::Type MetaDataHolder::getType( const std::string& name )
@@ -88,6 +88,8 @@ public:
 private:
    MetaDataHolder();
 
+   void _initConstruction( const std::string& name, const Variant& options );
+
    class Impl;
    ScopedPtr< Impl > _d;
 };
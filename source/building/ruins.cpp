@@ -21,6 +21,7 @@
 #include "game/city.hpp"
 #include "events/event.hpp"
 #include "constants.hpp"
+#include "game/tickscheduler.hpp"
 
 using namespace constants;
 
@@ -34,37 +35,38 @@ BurningRuins::BurningRuins() : ServiceBuilding(Service::burningRuins, building::
   _fgPicturesRef().resize(1);
 }
 
-void BurningRuins::timeStep(const unsigned long time)
+void BurningRuins::scheduleJobs( TickScheduler& scheduler )
 {
-  ServiceBuilding::timeStep(time);
+  ServiceBuilding::scheduleJobs( scheduler );
+  scheduler.add( this, 16, makeDelegate( this, &BurningRuins::_burnDown ) );
+}
 
-  if (time % 16 == 0 )
+void BurningRuins::_burnDown( unsigned int time )
+{
+  if( getState( Construction::fire ) > 0 )
   {
-    if( getState( Construction::fire ) > 0 )
+    updateState( Construction::fire, -1 );
+    if( getState( Construction::fire ) == 50 )
     {
-      updateState( Construction::fire, -1 );
-      if( getState( Construction::fire ) == 50 )
-      {
-        setPicture( ResourceGroup::land2a, 214 );
-        _animationRef().clear();
-        _animationRef().load( ResourceGroup::land2a, 215, 8);
-        _animationRef().setOffset( Point( 14, 26 ) );
-      }
-      else if( getState( Construction::fire ) == 25 )
-      {
-        setPicture( ResourceGroup::land2a, 223 );
-        _animationRef().clear();
-        _animationRef().load(ResourceGroup::land2a, 224, 8);
-        _animationRef().setOffset( Point( 14, 18 ) );
-      }
+      setPicture( ResourceGroup::land2a, 214 );
+      _animationRef().clear();
+      _animationRef().load( ResourceGroup::land2a, 215, 8);
+      _animationRef().setOffset( Point( 14, 26 ) );
     }
-    else
+    else if( getState( Construction::fire ) == 25 )
     {
-      deleteLater();
+      setPicture( ResourceGroup::land2a, 223 );
       _animationRef().clear();
-      _fgPicturesRef().clear();
+      _animationRef().load(ResourceGroup::land2a, 224, 8);
+      _animationRef().setOffset( Point( 14, 18 ) );
     }
   }
+  else
+  {
+    deleteLater();
+    _animationRef().clear();
+    _fgPicturesRef().clear();
+  }
 }
 
 void BurningRuins::destroy()
@@ -136,6 +138,10 @@ void BurnedRuins::timeStep( const unsigned long time )
 
 }
 
+void BurnedRuins::scheduleJobs( TickScheduler& scheduler )
+{
+}
+
 BurnedRuins::BurnedRuins() : Building( building::B_BURNED_RUINS, Size(1) )
 {
   setPicture( ResourceGroup::land2a, 111 + rand() % 8 );
@@ -217,34 +223,40 @@ void PlagueRuins::timeStep(const unsigned long time)
 {
   _animationRef().update( time );
   _fgPicturesRef().at( 0 ) = _animationRef().getFrame();
+}
+
+void PlagueRuins::scheduleJobs( TickScheduler& scheduler )
+{
+  // ruins aren't damaged, so building jobs aren't added
+  scheduler.add( this, 16, makeDelegate( this, &PlagueRuins::_burnDown ) );
+}
 
-  if (time % 16 == 0 )
+void PlagueRuins::_burnDown( unsigned int time )
+{
+  if( getState( Construction::fire ) > 0 )
   {
-    if( getState( Construction::fire ) > 0 )
+    updateState( Construction::fire, -1 );
+    if( getState( Construction::fire ) == 50 )
     {
-      updateState( Construction::fire, -1 );
-      if( getState( Construction::fire ) == 50 )
-      {
-        setPicture( ResourceGroup::land2a, 214 );
-        _animationRef().clear();
-        _animationRef().load( ResourceGroup::land2a, 215, 8);
-        _animationRef().setOffset( Point( 14, 26 ) );
-      }
-      else if( getState( Construction::fire ) == 25 )
-      {
-        setPicture( ResourceGroup::land2a, 223 );
-        _animationRef().clear();
-        _animationRef().load(ResourceGroup::land2a, 224, 8);
-        _animationRef().setOffset( Point( 14, 18 ) );
-      }
+      setPicture( ResourceGroup::land2a, 214 );
+      _animationRef().clear();
+      _animationRef().load( ResourceGroup::land2a, 215, 8);
+      _animationRef().setOffset( Point( 14, 26 ) );
     }
-    else
+    else if( getState( Construction::fire ) == 25 )
     {
-      deleteLater();
+      setPicture( ResourceGroup::land2a, 223 );
       _animationRef().clear();
-      _fgPicturesRef().clear();
+      _animationRef().load(ResourceGroup::land2a, 224, 8);
+      _animationRef().setOffset( Point( 14, 18 ) );
     }
   }
+  else
+  {
+    deleteLater();
+    _animationRef().clear();
+    _fgPicturesRef().clear();
+  }
 }
 
 void PlagueRuins::destroy()
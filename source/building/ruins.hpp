@@ -24,7 +24,7 @@ public:
   BurningRuins();
 
   void deliverService();
-  void timeStep(const unsigned long time);
+  void scheduleJobs( TickScheduler& scheduler );
   void burn();
   void build(CityPtr city, const TilePos& pos );
   bool isWalkable() const;
@@ -33,6 +33,9 @@ public:
   float evaluateService( ServiceWalkerPtr walker);
   void applyService( ServiceWalkerPtr walker);
   bool isNeedRoadAccess() const;
+
+private:
+  void _burnDown( unsigned int time );
 };
 
 class BurnedRuins : public Building
@@ -41,6 +44,7 @@ public:
   BurnedRuins();
 
   void timeStep(const unsigned long time);
+  void scheduleJobs( TickScheduler& scheduler );
   bool isWalkable() const;
   void build(CityPtr city, const TilePos& pos );
   bool isNeedRoadAccess() const;
@@ -67,6 +71,7 @@ public:
   PlagueRuins();
 
   void timeStep(const unsigned long time);
+  void scheduleJobs( TickScheduler& scheduler );
   void burn();
   void build( CityPtr city, const TilePos& pos );
   bool isWalkable() const;
@@ -75,6 +80,9 @@ public:
   void applyService(ServiceWalkerPtr walker);
 
   bool isNeedRoadAccess() const;
+
+private:
+  void _burnDown( unsigned int time );
 };
 
 #endif
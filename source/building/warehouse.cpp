@@ -34,6 +34,7 @@
 #include "constants.hpp"
 
 #include <list>
+#include "game/tickscheduler.hpp"
 
 class WarehouseTile : public ReferenceCounted
 {
@@ -383,8 +384,17 @@ void Warehouse::timeStep(const unsigned long time)
    _fgPicturesRef().at(2) = _animationRef().getFrame();
    _fgPicturesRef().at(3) = _d->animFlag.getFrame();
   }
+}
 
-  if( _d->goodStore.isDevastation() && (time % 22 == 1 ) )
+void Warehouse::scheduleJobs( TickScheduler& scheduler )
+{
+  // warehouse isn't damaged, so building jobs aren't added
+  scheduler.add( this, 22, makeDelegate( this, &Warehouse::_checkDevastation ) );
+}
+
+void Warehouse::_checkDevastation( unsigned int time )
+{
+  if( _d->goodStore.isDevastation() )
   {
     _resolveDevastationMode();
   }
@@ -34,6 +34,7 @@ public:
   Warehouse();
 
   virtual void timeStep(const unsigned long time);
+  virtual void scheduleJobs( TickScheduler& scheduler );
   void computePictures();
   GoodStore& getGoodStore();
   
@@ -42,6 +43,7 @@ public:
 
 private:
   void _resolveDevastationMode();
+  void _checkDevastation( unsigned int time );
 
   class Impl;
   ScopedPtr< Impl > _d;
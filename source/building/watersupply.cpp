@@ -29,6 +29,7 @@
 #include "game/tilemap.hpp"
 #include "core/logger.hpp"
 #include "constants.hpp"
+#include "game/tickscheduler.hpp"
 
 using namespace constants;
 
@@ -431,28 +432,41 @@ void Reservoir::timeStep(const unsigned long time)
     return;
   }
 
+  _animationRef().update( time );
+  
+  // takes current animation frame and put it into foreground
+  _fgPicturesRef().at( 0 ) = _animationRef().getFrame();
+}
+
+void Reservoir::scheduleJobs( TickScheduler& scheduler )
+{
+  WaterSource::scheduleJobs( scheduler );
+  scheduler.add( this, 22, makeDelegate( this, &Reservoir::_fillArea ) );
+  scheduler.add( this, 11, makeDelegate( this, &Reservoir::_supplyConsumers ) );
+}
+
+void Reservoir::_fillArea( unsigned int time )
+{
+  if( !haveWater() )
+    return;
+
   //filled area, that reservoir present
-  if( time % 22 == 1 )
+  Tilemap& tmap = _getCity()->getTilemap();
+  TilemapArea reachedTiles = tmap.getArea( getTilePos() - TilePos( 10, 10 ), Size( 10 + 10 ) + getSize() );
+  foreach( Tile* tile, reachedTiles )
   {
-    Tilemap& tmap = _getCity()->getTilemap();
-    TilemapArea reachedTiles = tmap.getArea( getTilePos() - TilePos( 10, 10 ), Size( 10 + 10 ) + getSize() );
-    foreach( Tile* tile, reachedTiles )
-    {
-      tile->fillWaterService( WTR_RESERVOIR );
-    }   
+    tile->fillWaterService( WTR_RESERVOIR );
   }
+}
 
-  //add water to all consumer
-  if( time % 11 == 1 )
-  {
-    const TilePos offsets[4] = { TilePos( -1, 1), TilePos( 1, 3 ), TilePos( 3, 1), TilePos( 1, -1) };  
-    _produceWater(offsets, 4);
-  }
+void Reservoir::_supplyConsumers( unsigned int time )
+{
+  if( !haveWater() )
+    return;
 
-  _animationRef().update( time );
-  
-  // takes current animation frame and put it into foreground
-  _fgPicturesRef().at( 0 ) = _animationRef().getFrame();
+  //add water to all consumer
+  const TilePos offsets[4] = { TilePos( -1, 1), TilePos( 1, 3 ), TilePos( 3, 1), TilePos( 1, -1) };
+  _produceWater(offsets, 4);
 }
 
 bool Reservoir::canBuild( CityPtr city, const TilePos& pos ) const
@@ -494,22 +508,28 @@ bool WaterSource::haveWater() const
 
 void WaterSource::timeStep( const unsigned long time )
 {
-  if( time % 22 == 1)
-  {
-    _d->water = math::clamp( _d->water-1, 0, 16 );
-    if( _d->lastWaterState != (_d->water > 0) )
-    {
-      _d->lastWaterState = _d->water > 0;
-      _waterStateChanged();
-    }
+  Construction::timeStep( time );
+}
 
-    foreach( Impl::WaterSourceMap::value_type& item, _d->sourcesMap )
-    {
-      item.second = math::clamp( item.second-1, 0, 4 );
-    }
+void WaterSource::scheduleJobs( TickScheduler& scheduler )
+{
+  Construction::scheduleJobs( scheduler );
+  scheduler.add( this, 22, makeDelegate( this, &WaterSource::_decreaseWater ) );
+}
+
+void WaterSource::_decreaseWater( unsigned int time )
+{
+  _d->water = math::clamp( _d->water-1, 0, 16 );
+  if( _d->lastWaterState != (_d->water > 0) )
+  {
+    _d->lastWaterState = _d->water > 0;
+    _waterStateChanged();
   }
 
-  Construction::timeStep( time );
+  foreach( Impl::WaterSourceMap::value_type& item, _d->sourcesMap )
+  {
+    item.second = math::clamp( item.second-1, 0, 4 );
+  }
 }
 
 void WaterSource::_produceWater( const TilePos* points, const int size )
@@ -580,44 +600,45 @@ void Fountain::deliverService()
   } 
 }
 
-void Fountain::timeStep(const unsigned long time)
+void Fountain::scheduleJobs( TickScheduler& scheduler )
+{
+  ServiceBuilding::scheduleJobs( scheduler );
+  scheduler.add( this, 22, makeDelegate( this, &Fountain::_updateWater ) );
+}
+
+void Fountain::_updateWater( unsigned int time )
 {
   //filled area, that fontain present and work
-  if( time % 22 == 1 )
+  if( getTile().getWaterService( WTR_RESERVOIR ) > 0 /*&& getWorkersCount() > 0*/ )
   {
-    if( getTile().getWaterService( WTR_RESERVOIR ) > 0 /*&& getWorkersCount() > 0*/ )
-    {
-      _haveReservoirWater = true;
-      _animationRef().start();
-    }
-    else
-    {
-      //remove fontain service from tiles
-      Tilemap& tmap = _getCity()->getTilemap();
-      TilemapArea reachedTiles = tmap.getArea( getTilePos() - TilePos( 4, 4 ), Size( 4 + 4 ) + getSize() );
-      foreach( Tile* tile, reachedTiles )
-      {
-        tile->decreaseWaterService( WTR_FONTAIN );
-      }
-
-      _animationRef().stop();
-    }
-
-    if( !isActive() )
-    {
-      _fgPicturesRef().at( 0 ) = Picture::getInvalid();
-      return;
-    }
-
+    _haveReservoirWater = true;
+    _animationRef().start();
+  }
+  else
+  {
+    //remove fontain service from tiles
     Tilemap& tmap = _getCity()->getTilemap();
     TilemapArea reachedTiles = tmap.getArea( getTilePos() - TilePos( 4, 4 ), Size( 4 + 4 ) + getSize() );
     foreach( Tile* tile, reachedTiles )
     {
-      tile->fillWaterService( WTR_FONTAIN );
+      tile->decreaseWaterService( WTR_FONTAIN );
     }
+
+    _animationRef().stop();
   }
 
-  ServiceBuilding::timeStep( time );
+  if( !isActive() )
+  {
+    _fgPicturesRef().at( 0 ) = Picture::getInvalid();
+    return;
+  }
+
+  Tilemap& tmap = _getCity()->getTilemap();
+  TilemapArea reachedTiles = tmap.getArea( getTilePos() - TilePos( 4, 4 ), Size( 4 + 4 ) + getSize() );
+  foreach( Tile* tile, reachedTiles )
+  {
+    tile->fillWaterService( WTR_FONTAIN );
+  }
 }
 
 bool Fountain::canBuild( CityPtr city, const TilePos& pos ) const
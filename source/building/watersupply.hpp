@@ -31,6 +31,7 @@ public:
   virtual void addWater( const WaterSource& source );
   virtual bool haveWater() const;
   virtual void timeStep(const unsigned long time);
+  virtual void scheduleJobs( TickScheduler& scheduler );
   int getId() const;
 
   virtual std::string getError() const;
@@ -39,6 +40,7 @@ protected:
   void _setError( const std::string& error );
   virtual void _waterStateChanged() {}
   virtual void _produceWater( const TilePos* points, const int size );
+  void _decreaseWater( unsigned int time );
   
   class Impl;
   ScopedPtr< Impl > _d;
@@ -80,9 +82,13 @@ public:
   virtual bool isNeedRoadAccess() const;
   virtual void initTerrain(Tile& terrain);
   virtual void timeStep(const unsigned long time);
+  virtual void scheduleJobs( TickScheduler& scheduler );
   virtual void destroy();
 
 private:
+  void _fillArea( unsigned int time );
+  void _supplyConsumers( unsigned int time );
+
   bool _isWaterSource;
   bool _isNearWater( CityPtr city, const TilePos& pos ) const;
 };
@@ -95,7 +101,7 @@ public:
   virtual void build( CityPtr city, const TilePos& pos );
   virtual bool canBuild(CityPtr city, const TilePos& pos ) const;
   virtual void deliverService();
-  virtual void timeStep(const unsigned long time);
+  virtual void scheduleJobs( TickScheduler& scheduler );
   virtual bool isNeedRoadAccess() const;
 
   virtual bool isActive() const;
@@ -105,6 +111,7 @@ public:
 private:
   bool _haveReservoirWater;
   void _initAnimation();
+  void _updateWater( unsigned int time );
 };
 
 #endif // __OPENCAESAR3_WATER_BUILDGINDS_INCLUDED__
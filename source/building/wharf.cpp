@@ -23,6 +23,7 @@
 #include "core/foreach.hpp"
 #include "game/goodstore.hpp"
 #include "constants.hpp"
+#include "game/tickscheduler.hpp"
 
 using namespace constants;
 
@@ -120,19 +121,6 @@ void Wharf::timeStep(const unsigned long time)
 {
   WorkingBuilding::timeStep(time);
 
-  //try get good from storage building for us
-  if( time % 22 == 1 && getWorkersCount() > 0 && getWalkers().size() == 0 )
-  {
-    receiveGood();
-    deliverGood();
-
-    if( _d->boat.isNull() )
-    {
-      _d->boat = FishingBoat::create( _getCity() );
-      _d->boat->send2City( this, getLandingTile().getIJ() );
-    }
-  }
-
   //start/stop animation when workers found
   bool mayAnimate = mayWork();
 
@@ -171,6 +159,29 @@ void Wharf::timeStep(const unsigned long time)
   }
 }
 
+void Wharf::scheduleJobs( TickScheduler& scheduler )
+{
+  // wharf exchanges goods together with boat updating, so factory job isn't needed
+  WorkingBuilding::scheduleJobs( scheduler );
+  scheduler.add( this, 22, makeDelegate( this, &Wharf::_updateBoat ) );
+}
+
+void Wharf::_updateBoat( unsigned int time )
+{
+  //try get good from storage building for us
+  if( getWorkersCount() > 0 && getWalkers().size() == 0 )
+  {
+    receiveGood();
+    deliverGood();
+
+    if( _d->boat.isNull() )
+    {
+      _d->boat = FishingBoat::create( _getCity() );
+      _d->boat->send2City( this, getLandingTile().getIJ() );
+    }
+  }
+}
+
 void Wharf::save(VariantMap& stream) const
 {
   Factory::save( stream );
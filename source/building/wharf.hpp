@@ -27,6 +27,7 @@ public:
   virtual void build(CityPtr city, const TilePos &pos);
   virtual void destroy();
   virtual void timeStep(const unsigned long time);
+  virtual void scheduleJobs( TickScheduler& scheduler );
 
   virtual void save(VariantMap &stream) const;
   virtual void load(const VariantMap &stream);
@@ -38,6 +39,7 @@ public:
 
 private:
   void _setDirection( constants::Direction direction );
+  void _updateBoat( unsigned int time );
 
 private:
   class Impl;
@@ -0,0 +1,75 @@
+// This file is part of openCaesar3.
+//
+// openCaesar3 is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// openCaesar3 is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with openCaesar3.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "bytearray.hpp"
+
+static const char base64Chars[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+static int base64Value( char c )
+{
+  if( c >= 'A' && c <= 'Z' ) return c - 'A';
+  if( c >= 'a' && c <= 'z' ) return c - 'a' + 26;
+  if( c >= '0' && c <= '9' ) return c - '0' + 52;
+  if( c == '+' ) return 62;
+  if( c == '/' ) return 63;
+
+  return -1;
+}
+
+std::string ByteArray::toBase64() const
+{
+  std::string ret;
+  ret.reserve( ( size() + 2 ) / 3 * 4 );
+
+  for( unsigned int k=0; k < size(); k += 3 )
+  {
+    unsigned int rest = size() - k;
+    unsigned int value = (unsigned char)(*this)[ k ] << 16;
+    if( rest > 1 ) { value |= (unsigned char)(*this)[ k+1 ] << 8; }
+    if( rest > 2 ) { value |= (unsigned char)(*this)[ k+2 ]; }
+
+    ret += base64Chars[ (value >> 18) & 0x3f ];
+    ret += base64Chars[ (value >> 12) & 0x3f ];
+    ret += rest > 1 ? base64Chars[ (value >> 6) & 0x3f ] : '=';
+    ret += rest > 2 ? base64Chars[ value & 0x3f ] : '=';
+  }
+
+  return ret;
+}
+
+ByteArray ByteArray::fromBase64( const std::string& text )
+{
+  ByteArray ret;
+  ret.reserve( text.size() / 4 * 3 );
+
+  unsigned int value = 0;
+  int bits = 0;
+  for( std::string::const_iterator it=text.begin(); it != text.end(); it++ )
+  {
+    int digit = base64Value( *it );
+    if( digit < 0 )
+      continue;
+
+    value = (value << 6) | digit;
+    bits += 6;
+    if( bits >= 8 )
+    {
+      bits -= 8;
+      ret.push_back( (char)( (value >> bits) & 0xff ) );
+    }
+  }
+
+  return ret;
+}
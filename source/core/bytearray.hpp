@@ -44,6 +44,11 @@ public:
   {
     return &(*this)[0];
   }
+
+  // text form of bytes for json files
+  std::string toBase64() const;
+  // wrong characters are skipped
+  static ByteArray fromBase64( const std::string& text );
 };
 
 #endif //__OPENCAESAR3_BYTEARRAY_H_INCLUDED__
\ No newline at end of file
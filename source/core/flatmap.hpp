@@ -0,0 +1,141 @@
+// This file is part of openCaesar3.
+//
+// openCaesar3 is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// openCaesar3 is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with openCaesar3.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __OPENCAESAR3_FLATMAP_H_INCLUDED__
+#define __OPENCAESAR3_FLATMAP_H_INCLUDED__
+
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <stdexcept>
+
+// Map with items kept sorted by key in one vector. It repeats interface of
+// std::map used by game code, lookups are binary searches over continuous
+// memory and map doesn't allocate node per item. Insertion in the middle
+// moves following items, so it suits maps which are built once and read often.
+// Any insertion invalidates references and iterators to items.
+template< class Key, class T >
+class FlatMap
+{
+public:
+  typedef Key key_type;
+  typedef T mapped_type;
+  typedef std::pair< Key, T > value_type;
+  typedef std::vector< value_type > Items;
+  typedef typename Items::iterator iterator;
+  typedef typename Items::const_iterator const_iterator;
+  typedef typename Items::size_type size_type;
+
+  iterator begin() { return _items.begin(); }
+  iterator end() { return _items.end(); }
+  const_iterator begin() const { return _items.begin(); }
+  const_iterator end() const { return _items.end(); }
+
+  size_type size() const { return _items.size(); }
+  bool empty() const { return _items.empty(); }
+  void clear() { _items.clear(); }
+
+  iterator lower_bound( const Key& key )
+  {
+    return std::lower_bound( _items.begin(), _items.end(), key, KeyLess() );
+  }
+
+  const_iterator lower_bound( const Key& key ) const
+  {
+    return std::lower_bound( _items.begin(), _items.end(), key, KeyLess() );
+  }
+
+  iterator find( const Key& key )
+  {
+    iterator it = lower_bound( key );
+    return ( it != _items.end() && !( key < it->first ) ) ? it : _items.end();
+  }
+
+  const_iterator find( const Key& key ) const
+  {
+    const_iterator it = lower_bound( key );
+    return ( it != _items.end() && !( key < it->first ) ) ? it : _items.end();
+  }
+
+  size_type count( const Key& key ) const { return find( key ) != end() ? 1 : 0; }
+
+  std::pair< iterator, bool > insert( const value_type& item )
+  {
+    iterator it = lower_bound( item.first );
+    if( it != _items.end() && !( item.first < it->first ) )
+    {
+      return std::make_pair( it, false );
+    }
+
+    // appending in key order is the common case and doesn't move items
+    return std::make_pair( _items.insert( it, item ), true );
+  }
+
+  // unlike std::map, inserting new key moves items and invalidates references
+  // and iterators, so map[a] = map[b] is wrong when one of keys is absent
+  T& operator[]( const Key& key )
+  {
+    iterator it = lower_bound( key );
+    if( it == _items.end() || key < it->first )
+    {
+      it = _items.insert( it, value_type( key, T() ) );
+    }
+
+    return it->second;
+  }
+
+  T& at( const Key& key )
+  {
+    iterator it = find( key );
+    if( it == _items.end() )
+      throw std::out_of_range( "FlatMap::at" );
+
+    return it->second;
+  }
+
+  const T& at( const Key& key ) const
+  {
+    const_iterator it = find( key );
+    if( it == _items.end() )
+      throw std::out_of_range( "FlatMap::at" );
+
+    return it->second;
+  }
+
+  void erase( iterator it ) { _items.erase( it ); }
+
+  size_type erase( const Key& key )
+  {
+    iterator it = find( key );
+    if( it == _items.end() )
+      return 0;
+
+    _items.erase( it );
+    return 1;
+  }
+
+  void reserve( size_type count ) { _items.reserve( count ); }
+  void swap( FlatMap& other ) { _items.swap( other._items ); }
+
+private:
+  struct KeyLess
+  {
+    bool operator()( const value_type& item, const Key& key ) const { return item.first < key; }
+  };
+
+  Items _items;
+};
+
+#endif //__OPENCAESAR3_FLATMAP_H_INCLUDED__
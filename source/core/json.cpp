@@ -16,6 +16,8 @@
 #include "json.hpp"
 #include "stringhelper.hpp"
 #include <iostream>
+#include <list>
+#include <cstring>
 
 static std::string sanitizeString(std::string str)
 {
@@ -59,25 +61,18 @@ Variant Json::parse(const std::string &json)
  */
 Variant Json::parse(const std::string& json, bool &success )
 {
-  success = true;
-  int index = 0;
   //Return an empty Variant if the JSON data is either null or empty
-  if( !json.empty() )
-  {
-    std::string data = json;
-    //We'll start from index 0
-
-    //Parse the first value
-    Variant value = Json::parseValue(data, index, success);
-
-    //Return the parsed value
-    return value;
-  }
-  else
+  if( json.empty() )
   {
-    //Return the empty Variant
+    success = true;
     return Variant();
   }
+
+  JsonVariantBuilder builder;
+  std::string error;
+  success = Json::parse( json.data(), json.size(), builder, error );
+
+  return success ? builder.getResult() : Variant( error );
 }
 
 std::string Json::serialize(const Variant &data, const std::string& tab)
@@ -99,7 +94,12 @@ std::string Json::serialize(const Variant &data, bool &success, const std::strin
   else if( (data.type() == Variant::List) || (data.type() == Variant::NStringArray) ) // variant is a list?
   {
     StringArray values;
-    const VariantList rlist = data.toList();
+    // string array is converted, list is read in place
+    VariantList converted;
+    if( data.type() == Variant::NStringArray ) { converted = data.toList(); }
+    const VariantList& rlist = data.type() == Variant::List
+                                 ? *static_cast< const VariantList* >( data.data() )
+                                 : converted;
     for( VariantList::const_iterator it = rlist.begin(); it != rlist.end(); it++)
     {
       std::string serializedValue = serialize( *it, "" );
@@ -140,8 +140,8 @@ std::string Json::serialize(const Variant &data, bool &success, const std::strin
 // 	}
     else if(data.type() == Variant::Map) // variant is a map?
     {
-      VariantMap vmap = data.toMap();
-      
+      const VariantMap& vmap = *static_cast< const VariantMap* >( data.data() );
+
       if( vmap.empty() )
       {
         str = "{}";
@@ -150,7 +150,7 @@ std::string Json::serialize(const Variant &data, bool &success, const std::strin
       {
         str = "{ \n";
         StringArray pairs;
-        for( VariantMap::iterator it = vmap.begin(); it != vmap.end(); it++ )
+        for( VariantMap::const_iterator it = vmap.begin(); it != vmap.end(); it++ )
         {        
           std::string serializedValue = serialize( it->second, tab + "  ");
           if( serializedValue.empty())
@@ -167,9 +167,13 @@ std::string Json::serialize(const Variant &data, bool &success, const std::strin
         str += std::string( "\n" ) + rtab + "}";
       }
     }
-    else if((data.type() == Variant::String) || (data.type() == Variant::NByteArray)) // a string or a byte array?
+    else if( data.type() == Variant::String ) // a string?
+    {
+      str = sanitizeString( data.toString() );
+    }
+    else if( data.type() == Variant::NByteArray ) // a byte array? it may hold any bytes, so it is written in base64
     {
-            str = sanitizeString( data.toString() );
+      str = sanitizeString( static_cast< const ByteArray* >( data.data() )->toBase64() );
     }
     else if(data.type() == Variant::Double || data.type() == Variant::Float) // double?
     {
@@ -240,538 +244,507 @@ std::string Json::serialize(const Variant &data, bool &success, const std::strin
     }
 }
 
-/**
- * parseValue
- */
-Variant Json::parseValue(const std::string &json, int &index, bool &success)
+
+namespace {
+
+// single pass tokenizer of JSON dialect used by models and saves: besides
+// standard syntax it accepts c-style comments and object names without quotes
+class JsonReader
 {
-  //Determine what kind of data we should parse by
-  //checking out the upcoming token
-  bool done = false;
-  while(!done)
+public:
+  JsonReader( const char* data, unsigned int size, JsonHandler& handler )
+    : _data( data ), _end( data + size ), _pos( data ), _handler( handler ) {}
+
+  bool read()
   {
-    int token = Json::lookAhead(json, index);
-    switch( token )
-    {
-      case JsonTokenString:      return Json::parseString(json, index, success);
-      case JsonTokenNumber:      return Json::parseNumber(json, index);
-      
-      case JsonTokenCommentOpen:
-        Json::parseComment(json, index, success); 
-      break;
-      
-      case JsonTokenCurlyOpen: 
-      case JsonTokenObjectName: 
-          return Json::parseObject(json, index, success);
-      
-      case JsonTokenSquaredOpen: return Json::parseArray(json, index, success);
-      case JsonTokenTrue:  Json::nextToken(json, index); return Variant(true);
-      case JsonTokenFalse: Json::nextToken(json, index); return Variant(false);
-      case JsonTokenNull:  Json::nextToken(json, index); return Variant();
-      case JsonTokenNone:
-        done = true;
-      break;
+    if( !_value() )
+      return false;
+
+    _skipSpaces();
+    return true;
+  }
+
+  std::string getError() const
+  {
+    int line = 1;
+    for( const char* p=_data; p < _pos && p < _end; p++ )
+    {
+      if( *p == '\n' ) { line++; }
     }
+
+    std::string near( _pos, std::min<const char*>( _pos + 20, _end ) );
+    return StringHelper::format( 0xff, "%s at line %d near \"%s\"", _error.c_str(), line, near.c_str() );
   }
 
-  //If there were no tokens, flag the failure and return an empty Variant
-  success = false;
-  return Variant( std::string( json.c_str() + index ));
-}
+private:
+  const char* _data;
+  const char* _end;
+  const char* _pos;
+  JsonHandler& _handler;
+  std::string _buffer;
+  std::string _error;
 
-/**
- * parseObject
- */
-Variant Json::parseObject(const std::string &json, int &index, bool &success)
-{
-  VariantMap rmap;
-  int token;
-  //Get rid of the whitespace and increment index
-  Json::nextToken(json, index);
-
-  //Loop through all of the key/value pairs of the object
-  bool done = false;
-  while(!done)
+  bool _fail( const char* text )
   {
-    //Get the upcoming token
-    token = Json::lookAhead(json, index);
+    if( _error.empty() ) { _error = text; }
+    return false;
+  }
 
-    switch( token )
+  // skips whitespaces and comments
+  bool _skipSpaces()
+  {
+    while( _pos < _end )
     {
-    case JsonTokenNone:
+      char c = *_pos;
+      if( c == ' ' || c == '\t' || c == '\n' || c == '\r' )
       {
-        success = false;
-        bool sc;
-        std::string errText = Json::parseObjectName( json, index, sc ).toString();
-        return Variant( errText );
+        _pos++;
       }
-    break;
-
-    case JsonTokenComma:
+      else if( c == '/' && _pos + 1 < _end && _pos[1] == '*' )
       {
-        Json::nextToken(json, index);
-      }
-    break;
+        const char* p = _pos + 2;
+        while( p + 1 < _end && !( p[0] == '*' && p[1] == '/' ) ) { p++; }
+        if( p + 1 >= _end )
+          return _fail( "Unclosed comment" );
 
-    case JsonTokenCurlyClose:
-      {
-        Json::nextToken(json, index);
-        return Variant( rmap );
+        _pos = p + 2;
       }
-    break;
-
-    case JsonTokenCommentOpen:
+      else
       {
-        Json::parseComment(json, index, success);
+        break;
       }
-    break;
+    }
 
-    case JsonTokenObjectName:
-      {
-        std::string name = Json::parseObjectName( json, index, success ).toString();        
+    return true;
+  }
 
-        if(!success)
-        {
-          return Variant(name);
-        }
+  bool _isWord( const char* word, unsigned int length )
+  {
+    return (unsigned int)(_end - _pos) >= length && memcmp( _pos, word, length ) == 0;
+  }
 
-        name = StringHelper::replace( name, " ", "" );
+  // looks for ':' in next 64 symbols, returns its position or 0
+  const char* _findNameEnd()
+  {
+    const char* last = std::min<const char*>( _pos + 64, _end );
+    for( const char* p=_pos+1; p < last; p++ )
+    {
+      if( *p == ':' )
+        return p;
+    }
 
-        index++;
-        Variant value = Json::parseValue(json, index, success);
+    return 0;
+  }
 
-        if(!success)
-        {
-          return Variant( value.toString() );
-        }
+  bool _value()
+  {
+    if( !_skipSpaces() )
+      return false;
+
+    if( _pos >= _end )
+      return _fail( "Unexpected end of data" );
+
+    switch( *_pos )
+    {
+    case '{': _pos++; return _object();
+    case '[': _pos++; return _array();
+    case '"': return _string( false );
+    case '0': case '1': case '2': case '3': case '4':
+    case '5': case '6': case '7': case '8': case '9':
+    case '-': return _number();
+    }
+
+    if( _isWord( "true", 4 ) ) { _pos += 4; return _handler.onBool( true ); }
+    if( _isWord( "false", 5 ) ) { _pos += 5; return _handler.onBool( false ); }
+    if( _isWord( "null", 4 ) ) { _pos += 4; return _handler.onNull(); }
+
+    // object without opening brace starts with its first name
+    if( _findNameEnd() != 0 )
+      return _object();
+
+    return _fail( "Unexpected symbol" );
+  }
+
+  bool _object()
+  {
+    if( !_handler.onObjectBegin() )
+      return false;
+
+    while( true )
+    {
+      if( !_skipSpaces() )
+        return false;
+
+      if( _pos >= _end )
+        return _fail( "Unclosed object" );
 
-        //Assign the value to the key in the map
-        rmap[name] = value;
+      char c = *_pos;
+      if( c == '}' )
+      {
+        _pos++;
+        return _handler.onObjectEnd();
       }
-    break;
 
-    default:
+      if( c == ',' )
       {
-        //Parse the key/value pair's name
-        std::string name = Json::parseString(json, index, success).toString();
+        _pos++;
+        continue;
+      }
 
-        if(!success)
-        {
-          return Variant();
-        }
+      if( c == '"' )
+      {
+        if( !_string( true ) || !_skipSpaces() )
+          return false;
 
-        //Get the next token
-        token = Json::nextToken(json, index);
+        if( _pos >= _end || *_pos != ':' )
+          return _fail( "Expected colon after object name" );
+      }
+      else if( !_name() )
+      {
+        return false;
+      }
 
-        //If the next token is not a colon, flag the failure
-        //return an empty Variant
-        if(token != JsonTokenColon)
-        {
-          success = false;
-          return Variant();
-        }
+      _pos++; // colon
+      if( !_value() )
+        return false;
+    }
+  }
 
-        //Parse the key/value pair's value
-        Variant value = Json::parseValue(json, index, success);
+  // object name without quotes, spaces are removed from it
+  bool _name()
+  {
+    const char* colon = _findNameEnd();
+    if( colon == 0 )
+      return _fail( "Wrong symbol in object name" );
 
-        if(!success)
-        {
-          return Variant();
-        }
+    _buffer.clear();
+    for( const char* p=_pos; p < colon; p++ )
+    {
+      char c = *p;
+      if( c == '{' || c == '}' || c == '[' || c == ']' || c == ',' )
+        return _fail( "Wrong symbol in object name" );
 
-        //Assign the value to the key in the map
-        rmap[name] = value;
-      }
-    break;
+      if( c != ' ' && c != '\t' && c != '\n' && c != '\r' )
+        _buffer += c;
     }
-  } //end while(!done)
 
-  //Return the map successfully
-  return Variant(rmap);
-}
+    _pos = colon;
+    return _handler.onObjectName( _buffer.data(), _buffer.size() );
+  }
 
-/**
- * parseArray
- */
-Variant Json::parseArray(const std::string &json, int &index, bool &success)
-{
-        VariantList list;
+  bool _array()
+  {
+    if( !_handler.onArrayBegin() )
+      return false;
 
-        Json::nextToken(json, index);
+    while( true )
+    {
+      if( !_skipSpaces() )
+        return false;
 
-        bool done = false;
-        while(!done)
-        {
-                int token = Json::lookAhead(json, index);
-
-                if(token == JsonTokenNone)
-                {
-                        success = false;
-                        return VariantList();
-                }
-                else if(token == JsonTokenComma)
-                {
-                        Json::nextToken(json, index);
-                }
-                else if(token == JsonTokenSquaredClose)
-                {
-                        Json::nextToken(json, index);
-                        break;
-                }
-                else
-                {
-                        Variant value = Json::parseValue(json, index, success);
-
-                        if(!success)
-                        {
-                                return VariantList();
-                        }
-
-                        list.push_back(value);
-                }
-        }
+      if( _pos >= _end )
+        return _fail( "Unclosed array" );
 
-        return Variant(list);
-}
+      if( *_pos == ']' )
+      {
+        _pos++;
+        return _handler.onArrayEnd();
+      }
 
-/**
- * parse comment
- */
-void Json::parseComment(const std::string &json, int &index, bool &success)
-{
-  char c;
-  success = false;
-  index+=2;
+      if( *_pos == ',' )
+      {
+        _pos++;
+        continue;
+      }
+
+      if( !_value() )
+        return false;
+    }
+  }
 
-  bool complete = false;
-  while(!complete)
+  static void _appendUtf8( std::string& str, unsigned int code )
   {
-    if(index == (int)json.size())
+    if( code < 0x80 )
     {
-      break;
+      str += (char)code;
     }
-
-    c = json[index++];
-
-    if(c == '/' && json[ index - 2 ] == '*' )
+    else if( code < 0x800 )
     {
-      complete = true;
-      success = true;;
-      break;
+      str += (char)( 0xc0 | (code >> 6) );
+      str += (char)( 0x80 | (code & 0x3f) );
+    }
+    else
+    {
+      str += (char)( 0xe0 | (code >> 12) );
+      str += (char)( 0x80 | ((code >> 6) & 0x3f) );
+      str += (char)( 0x80 | (code & 0x3f) );
     }
   }
-}
 
-/**
-* parse object name without colons
-*/
-Variant Json::parseObjectName(const std::string &json, int &index, bool &success, char limiter )
-{
-  std::string s;
-
-  eatWhitespace(json, index);
+  // string without escapes is passed as view into data
+  bool _string( bool isName )
+  {
+    const char* start = ++_pos;
+    const char* p = start;
+    while( p < _end && *p != '"' && *p != '\\' ) { p++; }
 
-  bool complete = false;
+    if( p >= _end )
+      return _fail( "Unclosed string" );
 
-  int lastIndex = math::clamp<int>( index + 64, 0, json.size() );
-  for( int i=index; i < lastIndex; i++ )
-  {    
-    if( json[i+1] != limiter )
+    if( *p == '"' )
     {
-      s += json[ i ];
+      _pos = p + 1;
+      return isName
+               ? _handler.onObjectName( start, p - start )
+               : _handler.onString( start, p - start );
     }
-    else
+
+    _buffer.assign( start, p );
+    while( p < _end && *p != '"' )
     {
-      s += json[ i ];
-      index = (i + 1);
-      complete = true;
+      if( *p != '\\' )
+      {
+        _buffer += *p++;
+        continue;
+      }
+
+      if( ++p >= _end )
+        break;
+
+      switch( *p++ )
+      {
+      case '"': _buffer += '"'; break;
+      case '\\': _buffer += '\\'; break;
+      case '/': _buffer += '/'; break;
+      case 'b': _buffer += '\b'; break;
+      case 'f': _buffer += '\f'; break;
+      case 'n': _buffer += '\n'; break;
+      case 'r': _buffer += '\r'; break;
+      case 't': _buffer += '\t'; break;
+      case 'u':
+        if( _end - p < 4 )
+          return _fail( "Wrong unicode symbol" );
+
+      {
+        unsigned int code = 0;
+        for( int k=0; k < 4; k++, p++ )
+        {
+          char h = *p;
+          int digit = ( h >= '0' && h <= '9' ) ? h - '0'
+                        : ( h >= 'a' && h <= 'f' ) ? h - 'a' + 10
+                        : ( h >= 'A' && h <= 'F' ) ? h - 'A' + 10 : -1;
+          if( digit < 0 )
+            return _fail( "Wrong unicode symbol" );
+
+          code = (code << 4) | digit;
+        }
+        _appendUtf8( _buffer, code );
+      }
       break;
+      default: return _fail( "Wrong escape sequence" );
+      }
     }
+
+    if( p >= _end )
+      return _fail( "Unclosed string" );
+
+    _pos = p + 1;
+    return isName
+             ? _handler.onObjectName( _buffer.data(), _buffer.size() )
+             : _handler.onString( _buffer.data(), _buffer.size() );
   }
 
-  for( unsigned int i=0; i < s.size(); i++ )
+  bool _number()
   {
-    if( std::string("{}[],").find( s[i] ) != std::string::npos )
+    const char* start = _pos;
+    bool isFloat = false;
+    while( _pos < _end )
     {
-      s = json.substr( std::max( 0, index-20 ), lastIndex );
-      complete = false;
-      break;
+      char c = *_pos;
+      if( c == '.' ) { isFloat = true; }
+      else if( !( (c >= '0' && c <= '9') || c == '+' || c == '-' || c == 'e' || c == 'E' ) ) { break; }
+      _pos++;
     }
+
+    // number at the end of data can't be converted in place
+    std::string tail;
+    const char* number = start;
+    if( _pos == _end )
+    {
+      tail.assign( start, _end );
+      number = tail.c_str();
+    }
+
+    if( isFloat )
+      return _handler.onFloat( StringHelper::toFloat( number ) );
+
+    if( *start == '-' )
+      return _handler.onInt( StringHelper::toInt( number ) );
+
+    return _handler.onUInt( StringHelper::toUint( number ) );
   }
+};
+
+}//end namespace
 
-  if( !complete )
+bool Json::parse( const char* data, unsigned int size, JsonHandler& handler, std::string& error )
+{
+  JsonReader reader( data, size, handler );
+  bool ok = reader.read();
+  if( !ok )
   {
-    success = false;
-    std::string errText = StringHelper::format( 0xff, "Wrong symbol in object name \"%s\"", s.c_str() );
-    return Variant( errText );
+    error = reader.getError();
   }
 
-  return Variant(s);
+  return ok;
 }
 
-/**
- * parse string with colons
- */
-Variant Json::parseString(const std::string &json, int &index, bool &success)
+class JsonVariantBuilder::Impl
 {
-        std::string s;
-        char c;
-
-        Json::eatWhitespace(json, index);
-
-        c = json[index++];
-
-        bool complete = false;
-        while(!complete)
-        {
-          if(index == (int)json.size())
-          {
-            break;
-          }
-
-          c = json[index++];
+public:
+  // open object or array
+  struct Container
+  {
+    bool isObject;
+    VariantMap items;
+    VariantList list;
+    std::string name;
+  };
 
-          if(c == '\"')
-          {
-            complete = true;
-            break;
-          }
-          else if(c == '\\')
-          {
-            if(index == (int)json.size())
-            {
-              break;
-            }
-
-            c = json[index++];
-
-            if( c == '\"' || c == '\\' )
-            {
-              s += c;
-            }
-            else if(c == '/')
-            {
-              s.append("/");
-            }
-            else if(c == 'b')
-            {
-              s.append("\b");
-            }
-            else if(c == 'f')
-            {
-              s.append("\f");
-            }
-            else if(c == 'n')
-            {
-              s.append("\n");
-            }
-            else if(c == 'r')
-            {
-              s.append("\r");
-            }
-            else if(c == 't')
-            {
-              s.append("\t");
-            }
-            else if(c == 'u')
-            {
-//                                 int remainingLength = json.size() - index;
-// 
-//                                 if(remainingLength >= 4)
-//                                 {
-//                                         std::string unicodeStr = json.substr(index, 4);
-// 
-//                                         int symbol = StringHelper::fromHex( unicodeStr.c_str() );
-// 
-//                                         s.append( symbol );
-// 
-//                                         index += 4;
-//                                 }
-//                                 else
-//                                 {
-//                                         break;
-//                                 }
-              _OC3_DEBUG_BREAK_IF( true && "yet not work")
-            }
-          }
-          else
-          {
-            s += c;
-          }
-        }
+  typedef std::list< Container > Containers;
+  Containers containers;
+  Variant result;
 
-        if(!complete)
-        {
-                success = false;
-                return Variant();
-        }
+  void open( bool isObject )
+  {
+    containers.push_back( Container() );
+    containers.back().isObject = isObject;
+  }
+};
 
-        return Variant(s);
+JsonVariantBuilder::JsonVariantBuilder() : _d( new Impl )
+{
 }
 
-/**
- * parseNumber
- */
-Variant Json::parseNumber(const std::string &json, int &index)
+JsonVariantBuilder::~JsonVariantBuilder()
 {
-        Json::eatWhitespace(json, index);
+}
 
-        int lastIndex = Json::lastIndexOfNumber(json, index);
-        int charLength = (lastIndex - index) + 1;
-        std::string numberStr;
+const Variant& JsonVariantBuilder::getResult() const
+{
+  return _d->result;
+}
 
-        numberStr = json.substr( index, charLength );
+void JsonVariantBuilder::_store( Variant& value, int depth, const std::string& name )
+{
+  if( depth == 0 )
+  {
+    _d->result.swap( value );
+    return;
+  }
 
-        index = lastIndex + 1;
+  Impl::Container& parent = _d->containers.back();
+  if( parent.isObject )
+  {
+    parent.items[ name ].swap( value );
+  }
+  else
+  {
+    parent.list.push_back( Variant() );
+    parent.list.back().swap( value );
+  }
+}
 
-        if( numberStr.find('.') != std::string::npos )
-        {
-          return Variant( StringHelper::toFloat( numberStr.c_str() ) );
-        }
-        else if( numberStr[0] == '-' ) 
-        {
-          return Variant( StringHelper::toInt( numberStr.c_str() ) );
-        } 
-        else 
-        {
-          return Variant( StringHelper::toUint( numberStr.c_str() ) );
-        }
+void JsonVariantBuilder::_add( Variant& value )
+{
+  static const std::string noName;
+  const std::string& name = _d->containers.empty() ? noName : _d->containers.back().name;
+  _store( value, _d->containers.size(), name );
 }
 
-/**
- * lastIndexOfNumber
- */
-int Json::lastIndexOfNumber(const std::string &json, int index)
+void JsonVariantBuilder::_addValue( const Variant& value )
 {
-   int lastIndex;
+  Variant tmp( value );
+  _add( tmp );
+}
 
-   for(lastIndex = index; lastIndex < (int)json.size(); lastIndex++)
-   {
-     if( std::string("0123456789+-.eE").find( json[lastIndex] ) == std::string::npos )
-      {
-              break;
-      }
-   }
+bool JsonVariantBuilder::onNull() { _addValue( Variant() ); return true; }
+bool JsonVariantBuilder::onBool( bool value ) { _addValue( Variant( value ) ); return true; }
+bool JsonVariantBuilder::onInt( int value ) { _addValue( Variant( value ) ); return true; }
+bool JsonVariantBuilder::onUInt( unsigned int value ) { _addValue( Variant( value ) ); return true; }
+bool JsonVariantBuilder::onFloat( float value ) { _addValue( Variant( value ) ); return true; }
 
-   return lastIndex -1;
+bool JsonVariantBuilder::onString( const char* str, unsigned int length )
+{
+  _addValue( Variant( std::string( str, length ) ) );
+  return true;
 }
 
-/**
- * eatWhitespace
- */
-void Json::eatWhitespace(const std::string &json, int &index)
+bool JsonVariantBuilder::onObjectBegin()
 {
-        for(; index < (int)json.size(); index++)
-        {
-          if(std::string(" \t\n\r").find(json[index]) == std::string::npos)
-                {
-                        break;
-                }
-        }
+  _d->open( true );
+  return true;
 }
 
-/**
- * lookAhead
- */
-int Json::lookAhead(const std::string &json, int index)
+bool JsonVariantBuilder::onObjectName( const char* name, unsigned int length )
 {
-  int saveIndex = index;
-  return Json::nextToken(json, saveIndex);
+  _d->containers.back().name.assign( name, length );
+  return true;
 }
 
-/**
- * nextToken
- */
-int Json::nextToken(const std::string &json, int &index)
+bool JsonVariantBuilder::onObjectEnd()
 {
-  //int saveIndex = index;
-  Json::eatWhitespace(json, index);
-
-  if(index == (int)json.size())
-  {
-     return JsonTokenNone;
-  }
-
-  char c = json[index];
-  index++;
-  switch( c )
-  {
-          case '{': return JsonTokenCurlyOpen;
-          case '}': return JsonTokenCurlyClose;
-          case '[': return JsonTokenSquaredOpen;
-          case ']': return JsonTokenSquaredClose;
-          case ',': return JsonTokenComma;
-          case '"': return JsonTokenString;
-          case '0': case '1': case '2': case '3': case '4':
-          case '5': case '6': case '7': case '8': case '9':
-          case '-': return JsonTokenNumber;
-          case ':': return JsonTokenColon;
-  }
+  static const VariantMap emptyMap;
+  Variant value( emptyMap );
+  static_cast< VariantMap* >( value.data() )->swap( _d->containers.back().items );
+  _d->containers.pop_back();
+  _add( value );
+  return true;
+}
 
-  index--;
+bool JsonVariantBuilder::onArrayBegin()
+{
+  _d->open( false );
+  return true;
+}
 
-  int remainingLength = json.size() - index;
+bool JsonVariantBuilder::onArrayEnd()
+{
+  static const VariantList emptyList;
+  Variant value( emptyList );
+  static_cast< VariantList* >( value.data() )->swap( _d->containers.back().list );
+  _d->containers.pop_back();
+  _add( value );
+  return true;
+}
 
-  if( remainingLength > 2 )
-  {
-     if( json[index] == '/' && json[index + 1] == '*' )
-     {
-       index += 2;
-       return JsonTokenCommentOpen;
-     }
-
-     if(  json[index] == '*' && json[index + 1] == '/' )
-     {
-       index += 2;
-       return JsonTokenCommentClose;
-     }
-  }
+class JsonObjectReader::Impl
+{
+public:
+  Signal2< const std::string&, const Variant& > onMemberSignal;
+};
 
-  //True
-  if(remainingLength >= 4)
-  {
-     if( json[index] == 't' && json[index + 1] == 'r' &&
-         json[index + 2] == 'u' && json[index + 3] == 'e')
-     {
-             index += 4;
-             return JsonTokenTrue;
-     }
-  }
+JsonObjectReader::JsonObjectReader() : _d( new Impl )
+{
+}
 
-  //False
-  if (remainingLength >= 5)
-  {
-     if( json[index] == 'f' && json[index + 1] == 'a' &&
-         json[index + 2] == 'l' && json[index + 3] == 's' &&
-         json[index + 4] == 'e')
-     {
-         index += 5;
-         return JsonTokenFalse;
-     }
-  }
+JsonObjectReader::~JsonObjectReader()
+{
+}
 
-  //Null
-  if (remainingLength >= 4)
+void JsonObjectReader::_store( Variant& value, int depth, const std::string& name )
+{
+  if( depth == 1 )
   {
-     if (json[index] == 'n' && json[index + 1] == 'u' &&
-             json[index + 2] == 'l' && json[index + 3] == 'l')
-     {
-             index += 4;
-             return JsonTokenNull;
-     }
+    _d->onMemberSignal.emit( name, value );
   }
-
-  if( remainingLength > 1 )
+  else
   {
-    int lastIndex = math::clamp<int>( index + 64, 0, json.size() );
-    for( int i=index+1; i < lastIndex ; i++ )
-    {
-      if( json[i] == ':' )
-      {
-        return JsonTokenObjectName;
-      }
-    }
+    JsonVariantBuilder::_store( value, depth, name );
   }
+}
 
-  return JsonTokenNone;
+Signal2< const std::string&, const Variant& >& JsonObjectReader::onMember()
+{
+  return _d->onMemberSignal;
 }
@@ -17,6 +17,8 @@
 #define __OPENCAESAR3_JSON_PARSER_H_INCLUDE__
 
 #include "variant.hpp"
+#include "scopedptr.hpp"
+#include "signals.hpp"
 #include <string>
 
 /**
@@ -41,6 +43,101 @@ enum JsonToken
         JsonTokenObjectName = 14
 };
 
+/**
+ * \class JsonHandler
+ * \brief Receiver of events of streaming JSON parser
+ *
+ * Events come in document order. String arguments point into parsed data,
+ * or into parser's buffer when string had escapes, and are valid only
+ * during call. Handler returns false to stop parsing.
+ */
+class JsonHandler
+{
+public:
+  virtual ~JsonHandler() {}
+
+  virtual bool onNull() = 0;
+  virtual bool onBool( bool value ) = 0;
+  virtual bool onInt( int value ) = 0;
+  virtual bool onUInt( unsigned int value ) = 0;
+  virtual bool onFloat( float value ) = 0;
+  virtual bool onString( const char* str, unsigned int length ) = 0;
+
+  virtual bool onObjectBegin() = 0;
+  virtual bool onObjectName( const char* name, unsigned int length ) = 0;
+  virtual bool onObjectEnd() = 0;
+
+  virtual bool onArrayBegin() = 0;
+  virtual bool onArrayEnd() = 0;
+};
+
+/**
+ * \class JsonVariantBuilder
+ * \brief Builds Variant hierarchy from parse events
+ *
+ * Containers are filled in place while parsing, finished container is
+ * swapped into its parent, so items are never copied.
+ */
+class JsonVariantBuilder : public JsonHandler
+{
+public:
+  JsonVariantBuilder();
+  virtual ~JsonVariantBuilder();
+
+  const Variant& getResult() const;
+
+  virtual bool onNull();
+  virtual bool onBool( bool value );
+  virtual bool onInt( int value );
+  virtual bool onUInt( unsigned int value );
+  virtual bool onFloat( float value );
+  virtual bool onString( const char* str, unsigned int length );
+
+  virtual bool onObjectBegin();
+  virtual bool onObjectName( const char* name, unsigned int length );
+  virtual bool onObjectEnd();
+
+  virtual bool onArrayBegin();
+  virtual bool onArrayEnd();
+
+protected:
+  // stores finished value into its container, depth is count of open containers,
+  // name is member name when container is object. Value is swapped into its place,
+  // so it may be left with old content of that place
+  virtual void _store( Variant& value, int depth, const std::string& name );
+
+private:
+  void _add( Variant& value );
+  void _addValue( const Variant& value );
+
+  class Impl;
+  ScopedPtr< Impl > _d;
+};
+
+/**
+ * \class JsonObjectReader
+ * \brief Passes members of root object one by one
+ *
+ * Every member of root object is built and sent to onMember() as soon as it
+ * is parsed and isn't kept after, so whole document never lives in memory.
+ */
+class JsonObjectReader : public JsonVariantBuilder
+{
+public:
+  JsonObjectReader();
+  virtual ~JsonObjectReader();
+
+oc3_signals public:
+  Signal2< const std::string&, const Variant& >& onMember();
+
+protected:
+  virtual void _store( Variant& value, int depth, const std::string& name );
+
+private:
+  class Impl;
+  ScopedPtr< Impl > _d;
+};
+
 /**
  * \class Json
  * \brief A JSON data parser
@@ -65,6 +162,17 @@ public:
     */
    static Variant parse(const std::string &json, bool &success);
 
+   /**
+    * Reads JSON data in one pass and reports its content to handler,
+    * data isn't copied
+    *
+    * \param data The JSON data, needn't be null terminated
+    * \param size Size of data in bytes
+    * \param handler Receiver of parse events
+    * \param error Description of error with line number, if parsing failed
+    */
+   static bool parse(const char* data, unsigned int size, JsonHandler& handler, std::string& error);
+
    /**
    * This method generates a textual JSON representation
    *
@@ -82,106 +190,6 @@ public:
    * \return ByteArray Textual JSON representation
    */
    static std::string serialize(const Variant &data, bool &success, const std::string& tab);
-
- private:
-   /**
-    * Parses a value starting from index
-    *
-    * \param json The JSON data
-    * \param index The start index
-    * \param success The success of the parse process
-    *
-    * \return Variant The parsed value
-    */
-   static Variant parseValue(const std::string &json, int &index,
-                                                      bool &success);
-
-   /**
-    * Parses an object starting from index
-    *
-    * \param json The JSON data
-    * \param index The start index
-    * \param success The success of the object parse
-    *
-    * \return Variant The parsed object map
-    */
-   static Variant parseObject(const std::string &json, int &index,
-                                                              bool &success);
-
-   /**
-    * Parses an array starting from index
-    *
-    * \param json The JSON data
-    * \param index The starting index
-    * \param success The success of the array parse
-    *
-    * \return Variant The parsed variant array
-    */
-   static Variant parseArray(const std::string &json, int &index,
-                                                              bool &success);
-
-   /**
-    * Parses a string starting from index
-    *
-    * \param json The JSON data
-    * \param index The starting index
-    * \param success The success of the string parse
-    *
-    * \return QVariant The parsed string
-    */
-   static Variant parseString(const std::string &json, int &index, bool &success);
-   
-   static Variant parseObjectName(const std::string &json, int &index, bool &success, char limiters=':' );
-
-   static void parseComment(const std::string &json, int &index, bool &success);
-
-   /**
-    * Parses a number starting from index
-    *
-    * \param json The JSON data
-    * \param index The starting index
-    *
-    * \return QVariant The parsed number
-    */
-   static Variant parseNumber(const std::string &json, int &index);
-
-   /**
-    * Get the last index of a number starting from index
-    *
-    * \param json The JSON data
-    * \param index The starting index
-    *
-    * \return The last index of the number
-    */
-   static int lastIndexOfNumber(const std::string &json, int index);
-
-   /**
-    * Skip unwanted whitespace symbols starting from index
-    *
-    * \param json The JSON data
-    * \param index The start index
-    */
-   static void eatWhitespace(const std::string &json, int &index);
-
-   /**
-    * Check what token lies ahead
-    *
-    * \param json The JSON data
-    * \param index The starting index
-    *
-    * \return int The upcoming token
-    */
-   static int lookAhead(const std::string &json, int index);
-
-   /**
-    * Get the next JSON token
-    *
-    * \param json The JSON data
-    * \param index The starting index
-    *
-    * \return int The next JSON token
-    */
-   static int nextToken(const std::string &json, int &index);
 };
 
 #endif //__OPENCAESAR3_JSON_PARSER_H_INCLUDE__
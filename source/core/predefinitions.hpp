@@ -78,6 +78,7 @@ PREFEDINE_CLASS_SMARTPOINTER(Prefecture)
 PREFEDINE_NS_CLASS_SMARTPOINTER(events,GameEvent)
 PREFEDINE_CLASS_SMARTPOINTER(Player)
 PREFEDINE_CLASS_SMARTPOINTER(Prefect)
+PREFEDINE_CLASS_SMARTPOINTER(TerrainArrays)
 
 class Tile;
 typedef std::list< const Tile* > ConstTilemapWay;
@@ -16,11 +16,20 @@
 #include "saveadapter.hpp"
 #include "scopedptr.hpp"
 #include "json.hpp"
+#include "variantbinary.hpp"
 #include "logger.hpp"
+#include "platform.hpp"
 
 #include <fstream>
+#include <cstdio>
 
-VariantMap SaveAdapter::load( const io::FilePath& fileName )
+#ifdef OC3_PLATFORM_WIN
+  #include <io.h>
+#else
+  #include <unistd.h>
+#endif
+
+static bool readFile( const io::FilePath& fileName, ByteArray& data )
 {
   std::fstream f( fileName.toString().c_str(), std::ios::in | std::ios::binary);
 
@@ -30,46 +39,142 @@ VariantMap SaveAdapter::load( const io::FilePath& fileName )
   if( lastPos > 0 )
   {
     f.seekg( 0, std::ios::beg );
-    ByteArray data;
     data.resize( lastPos );
 
     f.read( &data[0], lastPos );
 
     f.close();
+    return true;
+  }
 
-    bool jsonParsingOk;
-    Variant ret = Json::parse( data.data(), jsonParsingOk );
-    if( jsonParsingOk )
+  Logger::warning( "Can't find file %s", fileName.toString().c_str() );
+  return false;
+}
+
+VariantMap SaveAdapter::load( const io::FilePath& fileName )
+{
+  ByteArray data;
+  if( !readFile( fileName, data ) )
+  {
+    return VariantMap();
+  }
+
+  if( VariantBinary::isBinary( data.data(), data.size() ) )
+  {
+    bool binaryParsingOk;
+    Variant ret = VariantBinary::parse( data.data(), data.size(), binaryParsingOk );
+    if( binaryParsingOk )
     {
       return ret.toMap();
     }
-    else
-    {
-     Logger::warning( "Can't parse file %s: %s", fileName.toString().c_str(), ret.toString().c_str() );
-    }
+
+    Logger::warning( "Can't parse binary file %s", fileName.toString().c_str() );
+    return VariantMap();
   }
-  else
+
+  JsonVariantBuilder builder;
+  std::string error;
+  if( Json::parse( data.data(), data.size(), builder, error ) )
   {
-    Logger::warning( "Can't find file %s", fileName.toString().c_str() );
+    return builder.getResult().toMap();
   }
 
+  Logger::warning( "Can't parse file %s: %s", fileName.toString().c_str(), error.c_str() );
   return VariantMap();
 }
 
+bool SaveAdapter::load( const io::FilePath& fileName, JsonHandler& handler )
+{
+  ByteArray data;
+  if( !readFile( fileName, data ) )
+  {
+    return false;
+  }
+
+  std::string error;
+  if( !Json::parse( data.data(), data.size(), handler, error ) )
+  {
+    Logger::warning( "Can't parse file %s: %s", fileName.toString().c_str(), error.c_str() );
+    return false;
+  }
+
+  return true;
+}
+
+// writes data to temporary file and replaces target with it only after data
+// reached disk, so crash while saving doesn't spoil previous save
+static bool writeFileSafely( const io::FilePath& fileName, const ByteArray& data )
+{
+  std::string tmpName = fileName.toString() + ".tmp";
+  FILE* f = fopen( tmpName.c_str(), "wb" );
+  if( !f )
+  {
+    Logger::warning( "Can't open file %s for writing", tmpName.c_str() );
+    return false;
+  }
+
+  bool ok = fwrite( data.data(), 1, data.size(), f ) == data.size();
+  ok = ok && fflush( f ) == 0;
+#ifdef OC3_PLATFORM_WIN
+  ok = ok && _commit( _fileno( f ) ) == 0;
+#else
+  ok = ok && fsync( fileno( f ) ) == 0;
+#endif
+  ok = (fclose( f ) == 0) && ok;
+
+  if( ok )
+  {
+#ifdef OC3_PLATFORM_WIN
+    remove( fileName.toString().c_str() );
+#endif
+    ok = rename( tmpName.c_str(), fileName.toString().c_str() ) == 0;
+  }
+
+  if( !ok )
+  {
+    Logger::warning( "Can't write file %s", fileName.toString().c_str() );
+    remove( tmpName.c_str() );
+  }
+
+  return ok;
+}
+
 SaveAdapter::SaveAdapter()
 {
 
 }
 
-bool SaveAdapter::save( const VariantMap& options, const io::FilePath& filename )
+bool SaveAdapter::isBinary( const io::FilePath& fileName )
+{
+  std::fstream f( fileName.toString().c_str(), std::ios::in | std::ios::binary);
+
+  char header[ VariantBinary::headerSize ];
+  f.read( header, VariantBinary::headerSize );
+
+  return f.good() && VariantBinary::isBinary( header, VariantBinary::headerSize );
+}
+
+bool SaveAdapter::save( const VariantMap& options, const io::FilePath& filename, Format format )
 {
-  std::string data = Json::serialize( options.toVariant(), " " );
-  if( !data.empty() )
+  return save( options.toVariant(), filename, format );
+}
+
+bool SaveAdapter::save( const Variant& data, const io::FilePath& filename, Format format )
+{
+  if( format == binary )
   {
-    std::fstream f( filename.toString().c_str(), std::ios::out | std::ios::binary);
-    f.write( data.c_str(), data.size() ); 
-    f.close();
+    ByteArray bytes = VariantBinary::serialize( data, VariantBinary::compressed );
+    return writeFileSafely( filename, bytes );
   }
 
-  return true;
+  std::string text = Json::serialize( data, " " );
+  if( text.empty() )
+  {
+    Logger::warning( "Can't serialize data for %s", filename.toString().c_str() );
+    return false;
+  }
+
+  ByteArray bytes;
+  bytes.assign( text.begin(), text.end() );
+  return writeFileSafely( filename, bytes );
 }
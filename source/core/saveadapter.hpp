@@ -19,12 +19,24 @@
 #include "core/variant.hpp"
 #include "vfs/filepath.hpp"
 
+class JsonHandler;
+
 class SaveAdapter
 {
 public:
+  typedef enum { json=0, binary } Format;
+
+  // reads json or binary file, format is detected by magic bytes
   static VariantMap load( const io::FilePath& fileName );
 
-  static bool save( const VariantMap& options, const io::FilePath& filename );
+  // streams json file to handler without building whole hierarchy
+  static bool load( const io::FilePath& fileName, JsonHandler& handler );
+
+  static bool save( const VariantMap& options, const io::FilePath& filename, Format format=json );
+  // data isn't copied, so big hierarchy may be saved without wrapping map into variant
+  static bool save( const Variant& data, const io::FilePath& filename, Format format=json );
+
+  static bool isBinary( const io::FilePath& fileName );
 private:
   SaveAdapter();
 };
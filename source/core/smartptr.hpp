@@ -79,7 +79,7 @@ public:
     obj = (T*)anObj;
   }
   
-  T* object()
+  T* object() const
   {
     return obj;
   }
@@ -0,0 +1,196 @@
+// This file is part of openCaesar3.
+//
+// openCaesar3 is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// openCaesar3 is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with openCaesar3.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "threadpool.hpp"
+#include "platform.hpp"
+#include "logger.hpp"
+
+#include <SDL_thread.h>
+#include <SDL_mutex.h>
+#include <vector>
+#include <algorithm>
+
+#ifdef OC3_PLATFORM_WIN
+  #include <windows.h>
+#else
+  #include <unistd.h>
+#endif
+
+class ThreadPool::Impl
+{
+public:
+  std::vector< SDL_Thread* > threads;
+  SDL_mutex* mutex;
+  SDL_cond* wakeCond;   // new task was given to workers
+  SDL_cond* doneCond;   // worker finished its part of task
+
+  Task* task;
+  int count;
+  int chunkSize;
+  int nextItem;
+  int activeWorkers;
+  unsigned int generation;
+  bool quit;
+
+  // takes next part of task, returns false when nothing left
+  bool takeChunk( int& begin, int& end )
+  {
+    SDL_LockMutex( mutex );
+    begin = nextItem;
+    end = std::min( count, begin + chunkSize );
+    nextItem = end;
+    SDL_UnlockMutex( mutex );
+
+    return begin < end;
+  }
+
+  void processTask()
+  {
+    int begin, end;
+    while( takeChunk( begin, end ) )
+    {
+      task->exec( begin, end );
+    }
+  }
+
+  static int workerLoop( void* data )
+  {
+    Impl* d = (Impl*)data;
+    unsigned int lastGeneration = 0;
+
+    while( true )
+    {
+      SDL_LockMutex( d->mutex );
+      while( !d->quit && d->generation == lastGeneration )
+      {
+        SDL_CondWait( d->wakeCond, d->mutex );
+      }
+
+      if( d->quit )
+      {
+        SDL_UnlockMutex( d->mutex );
+        break;
+      }
+
+      lastGeneration = d->generation;
+      SDL_UnlockMutex( d->mutex );
+
+      d->processTask();
+
+      SDL_LockMutex( d->mutex );
+      d->activeWorkers--;
+      if( d->activeWorkers == 0 )
+      {
+        SDL_CondSignal( d->doneCond );
+      }
+      SDL_UnlockMutex( d->mutex );
+    }
+
+    return 0;
+  }
+};
+
+ThreadPool::ThreadPool( int threadsCount ) : _d( new Impl )
+{
+  _d->mutex = SDL_CreateMutex();
+  _d->wakeCond = SDL_CreateCond();
+  _d->doneCond = SDL_CreateCond();
+  _d->task = 0;
+  _d->count = 0;
+  _d->chunkSize = 1;
+  _d->nextItem = 0;
+  _d->activeWorkers = 0;
+  _d->generation = 0;
+  _d->quit = false;
+
+  for( int k=0; k < threadsCount; k++ )
+  {
+    SDL_Thread* thread = SDL_CreateThread( &Impl::workerLoop, _d.data() );
+    if( thread == 0 )
+    {
+      Logger::warning( "ThreadPool: can't create worker thread %d", k );
+      break;
+    }
+
+    _d->threads.push_back( thread );
+  }
+}
+
+ThreadPool::~ThreadPool()
+{
+  SDL_LockMutex( _d->mutex );
+  _d->quit = true;
+  SDL_CondBroadcast( _d->wakeCond );
+  SDL_UnlockMutex( _d->mutex );
+
+  for( std::vector< SDL_Thread* >::iterator it=_d->threads.begin(); it != _d->threads.end(); it++ )
+  {
+    SDL_WaitThread( *it, 0 );
+  }
+
+  SDL_DestroyCond( _d->doneCond );
+  SDL_DestroyCond( _d->wakeCond );
+  SDL_DestroyMutex( _d->mutex );
+}
+
+int ThreadPool::getThreadsCount() const
+{
+  return (int)_d->threads.size();
+}
+
+void ThreadPool::run( Task& task, int count )
+{
+  if( count <= 0 )
+    return;
+
+  if( _d->threads.empty() )
+  {
+    task.exec( 0, count );
+    return;
+  }
+
+  int partsCount = ((int)_d->threads.size() + 1) * 4;
+
+  SDL_LockMutex( _d->mutex );
+  _d->task = &task;
+  _d->count = count;
+  _d->chunkSize = std::max( 1, (count + partsCount - 1) / partsCount );
+  _d->nextItem = 0;
+  _d->activeWorkers = (int)_d->threads.size();
+  _d->generation++;
+  SDL_CondBroadcast( _d->wakeCond );
+  SDL_UnlockMutex( _d->mutex );
+
+  _d->processTask();
+
+  SDL_LockMutex( _d->mutex );
+  while( _d->activeWorkers > 0 )
+  {
+    SDL_CondWait( _d->doneCond, _d->mutex );
+  }
+  _d->task = 0;
+  SDL_UnlockMutex( _d->mutex );
+}
+
+int ThreadPool::getCpuCount()
+{
+#ifdef OC3_PLATFORM_WIN
+  SYSTEM_INFO info;
+  GetSystemInfo( &info );
+  return std::max( 1, (int)info.dwNumberOfProcessors );
+#else
+  return std::max( 1, (int)sysconf( _SC_NPROCESSORS_ONLN ) );
+#endif
+}
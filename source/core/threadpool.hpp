@@ -0,0 +1,50 @@
+// This file is part of openCaesar3.
+//
+// openCaesar3 is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// openCaesar3 is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with openCaesar3.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __OPENCAESAR3_THREADPOOL_H_INCLUDED__
+#define __OPENCAESAR3_THREADPOOL_H_INCLUDED__
+
+#include "core/scopedptr.hpp"
+
+// Worker threads for data parallel jobs: walkers movement, pictures decoding.
+// run() splits range of items into parts, processes them on workers
+// and on calling thread, and returns when all parts are done.
+class ThreadPool
+{
+public:
+  class Task
+  {
+  public:
+    virtual ~Task() {}
+
+    // processes items [begin, end), called from any thread
+    virtual void exec( int begin, int end ) = 0;
+  };
+
+  // threadsCount : count of workers, calling thread isn't counted
+  ThreadPool( int threadsCount );
+  ~ThreadPool();
+
+  int getThreadsCount() const;
+  void run( Task& task, int count );
+
+  static int getCpuCount();
+
+private:
+  class Impl;
+  ScopedPtr< Impl > _d;
+};
+
+#endif //__OPENCAESAR3_THREADPOOL_H_INCLUDED__
@@ -151,6 +151,27 @@ struct Variant2Handler
 
 static Variant2Handler* varHandler = new Variant2Handler();
 
+// returns true when value of type lives in Variant2Impl::data
+static bool isStoredInline( unsigned int type )
+{
+  switch( type )
+  {
+  case Variant::String: return VariantInline<std::string>::value;
+  case Variant::NDateTime: return VariantInline<DateTime>::value;
+  case Variant::NPoint: return VariantInline<Point>::value;
+  case Variant::NPointF: return VariantInline<PointF>::value;
+  case Variant::NTilePos: return VariantInline<TilePos>::value;
+  case Variant::NSize: return VariantInline<Size>::value;
+  case Variant::NSizeF: return VariantInline<SizeF>::value;
+  case Variant::NRectI: return VariantInline<Rect>::value;
+  case Variant::NRectF: return VariantInline<RectF>::value;
+  default: break;
+  }
+
+  // numbers are kept in union members
+  return type <= Variant::Short;
+}
+
 static bool checkVariantNull( const Variant2Impl *x )
 {
   return x->is_null;
@@ -286,7 +307,7 @@ static void clearVariant(Variant2Impl *d)
 template<typename T>
 inline bool compareNumericMetaType(const Variant2Impl *const a, const Variant2Impl *const b)
 {
-    return *static_cast<const T *>(a->data.ptr) == *static_cast<const T *>(b->data.ptr);
+    return *reinterpret_cast<const T *>(a->data.raw) == *reinterpret_cast<const T *>(b->data.raw);
 }
 
 static bool compare(const Variant2Impl *a, const Variant2Impl *b)
@@ -1230,6 +1251,39 @@ void Variant::clear()
     _d.is_null = true;
 }
 
+// inline string may point into own buffer, values of other types are moved as plain bytes
+static bool isRelocatable( unsigned int type )
+{
+  return !( type == Variant::String && VariantInline<std::string>::value );
+}
+
+void Variant::swap( Variant& other )
+{
+  if( this == &other )
+    return;
+
+  if( isRelocatable( _d.type ) && isRelocatable( other._d.type ) )
+  {
+    Variant2Impl tmp( _d );
+    _d = other._d;
+    other._d = tmp;
+    return;
+  }
+
+  if( _d.type == String && other._d.type == String )
+  {
+    v_cast<std::string>( &_d )->swap( *v_cast<std::string>( &other._d ) );
+    bool isNull = _d.is_null;
+    _d.is_null = other._d.is_null;
+    other._d.is_null = isNull;
+    return;
+  }
+
+  Variant tmp( *this );
+  *this = other;
+  other = tmp;
+}
+
 /*!
     Converts the enum representation of the storage type, \a typ, to
     its string representation.
@@ -1914,7 +1968,9 @@ bool Variant::cmp(const Variant &v) const
 
 const void *Variant::constData() const
 {
-    return reinterpret_cast<const void *>(_d.data.ptr);
+    return isStoredInline( _d.type )
+             ? reinterpret_cast<const void *>(_d.data.raw)
+             : reinterpret_cast<const void *>(_d.data.ptr);
 }
 
 /*!
@@ -1959,6 +2015,8 @@ Variant2Handler::Variant2Handler()
 	convert = convertVariantType2Type;
 	clear = clearVariant;
   isNull = checkVariantNull;
+  compare = ::compare;
+  canConvert = 0;
 }
 
 
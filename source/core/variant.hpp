@@ -24,7 +24,10 @@
 #include "position.hpp"
 #include "rectangle.hpp"
 
+#include "flatmap.hpp"
+
 #include <list>
+#include <vector>
 #include <map>
 #include <typeinfo>
 
@@ -65,6 +68,7 @@ struct Variant2Impl
         unsigned long long ull;
         ReferenceCounted* o;
         void* ptr;
+        char raw[ 32 ]; // small values are constructed here, see variantprivate.hpp
     } data;
     unsigned int type : 30;
     unsigned int reserved : 1;
@@ -177,6 +181,9 @@ class Variant
 
     Variant& operator=( const Variant& other);
 
+    // exchanges values without copying them, lists and maps only change owner
+    void swap( Variant& other );
+
     Type type() const;
     int userType() const;
     std::string typeName() const;
@@ -254,34 +261,66 @@ private:
     inline Variant(bool, int) { _OC3_DEBUG_BREAK_IF(true); }
 };
 
-class VariantList : public std::list<Variant>
+// items are kept in one block, so lists of numbers from saves and models
+// don't allocate node per item
+class VariantList : public std::vector<Variant>
 {
 public:
   VariantList() {}
 
-  Variant get( const unsigned int index, Variant defaultVal=Variant() ) const
+  // items are swapped into new block when it grows, so nested lists
+  // and maps aren't copied on reallocation
+  void push_back( const Variant& value )
   {
-    VariantList::const_iterator it = begin();
-    if( index >= size() )
+    if( size() == capacity() )
     {
-      return defaultVal;
+      Variant item( value );  // value may be item of this list
+      _grow( size() < 4 ? 4 : size() * 2 );
+      std::vector<Variant>::push_back( Variant() );
+      back().swap( item );
+      return;
     }
-    else
+
+    std::vector<Variant>::push_back( value );
+  }
+
+  void reserve( size_type count )
+  {
+    if( count > capacity() )
     {
-      std::advance( it, index );
-      return *it;
+      _grow( count );
     }
   }
 
+  Variant get( const unsigned int index, Variant defaultVal=Variant() ) const
+  {
+    return index < size() ? (*this)[ index ] : defaultVal;
+  }
+
   template<class T>
   VariantList( std::vector<T> array )
   {
+    reserve( array.size() );
     typename std::vector<T>::iterator it = array.begin();
     for( ; it != array.end(); it++ )
     {
       push_back( Variant(*it) );
     }
   }
+
+private:
+  void _grow( size_type count )
+  {
+    std::vector<Variant> block;
+    block.reserve( count );
+    block.resize( size() );
+    for( size_type k=0; k < size(); k++ )
+    {
+      block[ k ].swap( (*this)[ k ] );
+    }
+
+    std::vector<Variant>::swap( block );
+  }
 };
 
 template<class T>
@@ -298,7 +337,15 @@ typename std::vector<T>& operator<<(std::vector<T>& v, const VariantList& vars)
 
 StringArray& operator<<(StringArray& strlist, const VariantList& vars );
 
-class VariantMap : public std::map<std::string, Variant>
+// flat map is faster to read and copy, but slower on random insertions,
+// it is enabled by OC3_FLAT_VARIANTMAP
+#ifdef OC3_FLAT_VARIANTMAP
+  typedef FlatMap<std::string, Variant> VariantMapBase;
+#else
+  typedef std::map<std::string, Variant> VariantMapBase;
+#endif
+
+class VariantMap : public VariantMapBase
 {
 public:
   VariantMap() {}
@@ -328,6 +375,16 @@ public:
   {
     return Variant( *this );
   }
+
+  // stores empty map with given name and returns it, so nested map is filled
+  // in place instead of being copied into this one. Reference is valid until
+  // next insertion into this map
+  VariantMap& createMap( const std::string& name )
+  {
+    Variant& item = (*this)[ name ];
+    item = Variant( VariantMap() );
+    return *static_cast< VariantMap* >( item.data() );
+  }
 };
 
 inline Variant::Variant() {}
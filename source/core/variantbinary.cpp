@@ -0,0 +1,562 @@
+// This file is part of openCaesar3.
+//
+// openCaesar3 is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// openCaesar3 is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with openCaesar3.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "variantbinary.hpp"
+#include "logger.hpp"
+#include "time.hpp"
+#include "position.hpp"
+#include "size.hpp"
+#include "rectangle.hpp"
+#include "stringarray.hpp"
+
+#if defined(NO_USE_SYSTEM_ZLIB)
+    #include "utils/zlib/zlib.h"
+#else
+    #include <zlib.h>
+#endif
+
+#include <cstring>
+#include <algorithm>
+
+static const char binaryMagic[4] = { 'O', 'C', '3', 'B' };
+static const unsigned int binaryVersion = 1;
+
+namespace {
+
+class Writer
+{
+public:
+  ByteArray& out;
+
+  Writer( ByteArray& stream ) : out( stream ) {}
+
+  void writeU8( unsigned char value ) { out.push_back( (char)value ); }
+
+  void writeU32( unsigned int value )
+  {
+    for( int k=0; k < 4; k++ ) { out.push_back( (char)( (value >> (k*8)) & 0xff ) ); }
+  }
+
+  void writeU64( unsigned long long value )
+  {
+    for( int k=0; k < 8; k++ ) { out.push_back( (char)( (value >> (k*8)) & 0xff ) ); }
+  }
+
+  void writeFloat( float value )
+  {
+    unsigned int bits;
+    memcpy( &bits, &value, sizeof(bits) );
+    writeU32( bits );
+  }
+
+  void writeDouble( double value )
+  {
+    unsigned long long bits;
+    memcpy( &bits, &value, sizeof(bits) );
+    writeU64( bits );
+  }
+
+  void writeBytes( const char* data, unsigned int size )
+  {
+    writeU32( size );
+    out.insert( out.end(), data, data + size );
+  }
+
+  void writeString( const std::string& str ) { writeBytes( str.data(), str.size() ); }
+
+  void patchU32( unsigned int offset, unsigned int value )
+  {
+    for( int k=0; k < 4; k++ ) { out[ offset + k ] = (char)( (value >> (k*8)) & 0xff ); }
+  }
+
+  void writeValue( const Variant& value );
+};
+
+class Reader
+{
+public:
+  const unsigned char* data;
+  unsigned int size;
+  unsigned int pos;
+  bool ok;
+
+  Reader( const char* stream, unsigned int length )
+    : data( (const unsigned char*)stream ), size( length ), pos( 0 ), ok( true ) {}
+
+  bool has( unsigned int count )
+  {
+    ok = ok && ( count <= size - pos );
+    return ok;
+  }
+
+  unsigned char readU8()
+  {
+    return has( 1 ) ? data[ pos++ ] : 0;
+  }
+
+  unsigned int readU32()
+  {
+    if( !has( 4 ) )
+      return 0;
+
+    unsigned int value = 0;
+    for( int k=0; k < 4; k++ ) { value |= (unsigned int)data[ pos++ ] << (k*8); }
+    return value;
+  }
+
+  unsigned long long readU64()
+  {
+    if( !has( 8 ) )
+      return 0;
+
+    unsigned long long value = 0;
+    for( int k=0; k < 8; k++ ) { value |= (unsigned long long)data[ pos++ ] << (k*8); }
+    return value;
+  }
+
+  float readFloat()
+  {
+    unsigned int bits = readU32();
+    float value;
+    memcpy( &value, &bits, sizeof(value) );
+    return value;
+  }
+
+  double readDouble()
+  {
+    unsigned long long bits = readU64();
+    double value;
+    memcpy( &value, &bits, sizeof(value) );
+    return value;
+  }
+
+  std::string readString()
+  {
+    unsigned int length = readU32();
+    if( !has( length ) )
+      return std::string();
+
+    std::string ret( (const char*)data + pos, length );
+    pos += length;
+    return ret;
+  }
+
+  ByteArray readBytes()
+  {
+    ByteArray ret;
+    unsigned int length = readU32();
+    if( has( length ) && length > 0 )
+    {
+      ret.assign( (const char*)data + pos, (const char*)data + pos + length );
+      pos += length;
+    }
+    return ret;
+  }
+
+  // nested maps and lists deeper than maxDepth mean broken stream
+  static const int maxDepth = 64;
+
+  void readValue( Variant& value, int depth );
+
+private:
+  bool _enter( int depth )
+  {
+    if( depth >= maxDepth )
+    {
+      Logger::warning( "VariantBinary: nesting deeper than %d at %d", maxDepth, pos );
+      ok = false;
+    }
+
+    return ok;
+  }
+};
+
+void Writer::writeValue( const Variant& value )
+{
+  Variant::Type type = value.type();
+  switch( type )
+  {
+  case Variant::Invalid: writeU8( type ); break;
+  case Variant::Bool: writeU8( type ); writeU8( value.toBool() ? 1 : 0 ); break;
+  case Variant::Char: writeU8( type ); writeU8( value.toChar() ); break;
+  case Variant::Int: writeU8( type ); writeU32( (unsigned int)value.toInt() ); break;
+  case Variant::UInt: writeU8( type ); writeU32( value.toUInt() ); break;
+  case Variant::LongLong: writeU8( type ); writeU64( (unsigned long long)value.toLongLong() ); break;
+  case Variant::ULongLong: writeU8( type ); writeU64( value.toULongLong() ); break;
+  case Variant::Float: writeU8( type ); writeFloat( value.toFloat() ); break;
+  case Variant::Double: writeU8( type ); writeDouble( value.toDouble() ); break;
+  case Variant::String: writeU8( type ); writeString( value.toString() ); break;
+
+  case Variant::NByteArray:
+  {
+    const ByteArray& bytes = *static_cast< const ByteArray* >( value.constData() );
+    writeU8( type );
+    writeBytes( bytes.empty() ? "" : bytes.data(), bytes.size() );
+  }
+  break;
+
+  case Variant::NStringArray:
+  {
+    const StringArray& items = *static_cast< const StringArray* >( value.constData() );
+    writeU8( type );
+    writeU32( items.size() );
+    for( StringArray::const_iterator it=items.begin(); it != items.end(); it++ ) { writeString( *it ); }
+  }
+  break;
+
+  case Variant::NDateTime:
+  {
+    DateTime date = value.toDateTime();
+    writeU8( type );
+    writeU32( (unsigned int)date.getYear() );
+    writeU8( date.getMonth() );
+    writeU8( date.getDay() );
+    writeU8( date.getHour() );
+    writeU8( date.getMinutes() );
+    writeU8( date.getSeconds() );
+  }
+  break;
+
+  case Variant::NTilePos:
+  {
+    TilePos tpos = value.toTilePos();
+    writeU8( type ); writeU32( (unsigned int)tpos.getI() ); writeU32( (unsigned int)tpos.getJ() );
+  }
+  break;
+
+  case Variant::NPoint:
+  {
+    Point pt = value.toPoint();
+    writeU8( type ); writeU32( (unsigned int)pt.getX() ); writeU32( (unsigned int)pt.getY() );
+  }
+  break;
+
+  case Variant::NPointF:
+  {
+    PointF pt = value.toPointF();
+    writeU8( type ); writeFloat( pt.getX() ); writeFloat( pt.getY() );
+  }
+  break;
+
+  case Variant::NSize:
+  {
+    Size size = value.toSize();
+    writeU8( type ); writeU32( (unsigned int)size.getWidth() ); writeU32( (unsigned int)size.getHeight() );
+  }
+  break;
+
+  case Variant::NSizeF:
+  {
+    SizeF size = value.toSizeF();
+    writeU8( type ); writeFloat( size.getWidth() ); writeFloat( size.getHeight() );
+  }
+  break;
+
+  case Variant::NRectI:
+  {
+    Rect rect = value.toRect();
+    writeU8( type );
+    writeU32( (unsigned int)rect.getLeft() ); writeU32( (unsigned int)rect.getTop() );
+    writeU32( (unsigned int)rect.getRight() ); writeU32( (unsigned int)rect.getBottom() );
+  }
+  break;
+
+  case Variant::NRectF:
+  {
+    RectF rect = value.toRectf();
+    writeU8( type );
+    writeFloat( rect.getLeft() ); writeFloat( rect.getTop() );
+    writeFloat( rect.getRight() ); writeFloat( rect.getBottom() );
+  }
+  break;
+
+  case Variant::Map:
+  {
+    // containers are read in place, copies would repeat on every level of tree
+    const VariantMap& items = *static_cast< const VariantMap* >( value.constData() );
+    writeU8( type );
+    unsigned int lengthOffset = out.size();
+    writeU32( 0 );
+    writeU32( items.size() );
+    for( VariantMap::const_iterator it=items.begin(); it != items.end(); it++ )
+    {
+      writeString( it->first );
+      writeValue( it->second );
+    }
+    patchU32( lengthOffset, out.size() - lengthOffset - 4 );
+  }
+  break;
+
+  case Variant::List:
+  {
+    const VariantList& items = *static_cast< const VariantList* >( value.constData() );
+    writeU8( type );
+    unsigned int lengthOffset = out.size();
+    writeU32( 0 );
+    writeU32( items.size() );
+    for( VariantList::const_iterator it=items.begin(); it != items.end(); it++ ) { writeValue( *it ); }
+    patchU32( lengthOffset, out.size() - lengthOffset - 4 );
+  }
+  break;
+
+  default:
+    Logger::warning( "VariantBinary: store variant type %d as string", type );
+    writeU8( Variant::String );
+    writeString( value.toString() );
+  break;
+  }
+}
+
+void Reader::readValue( Variant& value, int depth )
+{
+  value.clear();
+  Variant::Type type = (Variant::Type)readU8();
+  if( !ok )
+    return;
+
+  switch( type )
+  {
+  case Variant::Invalid: return;
+  case Variant::Bool: value = Variant( readU8() != 0 ); return;
+  case Variant::Char: value = Variant( (char)readU8() ); return;
+  case Variant::Int: value = Variant( (int)readU32() ); return;
+  case Variant::UInt: value = Variant( readU32() ); return;
+  case Variant::LongLong: value = Variant( (long long)readU64() ); return;
+  case Variant::ULongLong: value = Variant( readU64() ); return;
+  case Variant::Float: value = Variant( readFloat() ); return;
+  case Variant::Double: value = Variant( readDouble() ); return;
+  case Variant::String: value = Variant( readString() ); return;
+
+  case Variant::NByteArray:
+  {
+    ByteArray bytes = readBytes();
+    value = Variant( ByteArray() );
+    static_cast< ByteArray* >( value.data() )->swap( bytes );
+    return;
+  }
+
+  case Variant::NStringArray:
+  {
+    StringArray items;
+    unsigned int count = readU32();
+    items.reserve( std::min( count, ( size - pos ) / 4 ) );  // every string takes 4 bytes at least
+    for( unsigned int k=0; k < count && ok; k++ ) { items.push_back( readString() ); }
+    value = Variant( items ); return;
+  }
+
+  case Variant::NDateTime:
+  {
+    int year = (int)readU32();
+    unsigned char month = readU8();
+    unsigned char day = readU8();
+    unsigned char hour = readU8();
+    unsigned char minutes = readU8();
+    unsigned char seconds = readU8();
+    value = Variant( DateTime( year, month, day, hour, minutes, seconds ) ); return;
+  }
+
+  case Variant::NTilePos:
+  {
+    int i = (int)readU32();
+    int j = (int)readU32();
+    value = Variant( TilePos( i, j ) ); return;
+  }
+
+  case Variant::NPoint:
+  {
+    int x = (int)readU32();
+    int y = (int)readU32();
+    value = Variant( Point( x, y ) ); return;
+  }
+
+  case Variant::NPointF:
+  {
+    float x = readFloat();
+    float y = readFloat();
+    value = Variant( PointF( x, y ) ); return;
+  }
+
+  case Variant::NSize:
+  {
+    int w = (int)readU32();
+    int h = (int)readU32();
+    value = Variant( Size( w, h ) ); return;
+  }
+
+  case Variant::NSizeF:
+  {
+    float w = readFloat();
+    float h = readFloat();
+    value = Variant( SizeF( w, h ) ); return;
+  }
+
+  case Variant::NRectI:
+  {
+    int left = (int)readU32();
+    int top = (int)readU32();
+    int right = (int)readU32();
+    int bottom = (int)readU32();
+    value = Variant( Rect( left, top, right, bottom ) ); return;
+  }
+
+  case Variant::NRectF:
+  {
+    float left = readFloat();
+    float top = readFloat();
+    float right = readFloat();
+    float bottom = readFloat();
+    value = Variant( RectF( left, top, right, bottom ) ); return;
+  }
+
+  case Variant::Map:
+  {
+    if( !_enter( depth ) )
+      return;
+
+    // items are read right into their places, nested maps and lists aren't copied
+    value = Variant( VariantMap() );
+    VariantMap& items = *static_cast< VariantMap* >( value.data() );
+    readU32(); // record length, used only for skipping
+    unsigned int count = readU32();
+    for( unsigned int k=0; k < count && ok; k++ )
+    {
+      std::string name = readString();
+      readValue( items[ name ], depth + 1 );
+    }
+    return;
+  }
+
+  case Variant::List:
+  {
+    if( !_enter( depth ) )
+      return;
+
+    value = Variant( VariantList() );
+    VariantList& items = *static_cast< VariantList* >( value.data() );
+    readU32();
+    unsigned int count = readU32();
+    items.reserve( std::min( count, size - pos ) );  // every value takes 1 byte at least
+    for( unsigned int k=0; k < count && ok; k++ )
+    {
+      items.push_back( Variant() );
+      readValue( items.back(), depth + 1 );
+    }
+    return;
+  }
+
+  default:
+    Logger::warning( "VariantBinary: unknown variant type %d at %d", type, pos-1 );
+    ok = false;
+  break;
+  }
+}
+
+}//end namespace
+
+ByteArray VariantBinary::serialize( const Variant& data, int flags )
+{
+  ByteArray body;
+  Writer bodyWriter( body );
+  bodyWriter.writeValue( data );
+
+  ByteArray ret;
+  Writer writer( ret );
+  ret.insert( ret.end(), binaryMagic, binaryMagic + 4 );
+  writer.writeU32( binaryVersion );
+
+  if( flags & compressed )
+  {
+    uLongf packedSize = compressBound( body.size() );
+    ByteArray packed;
+    packed.resize( packedSize );
+    int result = compress2( (Bytef*)packed.data(), &packedSize,
+                            (const Bytef*)body.data(), body.size(), Z_BEST_SPEED );
+    if( result == Z_OK )
+    {
+      writer.writeU32( compressed );
+      writer.writeU32( body.size() );
+      ret.insert( ret.end(), packed.begin(), packed.begin() + packedSize );
+      return ret;
+    }
+
+    Logger::warning( "VariantBinary: can't compress data, error %d", result );
+  }
+
+  writer.writeU32( plain );
+  writer.writeU32( body.size() );
+  ret.insert( ret.end(), body.begin(), body.end() );
+
+  return ret;
+}
+
+bool VariantBinary::isBinary( const char* data, unsigned int size )
+{
+  return size >= headerSize && memcmp( data, binaryMagic, 4 ) == 0;
+}
+
+Variant VariantBinary::parse( const char* data, unsigned int size, bool& success )
+{
+  success = false;
+  if( !isBinary( data, size ) )
+  {
+    return Variant();
+  }
+
+  Reader header( data + 4, headerSize - 4 );
+  unsigned int version = header.readU32();
+  unsigned int flags = header.readU32();
+  unsigned int bodySize = header.readU32();
+
+  if( version > binaryVersion )
+  {
+    Logger::warning( "VariantBinary: unsupported version %d", version );
+    return Variant();
+  }
+
+  const char* body = data + headerSize;
+  unsigned int available = size - headerSize;
+
+  // deflate packs data at most about 1032 times, bigger size means broken header
+  const unsigned long long maxPackRatio = 1032;
+  unsigned long long maxBodySize = (flags & compressed) ? available * maxPackRatio : available;
+  if( bodySize > maxBodySize )
+  {
+    Logger::warning( "VariantBinary: body size %d doesn't match %d available bytes", bodySize, available );
+    return Variant();
+  }
+
+  ByteArray unpacked;
+  if( flags & compressed )
+  {
+    unpacked.resize( bodySize );
+    uLongf unpackedSize = bodySize;
+    int result = uncompress( (Bytef*)unpacked.data(), &unpackedSize, (const Bytef*)body, available );
+    if( result != Z_OK || unpackedSize != bodySize )
+    {
+      Logger::warning( "VariantBinary: can't uncompress data, error %d", result );
+      return Variant();
+    }
+
+    body = unpacked.data();
+    available = bodySize;
+  }
+
+  Reader reader( body, available );
+  Variant ret;
+  reader.readValue( ret, 0 );
+  success = reader.ok;
+
+  return success ? ret : Variant();
+}
@@ -0,0 +1,59 @@
+// This file is part of openCaesar3.
+//
+// openCaesar3 is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// openCaesar3 is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with openCaesar3.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __OPENCAESAR3_VARIANTBINARY_H_INCLUDED__
+#define __OPENCAESAR3_VARIANTBINARY_H_INCLUDED__
+
+#include "variant.hpp"
+#include "bytearray.hpp"
+
+/**
+ * \class VariantBinary
+ * \brief Versioned binary representation of Variant hierarchy
+ *
+ * Stream starts with header: magic "OC3B", format version, flags and size of
+ * unpacked body, all numbers are little-endian. Body is one tagged value, maps
+ * and lists are records prefixed with their byte length and items count, so
+ * reader can skip them whole. Byte arrays are stored raw, without any escaping.
+ */
+class VariantBinary
+{
+public:
+  typedef enum { plain=0, compressed=0x1 } Flag;
+
+  /**
+   * Generates binary representation of data
+   *
+   * \param data The data for serialization
+   * \param flags compressed, if body must be packed with zlib
+   */
+  static ByteArray serialize( const Variant& data, int flags=plain );
+
+  /**
+   * Restores data from binary representation
+   *
+   * \param data Pointer to stream with header
+   * \param size Size of stream in bytes
+   * \param success The success of the parsing
+   */
+  static Variant parse( const char* data, unsigned int size, bool& success );
+
+  // returns true when stream starts with binary header
+  static bool isBinary( const char* data, unsigned int size );
+
+  static const unsigned int headerSize = 16;
+};
+
+#endif //__OPENCAESAR3_VARIANTBINARY_H_INCLUDED__
@@ -18,24 +18,59 @@
 #define __OPENCAESAR3_VARIANTPRIVATE_H_INCLUDED__
 
 #include "variant.hpp"
+#include <new>
+
+// Values of small types are constructed right in Variant2Impl::data, so creating
+// and copying of variant with them doesn't touch heap. Other types are allocated.
+template <typename T>
+struct VariantInline { enum { value = false }; };
+
+#define OC3_VARIANT_INLINE(T) \
+  template <> struct VariantInline< T > { enum { value = sizeof( T ) <= sizeof( Variant2Impl::Data ) }; };
+
+OC3_VARIANT_INLINE(std::string)
+OC3_VARIANT_INLINE(DateTime)
+OC3_VARIANT_INLINE(Point)
+OC3_VARIANT_INLINE(PointF)
+OC3_VARIANT_INLINE(TilePos)
+OC3_VARIANT_INLINE(Size)
+OC3_VARIANT_INLINE(SizeF)
+OC3_VARIANT_INLINE(Rect)
+OC3_VARIANT_INLINE(RectF)
+
+#undef OC3_VARIANT_INLINE
 
 template <typename T>
 inline const T *v_cast(const Variant2Impl *d, T * = 0)
 {
-  return static_cast<const T *>(static_cast<const void *>(d->data.ptr));
+  return VariantInline<T>::value
+           ? reinterpret_cast<const T *>( d->data.raw )
+           : static_cast<const T *>(static_cast<const void *>(d->data.ptr));
 }
 
 template <typename T>
 inline T *v_cast(Variant2Impl *d, T * = 0)
 {
-  return static_cast<T *>(static_cast<void *>(d->data.ptr));
+  return VariantInline<T>::value
+           ? reinterpret_cast<T *>( d->data.raw )
+           : static_cast<T *>(static_cast<void *>(d->data.ptr));
 }
 
-// constructs a new variant if copy is 0, otherwise copy-constructs
 template <class T>
 inline void v_construct(Variant2Impl *x, const void *copy, T * = 0)
 {
-  if (copy)
+  if( VariantInline<T>::value )
+  {
+    if (copy)
+    {
+      new (x->data.raw) T(*static_cast<const T *>(copy));
+    }
+    else
+    {
+      new (x->data.raw) T();
+    }
+  }
+  else if (copy)
   {
     x->data.ptr = (void*)new T(*static_cast<const T *>(copy));
   }
@@ -48,16 +83,29 @@ inline void v_construct(Variant2Impl *x, const void *copy, T * = 0)
 template <class T>
 inline void v_construct(Variant2Impl* x, const T& t)
 {
+  if( VariantInline<T>::value )
+  {
+    new (x->data.raw) T(t);
+  }
+  else
+  {
     x->data.ptr = (void*)new T(t);
+  }
 }
 
-// deletes the internal structures
 template <class T>
 inline void v_clear(Variant2Impl *d, T* = 0)
 {    
-  //now we need to cast
-  //because Variant2::PrivateShared doesn't have a virtual destructor
-  delete static_cast< T* >(d->data.ptr);
+  if( VariantInline<T>::value )
+  {
+    v_cast<T>(d)->~T();
+  }
+  else
+  {
+    //now we need to cast
+    //because Variant2::PrivateShared doesn't have a virtual destructor
+    delete static_cast< T* >(d->data.ptr);
+  }
 }
 
 #endif // __OPENCAESAR3_VARIANTPRIVATE_H_INCLUDED__
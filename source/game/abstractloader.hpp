@@ -26,7 +26,9 @@ public:
   virtual ~GameAbstractLoader() {}
   virtual bool load( const std::string& filename, Game& oScenario ) = 0;
   virtual bool isLoadableFileExtension( const std::string& filename ) = 0;
-  //virtual bool isLoadableFileFormat( file ) = 0;
+
+  // checks magic bytes of file, loaders without own signature return false
+  virtual bool isLoadableFileFormat( const std::string& filename ) { return false; }
 };
 
 
@@ -0,0 +1,634 @@
+// This file is part of openCaesar3.
+//
+// openCaesar3 is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// openCaesar3 is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with openCaesar3.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "astarclusters.hpp"
+#include "tilemap.hpp"
+#include "gfx/tile.hpp"
+#include "core/math.hpp"
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <queue>
+#include <functional>
+#include <cstdlib>
+
+namespace {
+// changes are tracked by blocks of terrain storage, cluster is one block
+static const int clusterSize = TerrainStorage::blockSize;
+
+// entrances longer than this value get transits at both ends instead of one in the middle
+static const int maxSingleTransitLength = 6;
+
+// first 4 offsets are orthogonal
+static const int neighbourOffsets[8][2] = { {-1, 0}, {1, 0}, {0, -1}, {0, 1},
+                                            {-1, -1}, {-1, 1}, {1, -1}, {1, 1} };
+}
+
+class AStarClusters::Impl
+{
+public:
+  typedef std::vector< int > Indexes;
+  typedef std::pair< int, int > QueueItem; // cost, key
+  typedef std::priority_queue< QueueItem, std::vector< QueueItem >, std::greater< QueueItem > > Queue;
+
+  struct Edge
+  {
+    int to;
+    int cost;
+  };
+
+  // pair of neighbour tiles on both sides of cluster border
+  struct Transit
+  {
+    int inner;  // tile in cluster which owns the border
+    int outer;  // tile in next cluster
+  };
+
+  typedef std::vector< Edge > Edges;
+  typedef std::map< int, Edges > Graph; // entrance tile index -> edges from it
+  typedef std::vector< Transit > Transits;
+
+  struct Rect
+  {
+    int minI, minJ, maxI, maxJ;
+
+    bool contains( int i, int j ) const { return i >= minI && i <= maxI && j >= minJ && j <= maxJ; }
+  };
+
+  // per query scratch data of abstract search, valid only while stamp equal current generation
+  struct Node
+  {
+    int score;
+    int parent;
+    unsigned int stamp;
+    bool closed;
+  };
+
+  // graph for one walkability class
+  struct Layer
+  {
+    std::vector< Transits > southBorders; // border between clusters (ci, cj) and (ci+1, cj)
+    std::vector< Transits > eastBorders;  // border between clusters (ci, cj) and (ci, cj+1)
+    std::vector< Graph > graphs;
+    std::set< int > dirty;
+  };
+
+  const Tilemap* tilemap;
+  unsigned int revision;  // revision of terrain, which graphs were checked against
+  std::vector< const Tile* > tiles;
+  int size;
+  int count;  // clusters on one side of tilemap
+  Layer layers[ classCount ];
+  Rect noArea;
+  std::vector< Node > nodes; // indexed by tile, two last items are start and goal points
+  unsigned int generation;
+
+  int getStartKey() const { return size * size; }
+  int getGoalKey() const { return size * size + 1; }
+
+  void nextGeneration()
+  {
+    generation++;
+    if( generation == 0 )
+    {
+      for( std::vector< Node >::iterator it=nodes.begin(); it != nodes.end(); it++ ) { it->stamp = 0; }
+      generation = 1;
+    }
+  }
+
+  Node& node( int key )
+  {
+    Node& n = nodes[ key ];
+    if( n.stamp != generation )
+    {
+      n.stamp = generation;
+      n.score = -1;
+      n.parent = -1;
+      n.closed = false;
+    }
+
+    return n;
+  }
+
+  int index( int i, int j ) const { return i * size + j; }
+  int getCluster( int i, int j ) const { return (i / clusterSize) * count + j / clusterSize; }
+  int getCluster( int index ) const { return getCluster( index / size, index % size ); }
+
+  Rect getBounds( int cluster ) const
+  {
+    Rect ret;
+    ret.minI = (cluster / count) * clusterSize;
+    ret.minJ = (cluster % count) * clusterSize;
+    ret.maxI = std::min( ret.minI + clusterSize, size ) - 1;
+    ret.maxJ = std::min( ret.minJ + clusterSize, size ) - 1;
+    return ret;
+  }
+
+  bool isWalkable( int idx, int wclass ) const
+  {
+    const Tile* tile = tiles[ idx ];
+    switch( wclass )
+    {
+    case land: return tile->isWalkable( true );
+    case road: return tile->isWalkable( false );
+    case water: return tile->getFlag( Tile::tlWater );
+    }
+
+    return false;
+  }
+
+  int getStepCost( int from, int to ) const
+  {
+    bool straight = ( from / size == to / size || from % size == to % size );
+    return (straight ? 10 : 14) + (tiles[ from ]->getFlag( Tile::tlRoad ) ? 0 : 50);
+  }
+
+  int getHScore( int from, int to ) const
+  {
+    return ( std::abs( from / size - to / size ) + std::abs( from % size - to % size ) ) * 10;
+  }
+
+  // marks clusters whose tiles were changed after last check
+  void collectChanges();
+  void buildBorder( Layer& layer, int wclass, int cluster, bool south );
+  void collectEntrances( const Layer& layer, int cluster, Indexes& oEntrances ) const;
+  void rebuildGraph( Layer& layer, int wclass, int cluster );
+  void sync( int wclass );
+
+  // local Dijkstra search limited by cluster bounds, oCosts has cost for every tile of cluster or -1.
+  // reverse search computes costs of ways from tiles to origin
+  void computeCosts( int cluster, int wclass, int origin, bool reverse,
+                     const Rect& area, Indexes& oCosts ) const;
+
+  int getLocalIndex( const Rect& bounds, int idx ) const
+  {
+    return ( idx / size - bounds.minI ) * clusterSize + ( idx % size - bounds.minJ );
+  }
+};
+
+AStarClusters::AStarClusters() : _d( new Impl )
+{
+  _d->tilemap = 0;
+  _d->revision = 0;
+  _d->size = 0;
+  _d->count = 0;
+  _d->generation = 0;
+  _d->noArea.minI = _d->noArea.minJ = 0;
+  _d->noArea.maxI = _d->noArea.maxJ = -1;
+}
+
+AStarClusters::~AStarClusters()
+{
+
+}
+
+int AStarClusters::getClusterSize() { return clusterSize; }
+
+void AStarClusters::init( const Tilemap& tilemap )
+{
+  _d->tilemap = &tilemap;
+  _d->revision = tilemap.getTerrain().getRevision();
+  _d->size = tilemap.getSize();
+  _d->count = (_d->size + clusterSize - 1) / clusterSize;
+
+  _d->tiles.resize( _d->size * _d->size );
+  for( int i=0; i < _d->size; i++ )
+  {
+    for( int j=0; j < _d->size; j++ )
+    {
+      _d->tiles[ _d->index( i, j ) ] = &tilemap.at( i, j );
+    }
+  }
+
+  Impl::Node empty;
+  empty.score = empty.parent = -1;
+  empty.stamp = 0;
+  empty.closed = false;
+  _d->nodes.assign( _d->size * _d->size + 2, empty );
+  _d->generation = 0;
+
+  int clustersCount = _d->count * _d->count;
+  for( int k=0; k < classCount; k++ )
+  {
+    Impl::Layer& layer = _d->layers[ k ];
+    layer.southBorders.assign( clustersCount, Impl::Transits() );
+    layer.eastBorders.assign( clustersCount, Impl::Transits() );
+    layer.graphs.assign( clustersCount, Impl::Graph() );
+    layer.dirty.clear();
+    for( int c=0; c < clustersCount; c++ )
+    {
+      layer.dirty.insert( c );
+    }
+  }
+}
+
+void AStarClusters::Impl::collectChanges()
+{
+  const TerrainStorage& terrain = tilemap->getTerrain();
+  if( terrain.getRevision() == revision )
+    return;
+
+  for( int ci=0; ci < count; ci++ )
+  {
+    for( int cj=0; cj < count; cj++ )
+    {
+      if( terrain.getBlockRevision( ci * clusterSize, cj * clusterSize ) > revision )
+      {
+        for( int k=0; k < classCount; k++ )
+        {
+          layers[ k ].dirty.insert( ci * count + cj );
+        }
+      }
+    }
+  }
+
+  revision = terrain.getRevision();
+}
+
+void AStarClusters::Impl::buildBorder( Layer& layer, int wclass, int cluster, bool south )
+{
+  Transits& transits = south ? layer.southBorders[ cluster ] : layer.eastBorders[ cluster ];
+  transits.clear();
+
+  Rect bounds = getBounds( cluster );
+  int length = south ? bounds.maxJ - bounds.minJ + 1 : bounds.maxI - bounds.minI + 1;
+  if( (south && bounds.maxI + 1 >= size) || (!south && bounds.maxJ + 1 >= size) )
+    return;
+
+  int runStart = -1;
+  for( int k=0; k <= length; k++ )
+  {
+    bool passable = false;
+    if( k < length )
+    {
+      int inner = south ? index( bounds.maxI, bounds.minJ + k ) : index( bounds.minI + k, bounds.maxJ );
+      int outer = south ? inner + size : inner + 1;
+      passable = isWalkable( inner, wclass ) && isWalkable( outer, wclass );
+    }
+
+    if( passable && runStart < 0 )
+    {
+      runStart = k;
+    }
+    else if( !passable && runStart >= 0 )
+    {
+      int runLength = k - runStart;
+      int positions[ 2 ] = { runStart + runLength / 2, -1 };
+      if( runLength > maxSingleTransitLength )
+      {
+        positions[ 0 ] = runStart;
+        positions[ 1 ] = k - 1;
+      }
+
+      for( int p=0; p < 2 && positions[ p ] >= 0; p++ )
+      {
+        Transit transit;
+        transit.inner = south ? index( bounds.maxI, bounds.minJ + positions[ p ] )
+                              : index( bounds.minI + positions[ p ], bounds.maxJ );
+        transit.outer = south ? transit.inner + size : transit.inner + 1;
+        transits.push_back( transit );
+      }
+
+      runStart = -1;
+    }
+  }
+}
+
+void AStarClusters::Impl::collectEntrances( const Layer& layer, int cluster, Indexes& oEntrances ) const
+{
+  oEntrances.clear();
+
+  int ci = cluster / count;
+  int cj = cluster % count;
+
+  const Transits* inner[ 2 ] = { &layer.southBorders[ cluster ], &layer.eastBorders[ cluster ] };
+  for( int k=0; k < 2; k++ )
+  {
+    for( Transits::const_iterator it=inner[ k ]->begin(); it != inner[ k ]->end(); it++ )
+    {
+      oEntrances.push_back( it->inner );
+    }
+  }
+
+  const Transits* outer[ 2 ] = { ci > 0 ? &layer.southBorders[ cluster - count ] : 0,
+                                 cj > 0 ? &layer.eastBorders[ cluster - 1 ] : 0 };
+  for( int k=0; k < 2; k++ )
+  {
+    if( !outer[ k ] )
+      continue;
+
+    for( Transits::const_iterator it=outer[ k ]->begin(); it != outer[ k ]->end(); it++ )
+    {
+      oEntrances.push_back( it->outer );
+    }
+  }
+
+  std::sort( oEntrances.begin(), oEntrances.end() );
+  oEntrances.erase( std::unique( oEntrances.begin(), oEntrances.end() ), oEntrances.end() );
+}
+
+void AStarClusters::Impl::computeCosts( int cluster, int wclass, int origin, bool reverse,
+                                        const Rect& area, Indexes& oCosts ) const
+{
+  Rect bounds = getBounds( cluster );
+  oCosts.assign( clusterSize * clusterSize, -1 );
+
+  Indexes done( clusterSize * clusterSize, 0 );
+  Queue queue;
+  oCosts[ getLocalIndex( bounds, origin ) ] = 0;
+  queue.push( QueueItem( 0, origin ) );
+
+  while( !queue.empty() )
+  {
+    QueueItem item = queue.top();
+    queue.pop();
+
+    int current = item.second;
+    int local = getLocalIndex( bounds, current );
+    if( done[ local ] )
+      continue;
+
+    done[ local ] = 1;
+
+    int ci = current / size;
+    int cj = current % size;
+    for( int k=0; k < 8; k++ )
+    {
+      int i = ci + neighbourOffsets[ k ][ 0 ];
+      int j = cj + neighbourOffsets[ k ][ 1 ];
+      if( !bounds.contains( i, j ) )
+        continue;
+
+      int next = index( i, j );
+      if( !area.contains( i, j ) && !isWalkable( next, wclass ) )
+        continue;
+
+      // if we are at a corner, both sides must be passable
+      if( k >= 4 )
+      {
+        if( !( area.contains( ci, j ) || isWalkable( index( ci, j ), wclass ) )
+            || !( area.contains( i, cj ) || isWalkable( index( i, cj ), wclass ) ) )
+        {
+          continue;
+        }
+      }
+
+      int nextLocal = getLocalIndex( bounds, next );
+      int cost = item.first + ( reverse ? getStepCost( next, current ) : getStepCost( current, next ) );
+      if( !done[ nextLocal ] && ( oCosts[ nextLocal ] < 0 || cost < oCosts[ nextLocal ] ) )
+      {
+        oCosts[ nextLocal ] = cost;
+        queue.push( QueueItem( cost, next ) );
+      }
+    }
+  }
+}
+
+void AStarClusters::Impl::rebuildGraph( Layer& layer, int wclass, int cluster )
+{
+  Graph& graph = layer.graphs[ cluster ];
+  graph.clear();
+
+  Indexes entrances;
+  collectEntrances( layer, cluster, entrances );
+
+  Rect bounds = getBounds( cluster );
+  Indexes costs;
+  for( Indexes::iterator it=entrances.begin(); it != entrances.end(); it++ )
+  {
+    Edges& edges = graph[ *it ];
+    computeCosts( cluster, wclass, *it, false, noArea, costs );
+
+    for( Indexes::iterator other=entrances.begin(); other != entrances.end(); other++ )
+    {
+      int cost = costs[ getLocalIndex( bounds, *other ) ];
+      if( *other != *it && cost >= 0 )
+      {
+        Edge edge = { *other, cost };
+        edges.push_back( edge );
+      }
+    }
+  }
+
+  // edges to next clusters
+  int ci = cluster / count;
+  int cj = cluster % count;
+  const Transits* inner[ 2 ] = { &layer.southBorders[ cluster ], &layer.eastBorders[ cluster ] };
+  const Transits* outer[ 2 ] = { ci > 0 ? &layer.southBorders[ cluster - count ] : 0,
+                                 cj > 0 ? &layer.eastBorders[ cluster - 1 ] : 0 };
+  for( int k=0; k < 2; k++ )
+  {
+    for( Transits::const_iterator it=inner[ k ]->begin(); it != inner[ k ]->end(); it++ )
+    {
+      Edge edge = { it->outer, getStepCost( it->inner, it->outer ) };
+      graph[ it->inner ].push_back( edge );
+    }
+
+    if( !outer[ k ] )
+      continue;
+
+    for( Transits::const_iterator it=outer[ k ]->begin(); it != outer[ k ]->end(); it++ )
+    {
+      Edge edge = { it->inner, getStepCost( it->outer, it->inner ) };
+      graph[ it->outer ].push_back( edge );
+    }
+  }
+}
+
+void AStarClusters::Impl::sync( int wclass )
+{
+  Layer& layer = layers[ wclass ];
+  if( layer.dirty.empty() )
+    return;
+
+  // borders of changed cluster are shared with neighbours, so their graphs also must be rebuilt
+  std::set< int > changed;
+  for( std::set< int >::iterator it=layer.dirty.begin(); it != layer.dirty.end(); it++ )
+  {
+    int cluster = *it;
+    int ci = cluster / count;
+    int cj = cluster % count;
+
+    buildBorder( layer, wclass, cluster, true );
+    buildBorder( layer, wclass, cluster, false );
+    if( ci > 0 ) { buildBorder( layer, wclass, cluster - count, true ); }
+    if( cj > 0 ) { buildBorder( layer, wclass, cluster - 1, false ); }
+
+    changed.insert( cluster );
+    if( ci > 0 ) { changed.insert( cluster - count ); }
+    if( ci < count - 1 ) { changed.insert( cluster + count ); }
+    if( cj > 0 ) { changed.insert( cluster - 1 ); }
+    if( cj < count - 1 ) { changed.insert( cluster + 1 ); }
+  }
+
+  for( std::set< int >::iterator it=changed.begin(); it != changed.end(); it++ )
+  {
+    rebuildGraph( layer, wclass, *it );
+  }
+
+  layer.dirty.clear();
+}
+
+AStarClusters::Result AStarClusters::findWay( const TilePos& startPos, const TilePos& stopPos,
+                                              const Size& arrivedArea, WalkClass wclass,
+                                              Waypoints& oWaypoints )
+{
+  oWaypoints.clear();
+
+  if( _d->count == 0 )
+    return undefined;
+
+  // loaded map of other size has new tiles, graphs are built again
+  if( _d->tilemap->getSize() != _d->size )
+  {
+    init( *_d->tilemap );
+  }
+
+  int start = _d->index( startPos.getI(), startPos.getJ() );
+  int stop = _d->index( stopPos.getI(), stopPos.getJ() );
+  int startCluster = _d->getCluster( start );
+  int stopCluster = _d->getCluster( stop );
+
+  if( startCluster == stopCluster )
+    return undefined;
+
+  _d->collectChanges();
+  _d->sync( wclass );
+
+  int lastIndex = _d->size - 1;
+  Impl::Rect area;
+  area.minI = math::clamp( stopPos.getI()-arrivedArea.getWidth(), 0, lastIndex );
+  area.minJ = math::clamp( stopPos.getJ()-arrivedArea.getHeight(), 0, lastIndex );
+  area.maxI = math::clamp( stopPos.getI()+arrivedArea.getWidth(), 0, lastIndex );
+  area.maxJ = math::clamp( stopPos.getJ()+arrivedArea.getHeight(), 0, lastIndex );
+
+  // tiles of destination area are walkable for this query only, so graph has no entrances
+  // through them and can't prove that way is absent when area lays on cluster border
+  Impl::Rect stopBounds = _d->getBounds( stopCluster );
+  bool areaInside = ( area.minI > stopBounds.minI || area.minI == 0 )
+                    && ( area.minJ > stopBounds.minJ || area.minJ == 0 )
+                    && ( area.maxI < stopBounds.maxI || area.maxI == lastIndex )
+                    && ( area.maxJ < stopBounds.maxJ || area.maxJ == lastIndex );
+
+  Impl::Layer& layer = _d->layers[ wclass ];
+  Impl::Rect startBounds = _d->getBounds( startCluster );
+
+  // start tile may be not walkable, for example it is a building. Entrances need walkable
+  // tiles on both sides, so graph misses ways which leave such tile right through cluster border
+  bool startInside = _d->isWalkable( start, wclass )
+                     || ( ( startPos.getI() > startBounds.minI || startPos.getI() == 0 )
+                          && ( startPos.getJ() > startBounds.minJ || startPos.getJ() == 0 )
+                          && ( startPos.getI() < startBounds.maxI || startPos.getI() == lastIndex )
+                          && ( startPos.getJ() < startBounds.maxJ || startPos.getJ() == lastIndex ) );
+
+  // temporary connections of start and stop points to entrances of their clusters
+  Impl::Indexes startCosts, stopCosts;
+  _d->computeCosts( startCluster, wclass, start, false, _d->noArea, startCosts );
+  _d->computeCosts( stopCluster, wclass, stop, true, area, stopCosts );
+
+  int startKey = _d->getStartKey();
+  int goalKey = _d->getGoalKey();
+  _d->nextGeneration();
+
+  Impl::Queue queue;
+  _d->node( startKey ).score = 0;
+  queue.push( Impl::QueueItem( _d->getHScore( start, stop ), startKey ) );
+
+  bool found = false;
+  Impl::Edges startEdges;
+  while( !queue.empty() )
+  {
+    int current = queue.top().second;
+    queue.pop();
+
+    if( current == goalKey )
+    {
+      found = true;
+      break;
+    }
+
+    Impl::Node& currentNode = _d->node( current );
+    if( currentNode.closed )
+      continue;
+
+    currentNode.closed = true;
+
+    const Impl::Edges* edges = 0;
+    Impl::Edge goalEdge = { goalKey, -1 };
+    if( current == startKey )
+    {
+      const Impl::Graph& graph = layer.graphs[ startCluster ];
+      for( Impl::Graph::const_iterator it=graph.begin(); it != graph.end(); it++ )
+      {
+        int cost = startCosts[ _d->getLocalIndex( startBounds, it->first ) ];
+        if( cost >= 0 )
+        {
+          Impl::Edge edge = { it->first, cost };
+          startEdges.push_back( edge );
+        }
+      }
+
+      edges = &startEdges;
+    }
+    else
+    {
+      int cluster = _d->getCluster( current );
+      const Impl::Graph& graph = layer.graphs[ cluster ];
+      Impl::Graph::const_iterator entrance = graph.find( current );
+      if( entrance != graph.end() )
+      {
+        edges = &entrance->second;
+      }
+
+      if( cluster == stopCluster )
+      {
+        goalEdge.cost = stopCosts[ _d->getLocalIndex( stopBounds, current ) ];
+      }
+    }
+
+    int currentScore = currentNode.score;
+    int edgesCount = edges ? (int)edges->size() : 0;
+    for( int k=0; k <= edgesCount; k++ )
+    {
+      const Impl::Edge& edge = k < edgesCount ? (*edges)[ k ] : goalEdge;
+      if( edge.cost < 0 )
+        continue;
+
+      Impl::Node& next = _d->node( edge.to );
+      int score = currentScore + edge.cost;
+      if( !next.closed && ( next.score < 0 || score < next.score ) )
+      {
+        next.score = score;
+        next.parent = current;
+        int h = edge.to == goalKey ? 0 : _d->getHScore( edge.to, stop );
+        queue.push( Impl::QueueItem( score + h, edge.to ) );
+      }
+    }
+  }
+
+  if( !found )
+  {
+    return ( areaInside && startInside ) ? noWay : undefined;
+  }
+
+  for( int key=_d->nodes[ goalKey ].parent; key != startKey; key=_d->nodes[ key ].parent )
+  {
+    oWaypoints.push_back( TilePos( key / _d->size, key % _d->size ) );
+  }
+
+  std::reverse( oWaypoints.begin(), oWaypoints.end() );
+  return wayFound;
+}
@@ -0,0 +1,60 @@
+// This file is part of openCaesar3.
+//
+// openCaesar3 is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// openCaesar3 is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with openCaesar3.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __OPENCAESAR3_ASTARCLUSTERS_H_INCLUDED__
+#define __OPENCAESAR3_ASTARCLUSTERS_H_INCLUDED__
+
+#include "core/scopedptr.hpp"
+#include "core/position.hpp"
+#include "core/size.hpp"
+
+#include <vector>
+
+class Tilemap;
+
+// Abstract graph for long queries of Pathfinder.
+// Tilemap is divided into square clusters, neighbour clusters are connected
+// by entrances on their common border, and entrances of one cluster
+// are connected with costs of local ways between them.
+// Every walkability class has own graph, clusters are rebuilt only
+// after their tiles were changed: cluster is a block of TerrainStorage,
+// so changes are found by revisions of blocks before every query.
+class AStarClusters
+{
+public:
+  typedef enum { land=0, road, water, classCount } WalkClass;
+  typedef enum { wayFound=0, noWay, undefined } Result;
+  typedef std::vector< TilePos > Waypoints;
+
+  AStarClusters();
+  ~AStarClusters();
+
+  void init( const Tilemap& tilemap );
+
+  // searches way on abstract graph, returns entrances which lay between start and stop.
+  // undefined means graph can't answer, for example when destination area crosses cluster border.
+  // noWay is exact: changed clusters are rebuilt before search, destination area lays inside its cluster
+  // and start tile is walkable or doesn't touch cluster border
+  Result findWay( const TilePos& start, const TilePos& stop, const Size& arrivedArea,
+                  WalkClass wclass, Waypoints& oWaypoints );
+
+  static int getClusterSize();
+
+private:
+  class Impl;
+  ScopedPtr< Impl > _d;
+};
+
+#endif //__OPENCAESAR3_ASTARCLUSTERS_H_INCLUDED__
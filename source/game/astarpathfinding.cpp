@@ -1,84 +1,267 @@
 #include "astarpathfinding.hpp"
 #include "tilemap.hpp"
 #include "core/position.hpp"
-#include "astarpoint.hpp"
+#include "gfx/tile.hpp"
 #include "path_finding.hpp"
 #include "core/stringhelper.hpp"
 #include "core/foreach.hpp"
 #include "core/logger.hpp"
+#include "astarclusters.hpp"
 
 using namespace std;
 
 class Pathfinder::Impl
 {
 public:
-  typedef map<AStarPoint*,AStarPoint::WalkableType> AspSavemap;
-  typedef vector< AStarPoint* > AspRow;
+  typedef enum { land=1, road=2, water=4, wtAll=0xf } WayType;
+  typedef enum { stNone=0, stOpened, stClosed } State;
 
-  class Grid : public vector< AspRow >
+  // per query scratch data, valid only while stamp equal current generation
+  struct Node
   {
-  public:
-    AStarPoint* operator[](const TilePos& pos )
+    int g, h, f;
+    int parent;
+    int heapIndex;
+    unsigned int stamp;
+    State state;
+  };
+
+  typedef vector< const Tile* > Tiles;
+  typedef vector< Node > Nodes;
+  typedef vector< int > Indexes;
+
+  Tilemap* tilemap;
+  int size;
+  Tiles tiles;     // row-major cache of tilemap cells
+  Nodes nodes;     // row-major scratch for A*, never cleared between queries
+  Indexes heap;    // binary heap of open node indexes, ordered by f score
+  Indexes route;   // scratch for path reconstruction
+  unsigned int generation;
+
+  // area around destination which always is walkable
+  int areaMinI, areaMinJ, areaMaxI, areaMaxJ;
+
+  AStarClusters clusters;
+
+  bool getTraversingPoints( const TilePos& start, const TilePos& stop, Pathway& oPathWay );
+
+  // runs A* over tiles, on success route contains way from stop to start
+  bool search( const TilePos& startPos, const TilePos& stopPos, const Size& arrivedArea, int pointFlags );
+  void appendRoute( Pathway& oPathWay ) const;
+
+  // joins local ways between waypoints found on cluster graph
+  bool refineWay( const TilePos& startPos, const TilePos& stopPos, const Size& arrivedArea, int pointFlags,
+                  const AStarClusters::Waypoints& waypoints, Pathway& oPathWay );
+
+  // short routes are cheaper to find over tiles directly
+  bool isLongRoute( const TilePos& start, const TilePos& stop ) const
+  {
+    int distance = std::max( abs( stop.getI() - start.getI() ), abs( stop.getJ() - start.getJ() ) );
+    return distance >= AStarClusters::getClusterSize() * 2;
+  }
+
+  AStarClusters::WalkClass getWalkClass( int pointFlags ) const
+  {
+    if( pointFlags == water ) { return AStarClusters::water; }
+    if( pointFlags == road ) { return AStarClusters::road; }
+
+    return AStarClusters::land;
+  }
+
+  int index( int i, int j ) const { return i * size + j; }
+
+  bool isValid( int i, int j ) const
+  {
+    return ( i >= 0 && j >= 0 && i < size && j < size );
+  }
+
+  bool isValid( const TilePos& pos ) const { return isValid( pos.getI(), pos.getJ() ); }
+
+  bool isTileWalkable( const Tile* tile, int wtype ) const
+  {
+    if( (wtype & land) != 0 || (wtype & road) != 0 )
+    {
+      return tile->isWalkable( (wtype & land) != 0 );
+    }
+    else if( (wtype & water) != 0 )
     {
-      return at( pos.getI() ).at( pos.getJ() );
+      return tile->getFlag( Tile::tlWater );
     }
 
-    AspRow& operator[]( unsigned int row )
+    return false;
+  }
+
+  bool isWalkable( const TilePos& pos, int wtype ) const
+  {
+    return isValid( pos ) && isTileWalkable( tiles[ index( pos.getI(), pos.getJ() ) ], wtype );
+  }
+
+  bool isWalkable( int i, int j, int wtype ) const
+  {
+    if( !isValid( i, j ) )
+      return false;
+
+    if( i >= areaMinI && i <= areaMaxI && j >= areaMinJ && j <= areaMaxJ )
+      return true;
+
+    return isTileWalkable( tiles[ index( i, j ) ], wtype );
+  }
+
+  void nextGeneration()
+  {
+    generation++;
+    if( generation == 0 )
     {
-      return at( row );
+      // counter overflow, stamps from old queries may collide with new ones
+      for( Nodes::iterator it=nodes.begin(); it != nodes.end(); it++ ) { it->stamp = 0; }
+      generation = 1;
     }
-  };
 
-  Grid grid;
-  Tilemap* tilemap;
+    heap.clear();
+  }
 
-  bool getTraversingPoints( const TilePos& start, const TilePos& stop, Pathway& oPathWay );
+  Node& node( int idx )
+  {
+    Node& n = nodes[ idx ];
+    if( n.stamp != generation )
+    {
+      n.stamp = generation;
+      n.state = stNone;
+      n.parent = -1;
+      n.heapIndex = -1;
+      n.g = n.h = n.f = 0;
+    }
+
+    return n;
+  }
+
+  State getState( int i, int j )
+  {
+    const Node& n = nodes[ index( i, j ) ];
+    return n.stamp == generation ? n.state : stNone;
+  }
+
+  bool isBetter( int a, int b ) const
+  {
+    const Node& na = nodes[ a ];
+    const Node& nb = nodes[ b ];
+    return na.f < nb.f || ( na.f == nb.f && na.h < nb.h );
+  }
 
-  AStarPoint* at( const TilePos& pos )
+  void heapSwap( int posA, int posB )
   {
-    if( isValid( pos ) )
+    std::swap( heap[ posA ], heap[ posB ] );
+    nodes[ heap[ posA ] ].heapIndex = posA;
+    nodes[ heap[ posB ] ].heapIndex = posB;
+  }
+
+  void siftUp( int pos )
+  {
+    while( pos > 0 )
     {
-      return grid[ pos ];
+      int parentPos = (pos - 1) / 2;
+      if( !isBetter( heap[ pos ], heap[ parentPos ] ) )
+        break;
+
+      heapSwap( pos, parentPos );
+      pos = parentPos;
     }
-    else
+  }
+
+  void siftDown( int pos )
+  {
+    int count = (int)heap.size();
+    while( true )
     {
-      Logger::warning( "ERROR: failed to gather point (%d,%d) on grid", pos.getI(), pos.getJ() );
-      return 0;
+      int best = pos;
+      int left = pos * 2 + 1;
+      int right = left + 1;
+
+      if( left < count && isBetter( heap[ left ], heap[ best ] ) ) { best = left; }
+      if( right < count && isBetter( heap[ right ], heap[ best ] ) ) { best = right; }
+
+      if( best == pos )
+        break;
+
+      heapSwap( pos, best );
+      pos = best;
     }
   }
 
-  bool isValid( const TilePos& pos )
+  void pushOpened( int idx )
+  {
+    Node& n = nodes[ idx ];
+    n.state = stOpened;
+    n.heapIndex = (int)heap.size();
+    heap.push_back( idx );
+    siftUp( n.heapIndex );
+  }
+
+  int popBest()
   {
-    return ( pos.getI() >= 0 && pos.getJ() >= 0 && pos.getI() < (int)grid.size() && pos.getJ() < (int)grid[pos.getI()].size() );
+    int ret = heap.front();
+    heapSwap( 0, (int)heap.size() - 1 );
+    heap.pop_back();
+    if( !heap.empty() )
+    {
+      siftDown( 0 );
+    }
+
+    nodes[ ret ].heapIndex = -1;
+    return ret;
   }
 
-  bool isWalkable( const TilePos& pos, int flags )
+  // g score of point which is reached from parent
+  int getGScore( int parentIdx, int i, int j ) const
   {
-    return ( isValid( pos ) && at( pos )->isWalkable( flags ) );
+    const Node& parent = nodes[ parentIdx ];
+    const Tile* parentTile = tiles[ parentIdx ];
+    int offset = parentTile->getFlag( Tile::tlRoad ) ? 0 : +50;
+    bool straight = ( parentTile->getI() == i || parentTile->getJ() == j );
+    return parent.g + (straight ? 10 : 14) + offset;
   }
 
-  void tunePoints( int flags );
+  int getHScore( int i, int j, const TilePos& stop ) const
+  {
+    return (abs( stop.getI() - i ) + abs( stop.getJ() - j )) * 10;
+  }
 };
 
 Pathfinder::Pathfinder() : _d( new Impl )
 {
+  _d->tilemap = 0;
+  _d->size = 0;
+  _d->generation = 0;
 }
 
 void Pathfinder::update( const Tilemap& tilemap )
 {
   _d->tilemap = const_cast< Tilemap* >( &tilemap );
+  _d->size = tilemap.getSize();
 
-  _d->grid.resize( tilemap.getSize() );
-  for( int k=0; k < tilemap.getSize(); k++)
+  int count = _d->size * _d->size;
+  _d->tiles.resize( count );
+  for( int i=0; i < _d->size; i++ )
   {
-    _d->grid[ k ].resize( tilemap.getSize());
+    for( int j=0; j < _d->size; j++ )
+    {
+      _d->tiles[ _d->index( i, j ) ] = &tilemap.at( i, j );
+    }
   }
 
-  TilemapTiles tiles = _d->tilemap->getArea( TilePos( 0, 0 ), Size( tilemap.getSize() ) );
-  foreach( Tile* tile, tiles )
-  {
-    _d->grid[ tile->getI() ][ tile->getJ() ] = new AStarPoint( tile );
-  }
+  Impl::Node empty;
+  empty.g = empty.h = empty.f = 0;
+  empty.parent = empty.heapIndex = -1;
+  empty.stamp = 0;
+  empty.state = Impl::stNone;
+
+  _d->nodes.assign( count, empty );
+  _d->generation = 0;
+  _d->heap.clear();
+  _d->heap.reserve( count );
+  _d->route.reserve( count );
+
+  _d->clusters.init( tilemap );
 }
 
 bool Pathfinder::getPath( const Tile& start, const Tile& stop, Pathway& oPathWay,
@@ -87,11 +270,11 @@ bool Pathfinder::getPath( const Tile& start, const Tile& stop, Pathway& oPathWay
   return getPath( start.getIJ(), stop.getIJ(), oPathWay, flags, arrivedArea );
 }
 
-bool Pathfinder::getPath( const TilePos& start, const TilePos& stop,  
+bool Pathfinder::getPath( const TilePos& start, const TilePos& stop,
                           Pathway& oPathWay, int flags,
                           const Size& arrivedArea )
 {
-  if( (flags & checkStart) && !_d->isWalkable( start, AStarPoint::wtAll ) )
+  if( (flags & checkStart) && !_d->isWalkable( start, Impl::wtAll ) )
       return false;
 
   if( flags & traversePath )
@@ -113,7 +296,7 @@ bool Pathfinder::Impl::getTraversingPoints( const TilePos& start, const TilePos&
   while( cPos != stop )
   {
     TilePos move( math::clamp( stop.getI() - cPos.getI(), -1, 1 ), math::clamp( stop.getJ() - cPos.getJ(), -1, 1 ) );
-    oPathway.setNextTile( *(at( cPos + move )->tile) );
+    oPathway.setNextTile( tilemap->at( cPos + move ) );
     cPos += move;
   }
 
@@ -122,154 +305,183 @@ bool Pathfinder::Impl::getTraversingPoints( const TilePos& start, const TilePos&
 
 unsigned int Pathfinder::getMaxLoopCount() const
 {
-  return 600;
-}
-
-void Pathfinder::Impl::tunePoints( int flags )
-{
-
+  // every node can be expanded once only, so a full map search always terminates
+  return _d->nodes.size();
 }
 
-bool Pathfinder::aStar( const TilePos& startPos, const TilePos& stopPos, 
+bool Pathfinder::aStar( const TilePos& startPos, const TilePos& stopPos,
                         const Size& arrivedArea, Pathway& oPathWay,
                         int flags )
 {
   oPathWay.init( *_d->tilemap, _d->tilemap->at( startPos ) );
 
-  int pointFlags = AStarPoint::wtAll;
-  if( (flags & roadOnly) > 0 ) { pointFlags = AStarPoint::road; }
-  else if( (flags & terrainOnly) > 0 ) { pointFlags = AStarPoint::road | AStarPoint::land; }
-  else if( (flags & waterOnly) > 0 ) { pointFlags = AStarPoint::water; }
+  if( !_d->isValid( startPos ) || !_d->isValid( stopPos ) )
+  {
+    Logger::warning( "ERROR: failed to find path from (%d,%d) to (%d,%d) outside grid",
+                     startPos.getI(), startPos.getJ(), stopPos.getI(), stopPos.getJ() );
+    return false;
+  }
 
-  // Define points to work with
-  AStarPoint* start = _d->at( startPos );
-  AStarPoint* end = _d->at( stopPos );
-  AStarPoint* current = NULL;
-  AStarPoint* child = NULL;
+  int pointFlags = Impl::wtAll;
+  if( (flags & roadOnly) > 0 ) { pointFlags = Impl::road; }
+  else if( (flags & terrainOnly) > 0 ) { pointFlags = Impl::road | Impl::land; }
+  else if( (flags & waterOnly) > 0 ) { pointFlags = Impl::water; }
 
-  // Define the open and the close list
-  list<AStarPoint*> openList;
-  list<AStarPoint*> closedList;
-  list<AStarPoint*>::iterator i;
+  if( _d->isLongRoute( startPos, stopPos ) )
+  {
+    AStarClusters::Waypoints waypoints;
+    AStarClusters::Result result = _d->clusters.findWay( startPos, stopPos, arrivedArea,
+                                                         _d->getWalkClass( pointFlags ), waypoints );
+    if( result == AStarClusters::wayFound
+        && _d->refineWay( startPos, stopPos, arrivedArea, pointFlags, waypoints, oPathWay ) )
+    {
+      return oPathWay.getLength() > 0;
+    }
 
-  int tSize = _d->tilemap->getSize();
-  Impl::AspSavemap saveArrivedArea;
+    // graph is synced with terrain before every query and destination area lays
+    // inside its cluster, so missing way on graph means missing way on tiles
+    if( result == AStarClusters::noWay )
+    {
+      return false;
+    }
 
-  TilePos arrivedAreaStart( math::clamp( stopPos.getI()-arrivedArea.getWidth(), 0, tSize ),
-                            math::clamp( stopPos.getJ()-arrivedArea.getHeight(), 0, tSize) );
+    // graph can't describe destination area, search goes over all tiles
+    oPathWay.init( *_d->tilemap, _d->tilemap->at( startPos ) );
+  }
 
-  TilePos arrivedAreaStop(  math::clamp( stopPos.getI()+arrivedArea.getWidth(), 0, tSize ),
-                            math::clamp( stopPos.getJ()+arrivedArea.getHeight(), 0, tSize) );
-  
-  for( int i=arrivedAreaStart.getI(); i <= arrivedAreaStop.getI(); i++ )
+  if( !_d->search( startPos, stopPos, arrivedArea, pointFlags ) )
   {
-    for( int j=arrivedAreaStart.getJ(); j <= arrivedAreaStop.getJ(); j++ )
-    {
-      AStarPoint* ap = _d->at( TilePos( i, j) );
-      if( ap )
-      {
-        saveArrivedArea[ ap ] = ap->priorWalkable;
-        ap->priorWalkable = AStarPoint::alwaysWalkable;
-      }
-    }
+    return false;
   }
 
-  unsigned int n = 0;
+  _d->appendRoute( oPathWay );
+  return oPathWay.getLength() > 0;
+}
+
+bool Pathfinder::Impl::refineWay( const TilePos& startPos, const TilePos& stopPos, const Size& arrivedArea,
+                                  int pointFlags, const AStarClusters::Waypoints& waypoints, Pathway& oPathWay )
+{
+  TilePos from = startPos;
+  for( AStarClusters::Waypoints::const_iterator it=waypoints.begin(); it != waypoints.end(); it++ )
+  {
+    if( !search( from, *it, Size( 0 ), pointFlags ) )
+      return false;
+
+    appendRoute( oPathWay );
+    from = *it;
+  }
 
-  // Add the start point to the openList
-  openList.push_back( start );
-  start->opened = true;
+  if( !search( from, stopPos, arrivedArea, pointFlags ) )
+    return false;
 
-  while( n == 0 || (current != end && n < getMaxLoopCount() ))
+  appendRoute( oPathWay );
+  return true;
+}
+
+void Pathfinder::Impl::appendRoute( Pathway& oPathWay ) const
+{
+  for( Indexes::const_reverse_iterator it=route.rbegin(); it != route.rend(); it++ )
   {
-    // Look for the smallest F value in the openList and make it the current point
-    foreach( AStarPoint* point, openList)
-    {
-      if( point == openList.front() || point->getFScore() <= current->getFScore() )
-      {
-        current = point;
-      }
-    }
+    oPathWay.setNextTile( *tiles[ *it ] );
+  }
+}
+
+bool Pathfinder::Impl::search( const TilePos& startPos, const TilePos& stopPos,
+                               const Size& arrivedArea, int pointFlags )
+{
+  int lastIndex = size - 1;
+  areaMinI = math::clamp( stopPos.getI()-arrivedArea.getWidth(), 0, lastIndex );
+  areaMinJ = math::clamp( stopPos.getJ()-arrivedArea.getHeight(), 0, lastIndex );
+  areaMaxI = math::clamp( stopPos.getI()+arrivedArea.getWidth(), 0, lastIndex );
+  areaMaxJ = math::clamp( stopPos.getJ()+arrivedArea.getHeight(), 0, lastIndex );
+
+  nextGeneration();
+
+  int start = index( startPos.getI(), startPos.getJ() );
+  int end = index( stopPos.getI(), stopPos.getJ() );
+
+  Node& startNode = node( start );
+  startNode.h = getHScore( startPos.getI(), startPos.getJ(), stopPos );
+  startNode.f = startNode.h;
+  pushOpened( start );
+
+  unsigned int maxLoopCount = nodes.size();
+  unsigned int n = 0;
+  bool found = false;
 
-    // Stop if we reached the end
-    if( current == end ) 
+  while( !heap.empty() && n < maxLoopCount )
+  {
+    // take the point with smallest F value
+    int current = popBest();
+
+    // stop if we reached the end
+    if( current == end )
     {
+      found = true;
       break;
     }
 
-    // Remove the current point from the openList
-    openList.remove(current);
-    current->opened = false;
+    nodes[ current ].state = stClosed;
 
-    // Add the current point to the closedList
-    closedList.push_back(current);
-    current->closed = true;
+    int ci = current / size;
+    int cj = current % size;
 
-    // Get all current's adjacent walkable points
-    for (int x = -1; x < 2; x ++)
+    // get all current's adjacent walkable points
+    for( int x = -1; x < 2; x ++ )
     {
-      for (int y = -1; y < 2; y ++)
+      for( int y = -1; y < 2; y ++ )
       {
-        // If it's current point then pass
-        if (x == 0 && y == 0)
+        // if it's current point then pass
+        if( x == 0 && y == 0 )
         {
           continue;
         }
 
-        // Get this point
-        child = _d->at( current->getPos() + TilePos( x, y ) );
+        int i = ci + x;
+        int j = cj + y;
 
-        if( !child )
-        {
-          Logger::warning( "No child for parent is (%d,%d)", current->getPos().getI() + x, current->getPos().getJ() + y );
-          continue;
-        }
-        // If it's closed or not walkable then pass
-        if( child->closed || !child->isWalkable( pointFlags ) )
+        // if it's closed or not walkable then pass
+        if( !isWalkable( i, j, pointFlags ) || getState( i, j ) == stClosed )
         {
           continue;
         }
 
-        // If we are at a corner
-        if (x != 0 && y != 0)
+        // if we are at a corner, both sides must be passable
+        if( x != 0 && y != 0 )
         {
-          // if the next horizontal point is not walkable or in the closed list then pass
-          //AStarPoint* tmpPoint = getPoint( current->pos + TilePos( 0, y ) );
-          TilePos tmp = current->getPos() + TilePos( 0, y );
-          if( !_d->isWalkable( tmp, pointFlags ) || _d->at( tmp )->closed)
+          if( !isWalkable( ci, cj + y, pointFlags ) || getState( ci, cj + y ) == stClosed )
           {
             continue;
           }
 
-          tmp = current->getPos() + TilePos( x, 0 );
-          // if the next vertical point is not walkable or in the closed list then pass
-          if( !_d->isWalkable( tmp, pointFlags ) || _d->at( tmp )->closed)
+          if( !isWalkable( ci + x, cj, pointFlags ) || getState( ci + x, cj ) == stClosed )
           {
             continue;
           }
         }
 
-        // If it's already in the openList
-        if (child->opened)
+        int childIdx = index( i, j );
+        Node& child = node( childIdx );
+        int g = getGScore( current, i, j );
+
+        if( child.state == stOpened )
         {
-          // If it has a wroste g score than the one that pass through the current point
-          // then its path is improved when it's parent is the current point
-          if (child->getGScore() > child->getGScore(current))
+          // path to child through the current point is better, decrease its key
+          if( child.g > g )
           {
-            // Change its parent and g score
-            child->setParent(current);
-            child->computeScores(end);
+            child.parent = current;
+            child.g = g;
+            child.f = g + child.h;
+            siftUp( child.heapIndex );
           }
         }
         else
         {
-          // Add it to the openList with current point as parent
-          openList.push_back(child);
-          child->opened = true;
-
-          // Compute it's g, h and f score
-          child->setParent(current);
-          child->computeScores(end);
+          child.parent = current;
+          child.g = g;
+          child.h = getHScore( i, j, stopPos );
+          child.f = g + child.h;
+          pushOpened( childIdx );
         }
       }
     }
@@ -277,35 +489,19 @@ bool Pathfinder::aStar( const TilePos& startPos, const TilePos& stopPos,
     n++;
   }
 
-  // Reset
-  foreach( AStarPoint* point, openList) { point->opened = false; }
-
-  foreach( AStarPoint* point, closedList) { point->closed = false; }
-
-  foreach( Impl::AspSavemap::value_type point, saveArrivedArea )
-  {
-    point.first->priorWalkable = point.second;
-  }
-
-  if( n == getMaxLoopCount() )
+  route.clear();
+  if( !found )
   {
     return false;
   }
-  // Resolve the path starting from the end point
-  list<AStarPoint*> lPath;
-  while( current->hasParent() && current != start )
-  {
-    lPath.push_front( current );
-    current = current->getParent();
-    n++;
-  }
 
-  foreach( AStarPoint* pathPoint, lPath )
+  // resolve the path starting from the end point
+  for( int idx = end; idx != start && idx >= 0; idx = nodes[ idx ].parent )
   {
-    oPathWay.setNextTile( _d->tilemap->at( pathPoint->getPos() ) );
+    route.push_back( idx );
   }
 
-  return oPathWay.getLength() > 0;
+  return true;
 }
 
 Pathfinder& Pathfinder::getInstance()
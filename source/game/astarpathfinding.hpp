@@ -10,7 +10,6 @@
 class Tilemap;
 class TilePos;
 class Pathway;
-class AStarPoint;
 class Size;
 class Tile;
 
@@ -19,19 +18,19 @@ class Pathfinder
 public:
   typedef enum { noFlags=0x0, checkStart=0x1, checkStop=0x2, roadOnly=0x4, waterOnly=0x8,
                  terrainOnly=0x10, traversePath=0x20, everyWhere=0x80 } Flags;
-  static const AStarPoint invalidPoint;
   static Pathfinder& getInstance();
 
   void update( const Tilemap& tmap );
 
-  bool getPath( const TilePos& start, const TilePos& stop, 
+  bool getPath( const TilePos& start, const TilePos& stop,
                 Pathway& oPathWay, int flags,
                 const Size& arrivedArea );
 
-  bool getPath( const Tile& start, const Tile& stop, 
-                Pathway& oPathWay, int flags, 
+  bool getPath( const Tile& start, const Tile& stop,
+                Pathway& oPathWay, int flags,
                 const Size& arrivedArea );
-  
+
+  // max count of nodes which can be expanded by one query
   unsigned int getMaxLoopCount() const;
 
   ~Pathfinder();
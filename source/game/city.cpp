@@ -64,64 +64,135 @@
 #include "core/logger.hpp"
 #include "building/constants.hpp"
 #include "cityservice_disorder.hpp"
+#include "road_network.hpp"
+#include "tickscheduler.hpp"
+#include "settings.hpp"
+#include "core/threadpool.hpp"
 #include <set>
+#include <map>
 
 using namespace constants;
 
 typedef std::vector< CityServicePtr > CityServices;
 
+// Walkers of city by tiles. Grid is updated by walkers when they come to new tile,
+// so it doesn't need to be rebuilt every tick. Walkers outside of tilemap are kept
+// in separate cell to not lose them.
 class WGrid
 {
 public:
-  void resize( Size size )
+  WGrid() { resize( 0 ); }
+
+  void resize( int size )
   {
-    _grid.resize( size.getWidth() );
-    for( int i=0; i < size.getWidth(); i++ )
-    {
-      _grid[ i ].resize( size.getHeight() );
-    }
+    _size = size;
+    _cells.clear();
+    _cells.resize( size * size + 1 );
+    _counts.clear();
   }
 
-  void clear()
+  void append( WalkerPtr walker )
   {
-    foreach( Row& r, _grid )
+    Cell& cell = _cells[ _index( walker->getIJ() ) ];
+    cell.push_back( Item( walker, walker->getType() ) );
+    _counts[ walker->getType() ]++;
+  }
+
+  // returns false if walker wasn't found on pos
+  bool remove( WalkerPtr walker, const TilePos& pos )
+  {
+    Cell& cell = _cells[ _index( pos ) ];
+    for( Cell::iterator it=cell.begin(); it != cell.end(); it++ )
     {
-      foreach( WalkerList& cell, r)
+      if( it->walker == walker )
       {
-        cell.clear();
+        _counts[ it->type ]--;
+        cell.erase( it );
+        return true;
       }
     }
+
+    return false;
   }
 
-  void append( WalkerPtr& a )
+  void move( WalkerPtr walker, const TilePos& oldPos )
   {
-    const TilePos& pos = a->getIJ();
-    if( pos.getI() >= 0 && pos.getI() < (int)_grid.size()
-        && pos.getJ() >= 0 && pos.getJ() < (int)_grid.size() )
+    if( _index( oldPos ) != _index( walker->getIJ() ) && remove( walker, oldPos ) )
     {
-      _grid[ pos.getI() ][ pos.getJ() ].push_back( a );
+      append( walker );
     }
   }
 
-  const WalkerList& at( TilePos pos )
+  void fill( const TilePos& start, const TilePos& stop, walker::Type type, WalkerList& oList ) const
   {
-    if( pos.getI() >= 0 && pos.getI() < (int)_grid.size()
-        && pos.getJ() >= 0 && pos.getJ() < (int)_grid.size() )
+    int minI = std::max( 0, std::min( start.getI(), stop.getI() ) );
+    int minJ = std::max( 0, std::min( start.getJ(), stop.getJ() ) );
+    int maxI = std::min( _size-1, std::max( start.getI(), stop.getI() ) );
+    int maxJ = std::min( _size-1, std::max( start.getJ(), stop.getJ() ) );
+
+    for( int i=minI; i <= maxI; i++ )
     {
-      return _grid[ pos.getI() ][ pos.getJ() ];
+      for( int j=minJ; j <= maxJ; j++ )
+      {
+        const Cell& cell = _cells[ i * _size + j ];
+        for( Cell::const_iterator it=cell.begin(); it != cell.end(); it++ )
+        {
+          if( it->walker->getType() == type || type == walker::any )
+          {
+            oList.push_back( it->walker );
+          }
+        }
+      }
     }
-    else
+  }
+
+  int count( walker::Type type ) const
+  {
+    std::map< int, int >::const_iterator it = _counts.find( type );
+    return it != _counts.end() ? it->second : 0;
+  }
+
+private:
+  struct Item
+  {
+    Item( WalkerPtr w, int t ) : walker( w ), type( t ) {}
+
+    WalkerPtr walker;
+    int type;  // type walker had when was added, counts are kept by it
+  };
+
+  typedef std::vector< Item > Cell;
+
+  int _index( const TilePos& pos ) const
+  {
+    if( pos.getI() >= 0 && pos.getI() < _size
+        && pos.getJ() >= 0 && pos.getJ() < _size )
     {
-      Logger::warning( "WalkersGrid incorrect" );
-      static WalkerList invalidList;
-      return invalidList;
+      return pos.getI() * _size + pos.getJ();
     }
+
+    return _size * _size;
   }
 
-private:
-  typedef std::vector< WalkerList > Row;
-  typedef std::vector< Row > Grid;
-  Grid _grid;
+  int _size;
+  std::vector< Cell > _cells;
+  std::map< int, int > _counts;
+};
+
+// computes movement of walkers on worker threads, crossings of tiles found
+// by workers are applied by walkers' timeStep() in order of walkers list
+class WalkersStepTask : public ThreadPool::Task
+{
+public:
+  std::vector< Walker* > walkers;
+
+  virtual void exec( int begin, int end )
+  {
+    for( int k=begin; k < end; k++ )
+    {
+      walkers[ k ]->prepareWalk();
+    }
+  }
 };
 
 class City::Impl
@@ -137,14 +208,23 @@ public:
   TileOverlayList overlayList;
   WalkerList walkerList;
 
+  // overlays of every type and group, in the same order as in overlayList
+  typedef std::map< int, TileOverlayList > OverlayBuckets;
+  OverlayBuckets overlaysByType;
+  OverlayBuckets overlaysByGroup;
+
   //walkers fast access map !!!
   WGrid walkersGrid;
+  TickScheduler scheduler;  // periodic jobs of overlays and services
+  ScopedPtr< ThreadPool > workers;
+  WalkersStepTask walkersStep;
   //*********************** !!!
 
   CityServices services;
   bool needRecomputeAllRoads;
   BorderInfo borderInfo;
   Tilemap tilemap;
+  ScopedPtr< RoadNetwork > roadNetwork;
   TilePos cameraStart;
   Point location;
   CityBuildOptions buildOptions;
@@ -160,6 +240,14 @@ public:
   void calculatePopulation( CityPtr city );
   void beforeOverlayDestroyed(CityPtr city, TileOverlayPtr overlay );
 
+  void indexOverlay( TileOverlayPtr overlay );
+  void unindexOverlay( TileOverlayPtr overlay );
+  const TileOverlayList& getBucket( const OverlayBuckets& buckets, int key ) const;
+
+  // grid was resized, walkers must be placed to it again
+  void resetWalkersGrid();
+  void prepareWalkers();
+
 oc3_signals public:
   Signal1<int> onPopulationChangedSignal;
   Signal1<std::string> onWarningMessageSignal;
@@ -179,6 +267,7 @@ City::City() : _d( new Impl )
   _d->walkerIdCount = 0;
   _d->climate = C_CENTRAL;
   _d->lastMonthCount = GameDate::current().getMonth();
+  _d->roadNetwork.reset( new RoadNetwork( _d->tilemap ) );
 
   addService( CityServiceEmigrant::create( this ) );
   addService( CityServiceWorkersHire::create( this ) );
@@ -203,12 +292,7 @@ void City::timeStep( unsigned int time )
     monthStep( GameDate::current() );
   }
 
-  //update walkers access map
-  _d->walkersGrid.clear();
-  foreach( WalkerPtr walker, _d->walkerList )
-  {
-    _d->walkersGrid.append( walker );
-  }
+  _d->prepareWalkers();
 
   WalkerList::iterator walkerIt = _d->walkerList.begin();
   while (walkerIt != _d->walkerList.end())
@@ -221,6 +305,7 @@ void City::timeStep( unsigned int time )
       if( walker->isDeleted() )
       {
         // remove the walker from the walkers list  
+        _d->walkersGrid.remove( walker, walker->getIJ() );
         walkerIt = _d->walkerList.erase(walkerIt);       
       }
       else
@@ -238,7 +323,10 @@ void City::timeStep( unsigned int time )
   {
     try
     {   
-      (*overlayIt)->timeStep( time );
+      if( !(*overlayIt)->isDeleted() )
+      {
+        (*overlayIt)->timeStep( time );
+      }
 
       if( (*overlayIt)->isDeleted() )
       {
@@ -258,13 +346,14 @@ void City::timeStep( unsigned int time )
     }
   }
 
+  _d->scheduler.update( time );
+
   CityServices::iterator serviceIt=_d->services.begin();
   while( serviceIt != _d->services.end() )
   {
-    (*serviceIt)->update( time );
-
     if( (*serviceIt)->isDeleted() )
     {
+      _d->scheduler.remove( (*serviceIt).object() );
       (*serviceIt)->destroy();
 
       serviceIt = _d->services.erase(serviceIt);
@@ -334,23 +423,28 @@ WalkerList City::getWalkers(walker::Type type, TilePos startPos, TilePos stopPos
     stopPos = startPos;
   }
 
-  TilemapArea area = _d->tilemap.getArea( startPos, stopPos );
-  foreach( Tile* tile, area)
-  {
-    WalkerList current = _d->walkersGrid.at( tile->getIJ() );
-
-    foreach( WalkerPtr w, current )
-    {
-      if( w->getType() == type || type == walker::any )
-      {
-        ret.push_back( w );
-      }
-    }
-  }
+  _d->walkersGrid.fill( startPos, stopPos, type, ret );
 
   return ret;
 }
 
+const WalkerList& City::getWalkerList() const
+{
+  return _d->walkerList;
+}
+
+int City::getWalkersCount( walker::Type type ) const
+{
+  return type == walker::all
+           ? (int)_d->walkerList.size()
+           : _d->walkersGrid.count( type );
+}
+
+void City::updateWalkerPos( WalkerPtr walker, const TilePos& oldPos )
+{
+  _d->walkersGrid.move( walker, oldPos );
+}
+
 void City::setBorderInfo(const BorderInfo& info)
 {
   int size = getTilemap().getSize();
@@ -360,12 +454,15 @@ void City::setBorderInfo(const BorderInfo& info)
   _d->borderInfo.roadExit = info.roadExit.fit( start, stop );
   _d->borderInfo.boatEntry = info.boatEntry.fit( start, stop );
   _d->borderInfo.boatExit = info.boatExit.fit( start, stop );
-  _d->walkersGrid.resize( Size(size) );
+  _d->resetWalkersGrid();
 }
 
 TileOverlayList&  City::getOverlays()         { return _d->overlayList; }
+const TileOverlayList& City::getOverlaysByType( const TileOverlay::Type type ) const { return _d->getBucket( _d->overlaysByType, type ); }
+const TileOverlayList& City::getOverlaysByGroup( const TileOverlay::Group group ) const { return _d->getBucket( _d->overlaysByGroup, group ); }
 const BorderInfo& City::getBorderInfo() const { return _d->borderInfo; }
 Tilemap&          City::getTilemap()          { return _d->tilemap; }
+RoadNetwork&      City::getRoadNetwork()      { return *_d->roadNetwork; }
 ClimateType       City::getClimate() const    { return _d->climate;    }
 void              City::setClimate(const ClimateType climate) { _d->climate = climate; }
 CityFunds&        City::getFunds() const      {  return _d->funds;   }
@@ -409,6 +506,10 @@ void City::Impl::calculatePopulation( CityPtr city )
 
 void City::Impl::beforeOverlayDestroyed(CityPtr city, TileOverlayPtr overlay)
 {
+  tilemap.invalidate( overlay->getTilePos(), overlay->getSize() );
+  unindexOverlay( overlay );
+  scheduler.remove( overlay.object() );
+
   if( overlay.is<Construction>() )
   {
     CityHelper helper( city );
@@ -416,12 +517,83 @@ void City::Impl::beforeOverlayDestroyed(CityPtr city, TileOverlayPtr overlay)
   }
 }
 
+void City::Impl::prepareWalkers()
+{
+  walkersStep.walkers.clear();
+  foreach( WalkerPtr walker, walkerList )
+  {
+    walkersStep.walkers.push_back( walker.object() );
+  }
+
+  // few walkers are stepped faster than threads are woken,
+  // result doesn't depend on it: steps are computed from walkers' own state
+  const unsigned int minParallelWalkers = 256;
+  if( walkerList.size() < minParallelWalkers )
+  {
+    walkersStep.exec( 0, (int)walkersStep.walkers.size() );
+    return;
+  }
+
+  if( workers.isNull() )
+  {
+    int threadsCount = GameSettings::get( GameSettings::workerThreads ).toInt();
+    if( threadsCount < 0 )
+    {
+      threadsCount = ThreadPool::getCpuCount() - 1;
+    }
+
+    workers.reset( new ThreadPool( threadsCount ) );
+  }
+
+  workers->run( walkersStep, (int)walkersStep.walkers.size() );
+}
+
+void City::Impl::resetWalkersGrid()
+{
+  walkersGrid.resize( tilemap.getSize() );
+  foreach( WalkerPtr walker, walkerList )
+  {
+    walkersGrid.append( walker );
+  }
+}
+
+void City::Impl::indexOverlay( TileOverlayPtr overlay )
+{
+  TileOverlay::IndexPosition& position = overlay->indexPosition();
+  position.type = overlay->getType();
+  position.group = overlay->getClass();
+
+  TileOverlayList& byType = overlaysByType[ position.type ];
+  position.byType = byType.insert( byType.end(), overlay );
+
+  TileOverlayList& byGroup = overlaysByGroup[ position.group ];
+  position.byGroup = byGroup.insert( byGroup.end(), overlay );
+}
+
+void City::Impl::unindexOverlay( TileOverlayPtr overlay )
+{
+  // type may be changed after overlay was added, so lists are taken from position
+  TileOverlay::IndexPosition& position = overlay->indexPosition();
+  overlaysByType[ position.type ].erase( position.byType );
+  overlaysByGroup[ position.group ].erase( position.byGroup );
+}
+
+const TileOverlayList& City::Impl::getBucket( const OverlayBuckets& buckets, int key ) const
+{
+  static const TileOverlayList emptyList;
+
+  OverlayBuckets::const_iterator it = buckets.find( key );
+  return it != buckets.end() ? it->second : emptyList;
+}
+
 void City::save( VariantMap& stream) const
 {
-  VariantMap vm_tilemap;
-  _d->tilemap.save( vm_tilemap );
+  _d->tilemap.save( stream.createMap( "tilemap" ) );
+  saveState( stream );
+}
 
-  stream[ "tilemap" ] = vm_tilemap;
+void City::saveState( VariantMap& stream ) const
+{
   stream[ "roadEntry" ] = _d->borderInfo.roadEntry;
   stream[ "roadExit" ]  = _d->borderInfo.roadExit;
   stream[ "cameraStart" ] = _d->cameraStart;
@@ -433,28 +605,21 @@ void City::save( VariantMap& stream) const
   stream[ "name" ] = Variant( _d->name );
 
   // walkers
-  VariantMap vm_walkers;
+  VariantMap& vm_walkers = stream.createMap( "walkers" );
   int walkedId = 0;
   foreach( WalkerPtr walker, _d->walkerList )
   {
-    VariantMap vm_walker;
-    walker->save( vm_walker );
-    vm_walkers[ StringHelper::format( 0xff, "%d", walkedId ) ] = vm_walker;
+    walker->save( vm_walkers.createMap( StringHelper::format( 0xff, "%d", walkedId ) ) );
     walkedId++;
   }
-  stream[ "walkers" ] = vm_walkers;
 
   // overlays
-  VariantMap vm_overlays;
+  VariantMap& vm_overlays = stream.createMap( "overlays" );
   foreach( TileOverlayPtr overlay, _d->overlayList )
   {
-    VariantMap vm_overlay;
-    overlay->save( vm_overlay );
-    vm_overlays[ StringHelper::format( 0xff, "%d,%d", overlay->getTile().getI(),
-                                                      overlay->getTile().getJ() ) ] = vm_overlay;
+    overlay->save( vm_overlays.createMap( StringHelper::format( 0xff, "%d,%d", overlay->getTile().getI(),
+                                                                               overlay->getTile().getJ() ) ) );
   }
-
-  stream[ "overlays" ] = vm_overlays;
 }
 
 void City::load( const VariantMap& stream )
@@ -472,7 +637,7 @@ void City::load( const VariantMap& stream )
   _d->cameraStart = TilePos( stream.get( "cameraStart" ).toTilePos() );
   _d->name = stream.get( "name" ).toString();
   _d->lastMonthCount = GameDate::current().getMonth();
-  _d->walkersGrid.resize( Size( _d->tilemap.getSize() ) );
+  _d->walkersGrid.resize( _d->tilemap.getSize() );
 
   VariantMap overlays = stream.get( "overlays" ).toMap();
   foreach( VariantMap::value_type& item, overlays )
@@ -488,7 +653,7 @@ void City::load( const VariantMap& stream )
     {
       overlay->build( this, pos );
       overlay->load( overlayParams );
-      _d->overlayList.push_back( overlay );
+      addOverlay( overlay );
     }
     else
     {
@@ -507,6 +672,7 @@ void City::load( const VariantMap& stream )
     {
       walker->load( walkerInfo );
       _d->walkerList.push_back( walker );
+      _d->walkersGrid.append( walker );
     }
     else
     {
@@ -515,7 +681,13 @@ void City::load( const VariantMap& stream )
   }
 }
 
-void City::addOverlay( TileOverlayPtr overlay ) { _d->overlayList.push_back( overlay ); }
+void City::addOverlay( TileOverlayPtr overlay )
+{
+  _d->overlayList.push_back( overlay );
+  _d->indexOverlay( overlay );
+  overlay->scheduleJobs( _d->scheduler );
+  _d->tilemap.invalidate( overlay->getTilePos(), overlay->getSize() );
+}
 
 City::~City(){}
 
@@ -523,13 +695,20 @@ void City::addWalker( WalkerPtr walker )
 {
   walker->setUniqueId( ++_d->walkerIdCount );
   _d->walkerList.push_back( walker );
+  _d->walkersGrid.append( walker );
 }
 
 
 void City::setCameraPos(const TilePos pos) { _d->cameraStart = pos; }
 TilePos City::getCameraPos() const {return _d->cameraStart; }
 
-void City::addService( CityServicePtr service ) {  _d->services.push_back( service ); }
+void City::addService( CityServicePtr service )
+{
+  _d->services.push_back( service );
+  // services were never guarded, their errors go further
+  _d->scheduler.add( service.object(), service->getPeriod(),
+                     makeDelegate( service.object(), &CityService::update ), false );
+}
 
 CityServicePtr City::findService( const std::string& name ) const
 {
@@ -558,10 +737,17 @@ Point City::getLocation() const {   return _d->location; }
 const GoodStore& City::getSells() const {   return _d->tradeOptions.getSells(); }
 const GoodStore& City::getBuys() const {   return _d->tradeOptions.getBuys(); }
 EmpirePtr City::getEmpire() const {   return _d->empire; }
-void City::updateRoads() {    _d->needRecomputeAllRoads = true; }
+void City::updateRoads()
+{
+  _d->needRecomputeAllRoads = true;
+}
 Signal1<int>& City::onPopulationChanged() {  return _d->onPopulationChangedSignal; }
 Signal1<int>& City::onFundsChanged() {  return _d->funds.onChange(); }
-void City::removeWalker( WalkerPtr walker ) { _d->walkerList.remove( walker ); }
+void City::removeWalker( WalkerPtr walker )
+{
+  _d->walkersGrid.remove( walker, walker->getIJ() );
+  _d->walkerList.remove( walker );
+}
 
 int City::getProsperity() const
 {
@@ -599,8 +785,8 @@ void CityHelper::updateDesirability( ConstructionPtr construction, bool onBuild
   int mul = ( onBuild ? 1 : -1);
 
   //change desirability in selfarea
-  TilemapArea area = tilemap.getArea( construction->getTilePos(), construction->getSize() );
-  foreach( Tile* tile, area )
+  for( TileRange tile=TileRange::area( tilemap, construction->getTilePos(), construction->getSize() );
+       tile.isValid(); tile.next() )
   {
     tile->appendDesirability( mul * dsrbl.base );
   }
@@ -609,9 +795,9 @@ void CityHelper::updateDesirability( ConstructionPtr construction, bool onBuild
   int current = mul * dsrbl.base;
   for( int curRange=1; curRange <= dsrbl.range; curRange++ )
   {
-    TilemapArea perimetr = tilemap.getRectangle( construction->getTilePos() - TilePos( curRange, curRange ),
-                                                 construction->getSize() + Size( 2 * curRange ) );
-    foreach( Tile* tile, perimetr )
+    for( TileRange tile=TileRange::perimeter( tilemap, construction->getTilePos() - TilePos( curRange, curRange ),
+                                              construction->getSize() + Size( 2 * curRange ) );
+         tile.isValid(); tile.next() )
     {
       tile->appendDesirability( current );
     }
@@ -38,6 +38,7 @@ class CityBuildOptions;
 class CityTradeOptions;
 class CityWinTargets;
 class CityFunds;
+class RoadNetwork;
 
 struct BorderInfo
 {
@@ -60,13 +61,21 @@ public:
 
   WalkerList getWalkers( constants::walker::Type type );
   WalkerList getWalkers( constants::walker::Type type, TilePos startPos, TilePos stopPos=TilePos( -1, -1 ) );
+  int getWalkersCount( constants::walker::Type type ) const;
+  // all walkers of city without copying, for per-frame iteration
+  const WalkerList& getWalkerList() const;
+  // walker calls it when comes to other tile, keeps walkers grid valid
+  void updateWalkerPos( WalkerPtr walker, const TilePos& oldPos );
   void addWalker( WalkerPtr walker );
   void removeWalker( WalkerPtr walker );
 
   void addService( CityServicePtr service );
   CityServicePtr findService( const std::string& name ) const;
 
+  // overlays must be added with addOverlay(), so indexes by type and group stay valid
   TileOverlayList& getOverlays();
+  const TileOverlayList& getOverlaysByType( const TileOverlay::Type type ) const;
+  const TileOverlayList& getOverlaysByGroup( const TileOverlay::Group group ) const;
 
   void setBorderInfo( const BorderInfo& info );
   const BorderInfo& getBorderInfo() const;
@@ -86,11 +95,14 @@ public:
   int getCulture() const;
 
   Tilemap& getTilemap();
+  RoadNetwork& getRoadNetwork();
 
   std::string getName() const; 
   void setName( const std::string& name );
 
   void save( VariantMap& stream) const;
+  // state of city without tilemap, background save packs tilemap itself from shared terrain
+  void saveState( VariantMap& stream ) const;
   void load( const VariantMap& stream);
 
   // add construction
@@ -140,11 +152,13 @@ public:
   std::list< SmartPtr< T > > find( const TileOverlay::Type type )
   {
     std::list< SmartPtr< T > > ret;
-    TileOverlayList& buildings = _city->getOverlays();
-    foreach( TileOverlayPtr item, buildings )
+    const TileOverlayList& buildings = ( type == constants::building::any
+                                           ? _city->getOverlays()
+                                           : _city->getOverlaysByType( type ) );
+    for( TileOverlayList::const_iterator it=buildings.begin(); it != buildings.end(); it++ )
     {
-      SmartPtr< T > b = item.as<T>();
-      if( b.isValid() && (b->getType() == type || type == constants::building::any ) )
+      SmartPtr< T > b = it->as<T>();
+      if( b.isValid() )
       {
         ret.push_back( b );
       }
@@ -157,11 +171,13 @@ public:
   std::list< SmartPtr< T > > find( constants::building::Group group )
   {
     std::list< SmartPtr< T > > ret;
-    TileOverlayList& buildings = _city->getOverlays();
-    foreach( TileOverlayPtr item, buildings )
+    const TileOverlayList& buildings = ( group == constants::building::anyGroup
+                                           ? _city->getOverlays()
+                                           : _city->getOverlaysByGroup( group ) );
+    for( TileOverlayList::const_iterator it=buildings.begin(); it != buildings.end(); it++ )
     {
-      SmartPtr< T > b = item.as<T>();
-      if( b.isValid() && (b->getClass() == group || group == constants::building::anyGroup ) )
+      SmartPtr< T > b = it->as<T>();
+      if( b.isValid() )
       {
         ret.push_back( b );
       }
@@ -26,16 +26,21 @@ public:
 
   virtual std::string getName() const { return _name; }
   virtual bool isDeleted() const { return false; }
+
+  // city calls update() once per period ticks
+  unsigned int getPeriod() const { return _period; }
   
   virtual void destroy() {}
 
 protected:
-  CityService( const std::string& name ) : _name( name )
+  CityService( const std::string& name, unsigned int period=1 )
+    : _name( name ), _period( period )
   {
   }
 
 protected:
   std::string _name;
+  unsigned int _period;
 };
 
 typedef SmartPtr<CityService> CityServicePtr;
@@ -42,9 +42,6 @@ CityServicePtr CityServiceAnimals::create(CityPtr city)
 
 void CityServiceAnimals::update(const unsigned int time)
 {
-  if( time % 16 != 1 )
-    return;
-
   if( _d->lastTimeUpdate.getMonth() != GameDate::current().getMonth() )
   {
     _d->lastTimeUpdate = GameDate::current();
@@ -63,8 +60,7 @@ void CityServiceAnimals::update(const unsigned int time)
       }
     }
 
-    WalkerList sheeps = _d->city->getWalkers( walker::sheep );
-    if( sheeps.size() < Impl::maxSheeps )
+    if( _d->city->getWalkersCount( walker::sheep ) < (int)Impl::maxSheeps )
     {
       WalkerPtr sheep = Sheep::create( _d->city );
       if( sheep.isValid() )
@@ -78,7 +74,7 @@ void CityServiceAnimals::update(const unsigned int time)
 }
 
 CityServiceAnimals::CityServiceAnimals()
-  : CityService( "animals" ), _d( new Impl )
+  : CityService( "animals", 16 ), _d( new Impl )
 {
 
 }
@@ -86,7 +86,7 @@ CityServicePtr CityServiceCulture::create( CityPtr city )
 }
 
 CityServiceCulture::CityServiceCulture( CityPtr city )
-  : CityService( getDefaultName() ), _d( new Impl )
+  : CityService( getDefaultName(), 44 ), _d( new Impl )
 {
   _d->city = city;
   _d->lastDate = GameDate::current();
@@ -95,9 +95,6 @@ CityServiceCulture::CityServiceCulture( CityPtr city )
 
 void CityServiceCulture::update( const unsigned int time )
 {
-  if( time % 44 != 1 )
-    return;
-
   if( _d->lastDate.getMonthToDate( GameDate::current() ) > 0 )
   {
     _d->lastDate = GameDate::current();
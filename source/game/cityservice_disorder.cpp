@@ -42,7 +42,7 @@ CityServicePtr CityServiceDisorder::create( CityPtr city )
 }
 
 CityServiceDisorder::CityServiceDisorder( CityPtr city )
-: CityService( "disorder" ), _d( new Impl )
+: CityService( "disorder", 22 ), _d( new Impl )
 {
   _d->city = city;
   _d->minCrimeLevel = defaultCrimeLevel;
@@ -50,13 +50,10 @@ CityServiceDisorder::CityServiceDisorder( CityPtr city )
 
 void CityServiceDisorder::update( const unsigned int time )
 {
-  if( time % 22 != 1 )
-    return;
-
   CityHelper helper( _d->city );
   HouseList houses = helper.find<House>( building::house );
 
-  WalkerList walkers = _d->city->getWalkers( walker::protestor );
+  int protestorsCount = _d->city->getWalkersCount( walker::protestor );
 
   HouseList criminalizedHouse;
   foreach( HousePtr house, houses )
@@ -68,7 +65,7 @@ void CityServiceDisorder::update( const unsigned int time )
     }
   }
 
-  if( criminalizedHouse.size() > walkers.size() )
+  if( (int)criminalizedHouse.size() > protestorsCount )
   {
     HouseList::iterator it = criminalizedHouse.begin();
     std::advance( it, rand() % criminalizedHouse.size() );
@@ -44,16 +44,13 @@ CityServicePtr CityServiceEmigrant::create( CityPtr city )
 }
 
 CityServiceEmigrant::CityServiceEmigrant( CityPtr city )
-: CityService( "emigration" ), _d( new Impl )
+: CityService( "emigration", 44 ), _d( new Impl )
 {
   _d->city = city;
 }
 
 void CityServiceEmigrant::update( const unsigned int time )
 {
-  if( time % 44 != 1 )
-    return;
-  
   unsigned int vacantPop=0;
   int emigrantsDesirability = 50; //base desirability value
   float emDesKoeff = math::clamp<float>( (float)GameSettings::get( GameSettings::emigrantSalaryKoeff ), 1.f, 99.f );
@@ -83,9 +80,9 @@ void CityServiceEmigrant::update( const unsigned int time )
     return;
   }
 
-  WalkerList walkers = _d->city->getWalkers( walker::emigrant );
+  unsigned int emigrantsCount = _d->city->getWalkersCount( walker::emigrant );
 
-  if( vacantPop <= walkers.size() * 5 )
+  if( vacantPop <= emigrantsCount * 5 )
   {
     return;
   }
@@ -62,7 +62,7 @@ void CityServiceFestival::assignFestival( RomeDivinityType name, int size )
 }
 
 CityServiceFestival::CityServiceFestival( CityPtr city )
-: CityService( getDefaultName() ), _d( new Impl )
+: CityService( getDefaultName(), 44 ), _d( new Impl )
 {
   _d->city = city;
   _d->lastFestivalDate = DateTime( -350, 0, 0 );
@@ -71,9 +71,6 @@ CityServiceFestival::CityServiceFestival( CityPtr city )
 
 void CityServiceFestival::update( const unsigned int time )
 {
-  if( time % 44 != 1 )
-    return;
-
   const DateTime current = GameDate::current();
   if( _d->festivalDate.getYear() == current.getYear()
       && _d->festivalDate.getMonth() == current.getMonth() )
@@ -41,7 +41,7 @@ CityServicePtr CityServiceFishPlace::create( CityPtr city )
 }
 
 CityServiceFishPlace::CityServiceFishPlace( CityPtr city )
-: CityService( "fishplace" ), _d( new Impl )
+: CityService( "fishplace", 44 ), _d( new Impl )
 {
   _d->city = city;
   _d->maxFishPlace = 1;
@@ -49,9 +49,6 @@ CityServiceFishPlace::CityServiceFishPlace( CityPtr city )
 
 void CityServiceFishPlace::update( const unsigned int time )
 {  
-  if( time % 44 != 1 )
-    return;
-
   if( _d->places.empty() )
   {
     CityHelper helper( _d->city );
@@ -58,7 +58,7 @@ CityServicePtr CityServiceInfo::create( CityPtr city )
 }
 
 CityServiceInfo::CityServiceInfo( CityPtr city )
-  : CityService( "info" ), _d( new Impl )
+  : CityService( "info", 44 ), _d( new Impl )
 {
   _d->city = city;
   _d->lastDate = GameDate::current();
@@ -67,9 +67,6 @@ CityServiceInfo::CityServiceInfo( CityPtr city )
 
 void CityServiceInfo::update( const unsigned int time )
 {
-  if( time % 44 != 1 )
-    return;
-
   if( GameDate::current().getMonth() != _d->lastDate.getMonth() )
   {
     _d->lastDate = GameDate::current();
@@ -53,7 +53,7 @@ CityServicePtr CityServiceProsperity::create( CityPtr city )
 }
 
 CityServiceProsperity::CityServiceProsperity( CityPtr city )
-  : CityService( getDefaultName() ), _d( new Impl )
+  : CityService( getDefaultName(), 44 ), _d( new Impl )
 {
   _d->city = city;
   _d->lastDate = GameDate::current();
@@ -70,9 +70,6 @@ CityServiceProsperity::CityServiceProsperity( CityPtr city )
 
 void CityServiceProsperity::update( const unsigned int time )
 {
-  if( time % 44 != 1 )
-    return;
-
   if( abs( GameDate::current().getYear() - _d->lastDate.getYear() ) == 1 )
   {
     _d->lastDate = GameDate::current();
@@ -95,16 +95,16 @@ CityServiceRoads::~CityServiceRoads()
 void CityServiceRoads::Impl::updateRoadsAround(BuildingPtr building)
 {
   propagator->init( building.as<Construction>() );
-  Propagator::PathWayList pathWayList = propagator->getWays( maxDistance );
+  const Propagator::PathWayList& pathWayList = propagator->getWays( maxDistance );
 
   Tilemap& tmap = city->getTilemap();
 
-  foreach( Pathway& current, pathWayList )
+  for( Propagator::PathWayList::const_iterator it=pathWayList.begin(); it != pathWayList.end(); it++ )
   {
-    ConstTilemapTiles tiles = current.getAllTiles();
-    foreach( const Tile* tile, tiles )
+    const ConstTilemapTiles& tiles = it->getAllTiles();
+    for( ConstTilemapTiles::const_iterator tile=tiles.begin(); tile != tiles.end(); tile++ )
     {
-      Tile& currentTile = tmap.at( tile->getIJ() );
+      Tile& currentTile = tmap.at( (*tile)->getIJ() );
       RoadPtr road = currentTile.getOverlay().as<Road>();
       if( road.isValid() )
       {
@@ -25,7 +25,6 @@ class CityServiceShoreline::Impl
 {
 public:
   TilemapTiles slTiles;
-  int lastTimeUpdate;
   CityPtr city;
 
   void checkMap( CityPtr city );
@@ -33,15 +32,16 @@ public:
 
 void CityServiceShoreline::Impl::checkMap( CityPtr city )
 {
-  int mapSize = city->getTilemap().getSize();
-  TilemapTiles tiles = city->getTilemap().getArea( TilePos( 0, 0), Size( mapSize ) );
+  Tilemap& tilemap = city->getTilemap();
+  const TerrainStorage& terrain = tilemap.getTerrain();
+  int mapSize = tilemap.getSize();
 
-  foreach( Tile* tile, tiles )
+  for( int index=0; index < mapSize * mapSize; index++ )
   {
-    int imgId = tile->getOriginalImgId();
+    int imgId = terrain.getData().imgId[ index ];
     if( (imgId >= 372 && imgId <= 403) || (imgId>=414 && imgId<=418) )
     {
-      slTiles.push_back( tile );
+      slTiles.push_back( &tilemap.at( index / mapSize, index % mapSize ) );
     }
   }
 }
@@ -55,19 +55,13 @@ CityServicePtr CityServiceShoreline::create( CityPtr city )
 }
 
 CityServiceShoreline::CityServiceShoreline( CityPtr city )
-  : CityService( "shoreline" ), _d( new Impl )
+  : CityService( "shoreline", 50 ), _d( new Impl )
 {
   _d->city = city;
-  _d->lastTimeUpdate = 0;  
 }
 
 void CityServiceShoreline::update( const unsigned int time )
 {
-  if( (time - _d->lastTimeUpdate) < 50 )
-    return;
-
-  _d->lastTimeUpdate = time;
-
   if( _d->slTiles.empty() )
   {
     _d->checkMap( _d->city );
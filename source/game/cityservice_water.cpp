@@ -30,15 +30,12 @@ CityServicePtr CityServiceWater::create( CityPtr city )
 }
 
 CityServiceWater::CityServiceWater( CityPtr city )
-: CityService( "water" ), _d( new Impl )
+: CityService( "water", 22 ), _d( new Impl )
 {
   _d->city = city;
 }
 
 void CityServiceWater::update( const unsigned int time )
 {
-  if( time % 22 != 1 )
-    return;
-
   //unsigned int vacantPop=0;
 }
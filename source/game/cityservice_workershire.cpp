@@ -45,7 +45,7 @@ CityServicePtr CityServiceWorkersHire::create( CityPtr city )
 }
 
 CityServiceWorkersHire::CityServiceWorkersHire( CityPtr city )
-: CityService( "workershire" ), _d( new Impl )
+: CityService( "workershire", 22 ), _d( new Impl )
 {
   _d->city = city;
   _d->priorities[ 1 ] = building::prefecture;
@@ -116,9 +116,6 @@ void CityServiceWorkersHire::_hireByType(const TileOverlay::Type type )
 
 void CityServiceWorkersHire::update( const unsigned int time )
 {
-  if( time % 22 != 1 )
-    return;
-
   //unsigned int vacantPop=0;
 
   _d->hrInCity = _d->city->getWalkers( walker::recruter );
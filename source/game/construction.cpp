@@ -90,13 +90,13 @@ void Construction::computeAccessRoads()
   Tilemap& tilemap = _getCity()->getTilemap();
 
   int maxDst2road = getRoadAccessDistance();
-  TilemapTiles rect = tilemap.getRectangle( _getMasterTile()->getIJ() + TilePos( -maxDst2road, -maxDst2road ),
+  for( TileRange tile=TileRange::perimeter( tilemap, _getMasterTile()->getIJ() + TilePos( -maxDst2road, -maxDst2road ),
                                             getSize() + Size( 2 * maxDst2road ), !Tilemap::checkCorners );
-  foreach( Tile* tile, rect )
+       tile.isValid(); tile.next() )
   {
     if( tile->getFlag( Tile::tlRoad ) )
     {
-      _d->accessRoads.push_back( tile );
+      _d->accessRoads.push_back( &(*tile) );
     }
   }
 }
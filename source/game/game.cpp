@@ -46,6 +46,7 @@
 #include "core/saveadapter.hpp"
 #include "events/dispatcher.hpp"
 #include "core/logger.hpp"
+#include "core/threadpool.hpp"
 
 #include <libintl.h>
 #include <list>
@@ -54,6 +55,8 @@
   #undef main
 #endif
 
+static const char* autosaveFile = "autosave.oc3save";
+
 class Game::Impl
 {
 public:
@@ -70,14 +73,41 @@ public:
 
   float time, saveTime;
   float timeMultiplier;
+
+  GameSaver saver;
+  DateTime lastAutosave;
   
+  void autosave( const Game& game );
   void initLocale(const std::string & localePath);
   void initVideo();
-  void initPictures(const io::FilePath& resourcePath);
+  void initPictures(const io::FilePath& resourcePath, ScreenWait& screen);
   void initGuiEnvironment();
   void loadSettings(const io::FilePath& filename);
 };
 
+void Game::Impl::autosave( const Game& game )
+{
+  int interval = GameSettings::get( GameSettings::autosaveInterval ).toInt();
+  if( interval <= 0 )
+  {
+    return;
+  }
+
+  DateTime current = GameDate::current();
+  int months = ( current.getYear() - lastAutosave.getYear() ) * DateTime::monthInYear
+               + current.getMonth() - lastAutosave.getMonth();
+
+  if( months >= interval )
+  {
+    lastAutosave = current;
+
+    // same folder where load dialog looks for saves
+    io::FileDir savesDir( io::FileDir::getApplicationDir().addEndSlash().toString() + "saves/" );
+    savesDir.create();
+    saver.saveInBackground( savesDir.addEndSlash().toString() + autosaveFile, game );
+  }
+}
+
 void Game::Impl::initLocale(const std::string & localePath)
 {
   // init the internationalization library (gettext)
@@ -97,7 +127,14 @@ void Game::Impl::initLocale(const std::string & localePath)
 void Game::Impl::initVideo()
 {
   Logger::warning( "init graphic engine" );
-  engine = new GfxSdlEngine();
+  if( GameSettings::get( GameSettings::render ).toString() == "opengl" )
+  {
+    engine = new GfxGlEngine();
+  }
+  else
+  {
+    engine = new GfxSdlEngine();
+  }
    
   /* Typical resolutions:
    * 640 x 480; 800 x 600; 1024 x 768; 1400 x 1050; 1600 x 1200
@@ -124,6 +161,13 @@ void Game::mountArchives()
   fs.mountArchive( GameSettings::rcpath( "/pics/pics_wait.zip" ) );
   fs.mountArchive( GameSettings::rcpath( "/pics/pics.zip" ) );
   fs.mountArchive( GameSettings::rcpath( "/pics/pics_oc3.zip" ) );
+
+  // pictures decoded by picpacker, png files from archives are used for missing ones
+  io::FilePath packPath = GameSettings::rcpath( "/pics/pics.pack" );
+  if( packPath.isExist() )
+  {
+    PictureBank::instance().loadPack( packPath );
+  }
 }
 
 void Game::Impl::initGuiEnvironment()
@@ -141,8 +185,25 @@ void Game::Impl::loadSettings( const io::FilePath& filename )
   }
 }
 
-void Game::Impl::initPictures(const io::FilePath& resourcePath)
+void Game::Impl::initPictures(const io::FilePath& resourcePath, ScreenWait& screen)
 {
+  // decoding of walkers graphics takes most of start time, so it goes on all cpus,
+  // animations below take already decoded pictures from bank
+  {
+    int threadsCount = GameSettings::get( GameSettings::workerThreads ).toInt();
+    if( threadsCount < 0 )
+    {
+      threadsCount = ThreadPool::getCpuCount() - 1;
+    }
+
+    ThreadPool workers( threadsCount );
+    PictureBank& bank = PictureBank::instance();
+
+    CONNECT( &bank, onPreloadProgress(), &screen, ScreenWait::setProgress );
+    bank.preload( AnimationBank::getPictureNames(), workers );
+    bank.onPreloadProgress().disconnect( makeDelegate( &screen, &ScreenWait::setProgress ) );
+  }
+
   AnimationBank::loadCarts();
   AnimationBank::loadWalkers();
   
@@ -153,13 +214,6 @@ void Game::Impl::initPictures(const io::FilePath& resourcePath)
   PictureBank::instance().createResources();
 }
 
-void Game::setScreenWait()
-{
-   ScreenWait screen;
-   screen.initialize();
-   screen.update( *_d->engine );
-}
-
 void Game::setScreenMenu()
 {
   ScreenMenu screen( *this, *_d->engine );
@@ -219,6 +273,7 @@ void Game::setScreenGame()
 {
   ScreenGame screen( *this, *_d->engine );
   screen.initialize();
+  _d->lastAutosave = GameDate::current();
 
   while( !screen.isStopped() )
   {
@@ -233,6 +288,7 @@ void Game::setScreenGame()
         _d->empire->timeStep( _d->time );
 
         GameDate::timeStep( _d->time );
+        _d->autosave( *this );
 
         _d->saveTime += 1;
 
@@ -240,9 +296,12 @@ void Game::setScreenGame()
       }
     }
 
+    _d->saver.update( *this );
     events::Dispatcher::update( _d->time );
   }
 
+  _d->saver.finish( *this );
+
   switch( screen.getResult() )
   {
     case ScreenGame::mainMenu:
@@ -314,8 +373,7 @@ Game::~Game()
 
 void Game::save(std::string filename) const
 {
-  GameSaver saver;
-  saver.save( filename, *this );
+  _d->saver.saveInBackground( filename, *this );
 }
 
 void Game::load(std::string filename)
@@ -362,9 +420,12 @@ void Game::initialize()
   initSound();
   //SoundEngine::instance().play_music("resources/sound/drums.wav");
   mountArchives();  // init some quick pictures for screenWait
-  setScreenWait();
 
-  _d->initPictures( GameSettings::rcpath() );
+  ScreenWait screen;
+  screen.initialize();
+  screen.update( *_d->engine );
+
+  _d->initPictures( GameSettings::rcpath(), screen );
   NameGenerator::initialize( GameSettings::rcpath( GameSettings::ctNamesModel ) );
   HouseSpecHelper::getInstance().initialize( GameSettings::rcpath( GameSettings::houseModel ) );
   DivinePantheon::getInstance().initialize(  GameSettings::rcpath( GameSettings::pantheonModel ) );
@@ -45,7 +45,6 @@ public:
   void initSound();
   void mountArchives();
 
-  void setScreenWait();
   void setScreenMenu();
   void setScreenGame();
 
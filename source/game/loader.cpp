@@ -124,22 +124,36 @@ void GameLoader::Impl::initLoaders()
 
 bool GameLoader::load( const io::FilePath& filename, Game& game )
 {
-  // try to load file based on file extension
+  // try to load file based on magic bytes first, then on file extension
+  GameAbstractLoaderPtr loader;
+  foreach( GameAbstractLoaderPtr item, _d->loaders )
+  {
+    if( item->isLoadableFileFormat( filename.toString() ) )
+    {
+      loader = item;
+      break;
+    }
+  }
+
   Impl::LoaderIterator it = _d->loaders.begin();
-  for( ; it != _d->loaders.end(); ++it)
+  for( ; loader.isNull() && it != _d->loaders.end(); ++it)
+  {
+    if( (*it)->isLoadableFileExtension( filename.toString() ) )
+    {
+      loader = *it;
+    }
+  }
+
+  if( loader.isValid() )
   {
-    if( (*it)->isLoadableFileExtension( filename.toString() ) /*||
-        (*it)->isLoadableFileFormat(file) */ )
+    bool loadok = loader->load( filename.toString(), game );
+
+    if( loadok )
     {
-      bool loadok = (*it)->load( filename.toString(), game );
-      
-      if( loadok )
-      {
-        _d->finalize( game );
-      }
-
-      return loadok;
+      _d->finalize( game );
     }
+
+    return loadok;
   }
 
   return false; // failed to load
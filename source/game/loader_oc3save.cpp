@@ -52,3 +52,8 @@ bool GameLoaderOc3::isLoadableFileExtension( const std::string& filename )
 {
   return filename.substr( filename.size() - 8 ) == ".oc3save";
 }
+
+bool GameLoaderOc3::isLoadableFileFormat( const std::string& filename )
+{
+  return SaveAdapter::isBinary( filename );
+}
@@ -26,6 +26,7 @@ class GameLoaderOc3 : public GameAbstractLoader
 public:
   bool load(const std::string& filename, Game &game);
   bool isLoadableFileExtension( const std::string& filename );
+  bool isLoadableFileFormat( const std::string& filename );
 };
 
 #endif
@@ -25,21 +25,106 @@
 #include "gfx/tile.hpp"
 #include "core/variant.hpp"
 #include "building/building.hpp"
+#include "road_network.hpp"
 
 #include <iterator>
 
 class Propagator::Impl
 {
 public:
-  std::set<Pathway> activeBranches;
-  std::map<Tile*, Pathway> completedBranches;
+  typedef std::vector< int > Indexes;
+
   CityPtr city;
   Tile* origin;
   Tilemap* tilemap;
   bool allLands;  // true if can walk in all lands, false if limited to roads
   bool allDirections;  // true if can walk in all directions, false if limited to North/South/East/West
+
+  int size;
+  Indexes distance;  // distance from nearest origin tile, -1 if tile not reached yet
+  Indexes parent;    // previous tile on the shortest way, -1 for origin tiles
+  Indexes frontier;  // fifo of reached tiles, ordered by distance
+  Indexes origins;
+  unsigned int frontierHead;
+
+  // roads propagation is taken from city road network cache
+  RoadNetwork::DistanceFieldPtr field;
+  int reachedDistance;
+  PathWayList ways;  // result of last getWays() when it isn't cached by road network
+
+  bool isRoadNetworkMode() const { return !allLands && allDirections; }
+
+  int index( const TilePos& pos ) const { return pos.getI() * size + pos.getJ(); }
+  TilePos position( int idx ) const { return TilePos( idx / size, idx % size ); }
+
+  int distanceAt( int idx ) const
+  {
+    if( field.isValid() )
+    {
+      int ret = field->getDistance( idx );
+      return ret <= reachedDistance ? ret : -1;
+    }
+
+    return distance[ idx ];
+  }
+
+  int parentAt( int idx ) const
+  {
+    return field.isValid() ? field->getParent( idx ) : parent[ idx ];
+  }
+
+  int getDistance( const Tile* tile ) const
+  {
+    return tilemap->isInside( tile->getIJ() ) ? distanceAt( index( tile->getIJ() ) ) : -1;
+  }
+
+  bool hasActiveBranches() const
+  {
+    return field.isValid() ? field->getMaxDistance() > reachedDistance : frontierHead < frontier.size();
+  }
+
+  // nearest reached tile from list, or 0 if no one reached yet
+  const Tile* findNearest( const TilemapTiles& tiles ) const
+  {
+    const Tile* ret = 0;
+    int minDistance = -1;
+    for( TilemapTiles::const_iterator it=tiles.begin(); it != tiles.end(); it++ )
+    {
+      const Tile* tile = *it;
+      int tileDistance = getDistance( tile );
+      if( tileDistance >= 0 && (minDistance < 0 || tileDistance < minDistance) )
+      {
+        minDistance = tileDistance;
+        ret = tile;
+      }
+    }
+
+    return ret;
+  }
+
+  // restore the way from origin to destination by predecessors chain
+  Pathway buildPath( const Tile& destination ) const
+  {
+    Indexes chain;
+    for( int idx = index( destination.getIJ() ); idx >= 0; idx = parentAt( idx ) )
+    {
+      chain.push_back( idx );
+    }
+
+    Pathway ret;
+    ret.init( *tilemap, tilemap->at( position( chain.back() ) ) );
+    for( Indexes::reverse_iterator it=chain.rbegin()+1; it != chain.rend(); it++ )
+    {
+      ret.setNextTile( tilemap->at( position( *it ) ) );
+    }
+
+    return ret;
+  }
 };
 
+static const int neighbourOffsetsCount = 8;
+static const int neighbourOffsets[ neighbourOffsetsCount ][ 2 ] = { { 0, 1 }, { 1, 0 }, { 0, -1 }, { -1, 0 },
+                                                                   { -1, -1 }, { 1, -1 }, { -1, 1 }, { 1, 1 } };
 
 Propagator::Propagator( CityPtr city ) : _d( new Impl )
 {
@@ -47,6 +132,10 @@ Propagator::Propagator( CityPtr city ) : _d( new Impl )
    _d->tilemap = &city->getTilemap();
    _d->allLands = false;
    _d->allDirections = true;
+   _d->origin = 0;
+   _d->size = 0;
+   _d->frontierHead = 0;
+   _d->reachedDistance = 0;
 }
 
 void Propagator::setAllLands(const bool value)
@@ -83,150 +172,145 @@ void Propagator::init( Tile& origin )
 
 void Propagator::init( const TilemapTiles& origin)
 {
-  _d->activeBranches.clear();
-  _d->completedBranches.clear();
+  _d->size = _d->tilemap->getSize();
+  _d->frontier.clear();
+  _d->origins.clear();
+  _d->frontierHead = 0;
+  _d->reachedDistance = 0;
+  _d->field = RoadNetwork::DistanceFieldPtr();
 
-  // init propagation
   for( TilemapTiles::const_iterator it=origin.begin(); it != origin.end(); it++ )
   {
-    // std::cout << "Tile access " << tile.getI() << "," << tile.getJ() << std::endl;
     Tile* tile = *it;
-    Pathway pathWay;
-    pathWay.init(*_d->tilemap, *tile);
-    // init active branches
-    _d->activeBranches.insert(pathWay);
-    // init trivial completed branches
-    _d->completedBranches.insert( std::pair<Tile*, Pathway>( tile, pathWay ) );
+    if( _d->tilemap->isInside( tile->getIJ() ) )
+    {
+      _d->origins.push_back( _d->index( tile->getIJ() ) );
+    }
+  }
+
+  if( _d->isRoadNetworkMode() )
+  {
+    // roads are shared by all walkers, so propagation result can be reused
+    _d->field = _d->city->getRoadNetwork().getField( _d->origins );
+    _d->distance.clear();
+    _d->parent.clear();
+    return;
+  }
+
+  _d->distance.assign( _d->size * _d->size, -1 );
+  _d->parent.assign( _d->size * _d->size, -1 );
+
+  // init propagation
+  foreach( int idx, _d->origins )
+  {
+    if( _d->distance[ idx ] < 0 )
+    {
+      // trivial way to origin tile
+      _d->distance[ idx ] = 0;
+      _d->frontier.push_back( idx );
+    }
   }
 }
 
 void Propagator::propagate(const int maxDistance)
 {
-   int nbLoops = 0;  // to detect infinite loops
+  if( _d->field.isValid() )
+  {
+    // cached field is complete already, only extend visible range
+    _d->reachedDistance = std::max( _d->reachedDistance, maxDistance );
+    return;
+  }
 
-   std::set<Pathway>::iterator firstBranch;
+  int directionsCount = _d->allDirections ? neighbourOffsetsCount : 4;
 
-   // propagate on all tiles
-   while (!_d->activeBranches.empty())
-   {
-      // while there are active paths
-      if ((nbLoops++)>10000) THROW("Infinite loop detected during propagation");
+  // frontier is ordered by distance, so tiles are processed as a breadth-first wave
+  while( _d->hasActiveBranches() )
+  {
+    int current = _d->frontier[ _d->frontierHead ];
+    int currentDistance = _d->distance[ current ];
 
-      // get the shortest active path
-      firstBranch = _d->activeBranches.begin();
+    if( currentDistance + 1 > maxDistance )
+    {
+      // we processed all tiles within range. stop the propagation
+      break;
+    }
 
-      const Pathway &pathWay = *firstBranch;
-      const Tile& tile = pathWay.getDestination();
-      //std::cout << "Propagation from tile " << tile.getI() << ", " << tile.getJ() << std::endl;
+    _d->frontierHead++;
 
-      int tileLength = 1;
-      if (pathWay.getLength() + tileLength > maxDistance)
-      {
-         // we processed all paths within range. stop the propagation
-         //std::cout << "MaxDistance reached. stop propagation" << std::endl;
-         break;
-      }
+    TilePos pos = _d->position( current );
+    for( int k=0; k < directionsCount; k++ )
+    {
+      TilePos nextPos( pos.getI() + neighbourOffsets[ k ][ 0 ], pos.getJ() + neighbourOffsets[ k ][ 1 ] );
+      if( !_d->tilemap->isInside( nextPos ) )
+        continue;
+
+      int next = _d->index( nextPos );
+      if( _d->distance[ next ] >= 0 )
+        continue; // the tile has been processed already
 
-      // propagate to neighbour tiles
-      TilemapTiles accessTiles = _d->tilemap->getRectangle( tile.getIJ() + TilePos( -1,-1 ),
-                                                            tile.getIJ() + TilePos( 1, 1 ), _d->allDirections);
-      foreach( Tile* tile2, accessTiles )
+      if( _d->tilemap->at( nextPos ).isWalkable( _d->allLands ) )
       {
-         // for every neighbor tile
-         if( tile2->isWalkable(_d->allLands))
-         {
-            // std::cout << "Next tile: " << tile2.getI() << ", " << tile2.getJ() << std::endl;
-
-            if (_d->completedBranches.find( tile2 )==_d->completedBranches.end())
-            {
-               // the tile has not been processed yet
-               Pathway pathWay2(pathWay);
-               pathWay2.setNextTile( *tile2 );
-               _d->activeBranches.insert(pathWay2);
-               _d->completedBranches.insert(std::pair<Tile*, Pathway>( tile2, pathWay2));
-
-               // pathWay2.prettyPrint();
-               // std::cout << "distance at:" << tile2.getI() << "," << tile2.getJ() << " is:" << pathWay2.getLength() << std::endl;
-            }
-         }
+        _d->distance[ next ] = currentDistance + 1;
+        _d->parent[ next ] = current;
+        _d->frontier.push_back( next );
       }
-
-      // this path is no longer active
-      _d->activeBranches.erase(firstBranch);
-   }
+    }
+  }
 }
 
 bool Propagator::getPath( RoadPtr destination, Pathway &oPathWay)
 {
-   std::map<Tile*, Pathway>::iterator mapIt;
-   int distance = 30;
-   while (true)
-   {
-      propagate(distance);
-
-      mapIt = _d->completedBranches.find( &destination->getTile() );
-      if (mapIt != _d->completedBranches.end())
-      {
-         // found pathWay!
-         oPathWay = (*mapIt).second;
-         return true;
-      }
+  const Tile& tile = destination->getTile();
+  int distance = 30;
+  while (true)
+  {
+    propagate(distance);
 
-      // not found: try again
-      if (_d->activeBranches.empty())
-      {
-         // no need to continue, no more active branches!
-         return false;
-      }
+    if( _d->getDistance( &tile ) >= 0 )
+    {
+      // found pathWay!
+      oPathWay = _d->buildPath( tile );
+      return true;
+    }
+
+    // not found: try again
+    if( !_d->hasActiveBranches() )
+    {
+      // no need to continue, no more active branches!
+      return false;
+    }
 
-      distance = distance * 2;
-   }
+    distance = distance * 2;
+  }
 }
 
 
 bool Propagator::getPath( ConstructionPtr destination, Pathway &oPathWay)
 {
-   const TilemapTiles& destTiles = destination->getAccessRoads();
-   std::map<Tile*, Pathway>::iterator mapIt;
-   std::set<Pathway> destPath;  // paths to the destination building, ordered by distance
-   int distance = 30;
-   while (true)
-   {
-      propagate(distance);
-
-      // searches reached destTiles
-      for (TilemapTiles::const_iterator itTile= destTiles.begin(); itTile != destTiles.end(); ++itTile)
-      {
-        // for each destination tile
-        Tile &tile= **itTile;
-
-        // searches path to that given tile
-        mapIt = _d->completedBranches.find(&tile);
-
-        if (mapIt != _d->completedBranches.end())
-        {
-           // we found a path!
-           Pathway &path= (*mapIt).second;
-           destPath.insert(path);
-        }
-      }
+  const TilemapTiles& destTiles = destination->getAccessRoads();
+  int distance = 30;
+  while (true)
+  {
+    propagate(distance);
 
-      if (! destPath.empty())
-      {
-        // there is a path to that building
-        oPathWay = *destPath.begin();
-        return true;
-      }
+    // searches nearest reached destTile
+    const Tile* tile = _d->findNearest( destTiles );
+    if( tile != 0 )
+    {
+      // there is a path to that building
+      oPathWay = _d->buildPath( *tile );
+      return true;
+    }
 
-      // not found: try again
-      if (_d->activeBranches.empty())
-      {
-        // no need to continue, no more active branches!
-        return false;
-      }
+    // not found: try again
+    if( !_d->hasActiveBranches() )
+    {
+      // no need to continue, no more active branches!
+      return false;
+    }
 
-      distance = distance * 2;
-   }
+    distance = distance * 2;
+  }
 }
 
 Propagator::Routes Propagator::getRoutes(const TileOverlay::Type buildingType)
@@ -239,48 +323,53 @@ Propagator::Routes Propagator::getRoutes(const TileOverlay::Type buildingType)
   // for each destination building
   foreach( ConstructionPtr destination, constructionList )
   {
-    std::set<Pathway> destPath;  // paths to the current building, ordered by distance
+    const Tile* tile = _d->findNearest( destination->getAccessRoads() );
 
-    TilemapTiles destTiles = destination->getAccessRoads();
-    foreach( Tile* tile, destTiles )
-    {
-      // searches path to that given tile
-      std::map<Tile*, Pathway>::iterator pathWayIt= _d->completedBranches.find( tile );
-
-      if( pathWayIt != _d->completedBranches.end() )
-      {
-        // we found a path!!!
-        Pathway &path= (*pathWayIt).second;
-        destPath.insert(path);
-      }
-    }
-
-    if (!destPath.empty())
+    if( tile != 0 )
     {
       // there is a path to that destination
-      ret[ destination ] = *destPath.begin();
+      ret[ destination ] = _d->buildPath( *tile );
     }
   }
 
   return ret;
 }
 
-Propagator::PathWayList Propagator::getWays(const int maxDistance)
+const Propagator::PathWayList& Propagator::getWays(const int maxDistance)
 {
-  PathWayList oPathWayList;
+  PathWayList& oPathWayList = _d->ways;
+  oPathWayList.clear();
   int nbLoops = 0;  // to detect infinite loops
 
+  std::set<Pathway> activeBranches;
   std::set<Pathway>::iterator firstBranch;
 
+  if( _d->isRoadNetworkMode() )
+  {
+    const PathWayList* cached = _d->city->getRoadNetwork().findWays( _d->origins, maxDistance );
+    if( cached )
+    {
+      return *cached;
+    }
+  }
+
   std::set< Tile* > markTiles;
 
+  // every way starts as trivial branch on origin tile
+  foreach( int idx, _d->origins )
+  {
+    Pathway pathWay;
+    pathWay.init( *_d->tilemap, _d->tilemap->at( _d->position( idx ) ) );
+    activeBranches.insert( pathWay );
+  }
+
   // propagate all branches
-  while( !_d->activeBranches.empty() )
+  while( !activeBranches.empty() )
   {
     // while there are active branches
 
     // get an active branch
-    firstBranch = _d->activeBranches.begin();
+    firstBranch = activeBranches.begin();
 
     Pathway pathWay = *firstBranch;
 
@@ -293,14 +382,13 @@ Propagator::PathWayList Propagator::getWays(const int maxDistance)
        // std::cout << "Propagation from tile " << tile.getI() << ", " << tile.getJ() << std::endl;
 
        // propagate to neighbour tiles
-       TilemapTiles accessTiles = _d->tilemap->getRectangle( tile.getIJ() + TilePos( -1, -1 ),
-                                                             tile.getIJ() + TilePos( 1, 1 ), _d->allDirections);
-
-       // nextTiles = accessTiles - alreadyProcessedTiles
+       // nextTiles = neighbours - alreadyProcessedTiles
        TilemapTiles nextTiles;
-       foreach( Tile* tile2, accessTiles )
+       for( TileRange neighbour=TileRange::neighbours( *_d->tilemap, tile.getIJ(), _d->allDirections );
+            neighbour.isValid(); neighbour.next() )
        {
          // for every neighbour tile
+         Tile* tile2 = &(*neighbour);
          bool notResolved = (markTiles.find( tile2 ) == markTiles.end());
          if( tile2->isWalkable(_d->allLands) && !pathWay.contains( *tile2 ) && notResolved)
          {
@@ -333,7 +421,7 @@ Propagator::PathWayList Propagator::getWays(const int maxDistance)
              // std::cout << "cloned!" << std::endl;
              Pathway pathWay2(pathWay);
              pathWay2.setNextTile(tile2);
-             _d->activeBranches.insert(pathWay2);
+             activeBranches.insert(pathWay2);
           }
        }
 
@@ -344,7 +432,12 @@ Propagator::PathWayList Propagator::getWays(const int maxDistance)
     // pathWay.prettyPrint();
 
     // this branch is no longer active
-    _d->activeBranches.erase(firstBranch);
+    activeBranches.erase(firstBranch);
+  }
+
+  if( _d->isRoadNetworkMode() )
+  {
+    return _d->city->getRoadNetwork().storeWays( _d->origins, maxDistance, oPathWayList );
   }
 
   return oPathWayList;
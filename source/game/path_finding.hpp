@@ -52,8 +52,9 @@ public:
   void init(const ConstructionPtr origin);
   void propagate(const int maxDistance);
 
-  /** returns all paths starting at origin */
-  PathWayList getWays(const int maxDistance);
+  /** returns all paths starting at origin,
+  * list is valid until next call of getWays() or next request to city road network */
+  const PathWayList& getWays(const int maxDistance);
   Routes getRoutes(const TileOverlay::Type buildingType);
 
   /** finds the shortest path between origin and destination
@@ -257,6 +257,11 @@ ConstTilemapTiles& Pathway::getAllTiles()
   return _d->tileList;
 }
 
+const ConstTilemapTiles& Pathway::getAllTiles() const
+{
+  return _d->tileList;
+}
+
 void Pathway::prettyPrint() const
 {
   if (_origin == NULL)
@@ -49,6 +49,7 @@ public:
   void setNextTile( const Tile& tile);
   bool contains(Tile& tile);
   ConstTilemapTiles& getAllTiles();
+  const ConstTilemapTiles& getAllTiles() const;
 
   void prettyPrint() const;
   void toggleDirection();
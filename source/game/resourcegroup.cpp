@@ -48,3 +48,16 @@ const char* ResourceGroup::foodOverlay     = "land2a";
 const char* ResourceGroup::empirebits      = "empire_bits";
 const char* ResourceGroup::empirepnls      = "empire_panels";
 
+const char* ResourceGroup::getName( Id id )
+{
+  // built on first call, when names above are initialized
+  static const char* names[ idCount ] = {
+    panelBackground, menuMiddleIcons, land1a, land2a, land3a,
+    citizen1, citizen2, citizen3, citizen4, citizen5,
+    sprites, transport, utilitya, commerce, security,
+    waterbuildings, entertaiment, warehouse, housing, govt,
+    carts, empirebits, empirepnls
+  };
+
+  return ( id >= 0 && id < idCount ) ? names[ id ] : "";
+}
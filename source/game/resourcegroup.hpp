@@ -20,6 +20,25 @@
 class ResourceGroup
 {
 public:
+  // compile time identifiers of picture groups, Picture::load( ResourceGroup::Id, index )
+  // takes picture from table by index without building of resource name
+  typedef enum
+  {
+    idPaneling=0, idPanelWindows, idLand1a, idLand2a, idLand3a,
+    idCitizen1, idCitizen2, idCitizen3, idCitizen4, idCitizen5,
+    idSprites, idTransport, idUtilitya, idCommerce, idSecurity,
+    idWaterBuildings, idEntertainment, idWarehouse, idHousing, idGovt,
+    idCarts, idEmpireBits, idEmpirePanels,
+    idCount,
+
+    // same groups as names below have
+    idPanelBackground=idPaneling, idMenuMiddleIcons=idPanelWindows, idFestivalImg=idPanelWindows,
+    idLion=idCitizen3, idAnimals=idCitizen4, idBuildingEngineer=idTransport, idWharf=idTransport,
+    idAqueduct=idLand2a, idRoad=idLand2a, idWaterOverlay=idLand2a, idFoodOverlay=idLand2a
+  } Id;
+
+  static const char* getName( Id id );
+
   static const char* panelBackground;
   static const char* menuMiddleIcons;
   static const char* festivalimg;
@@ -0,0 +1,468 @@
+// This file is part of openCaesar3.
+//
+// openCaesar3 is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// openCaesar3 is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with openCaesar3.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "road_network.hpp"
+#include "tilemap.hpp"
+#include "gfx/tile.hpp"
+#include "core/position.hpp"
+#include "core/foreach.hpp"
+#include "core/logger.hpp"
+
+#include <map>
+#include <set>
+#include <algorithm>
+
+static const unsigned int maxCachedItems = 1024;
+static const int neighbourOffsetsCount = 8;
+static const int neighbourOffsets[ neighbourOffsetsCount ][ 2 ] = { { 0, 1 }, { 1, 0 }, { 0, -1 }, { -1, 0 },
+                                                                   { -1, -1 }, { 1, -1 }, { -1, 1 }, { 1, 1 } };
+
+class RoadNetwork::Impl
+{
+public:
+  typedef std::set< int > Components;
+  typedef std::map< int, Indexes > ComponentTiles;
+
+  struct FieldItem
+  {
+    DistanceFieldPtr field;
+    Components components;
+    unsigned int lastUse;
+  };
+
+  struct WaysItem
+  {
+    PathWayList ways;
+    Components components;
+    unsigned int lastUse;
+  };
+
+  typedef std::map< Indexes, FieldItem > Fields;
+  typedef std::pair< Indexes, int > WaysKey;
+  typedef std::map< WaysKey, WaysItem > Ways;
+
+  Tilemap* tilemap;
+  int size;
+  unsigned int revision;         // terrain revision when network was checked last time
+  int nextComponentId;
+  unsigned int useCounter;
+
+  std::vector< char > walkable;  // walkability of tiles when network was checked last time
+  Indexes component;             // component id for every tile, -1 for not walkable tiles
+  ComponentTiles componentTiles;
+  std::vector< char > touched;   // tiles near changed roads, filled while relabel only
+  Indexes distance;              // propagation scratch, -1 for every tile outside of propagation
+
+  Fields fields;
+  Ways ways;
+
+  int index( int i, int j ) const { return i * size + j; }
+  bool isInside( int i, int j ) const { return i >= 0 && j >= 0 && i < size && j < size; }
+
+  bool isRoad( int i, int j ) const { return tilemap->at( i, j ).isWalkable( false ); }
+
+  void sync();
+  void rebuild();
+  void relabel( const Indexes& changed );
+  void floodComponent( int seed, int id );
+  bool isTouched( const Indexes& origins, const Components& deps, const Components& affected ) const;
+  Indexes normalize( const Indexes& origins ) const;
+  DistanceFieldPtr computeField( const Indexes& origins, Components& deps );
+
+  template< class T >
+  void evictOldest( T& items )
+  {
+    if( items.size() <= maxCachedItems )
+      return;
+
+    typename T::iterator oldest = items.begin();
+    for( typename T::iterator it=items.begin(); it != items.end(); it++ )
+    {
+      if( it->second.lastUse < oldest->second.lastUse ) { oldest = it; }
+    }
+
+    items.erase( oldest );
+  }
+};
+
+const RoadNetwork::DistanceField::Item* RoadNetwork::DistanceField::_find( int index ) const
+{
+  int left = 0;
+  int right = (int)_items.size() - 1;
+  while( left <= right )
+  {
+    int middle = (left + right) / 2;
+    const Item& item = _items[ middle ];
+    if( item.index == index ) { return &item; }
+    else if( item.index < index ) { left = middle + 1; }
+    else { right = middle - 1; }
+  }
+
+  return 0;
+}
+
+int RoadNetwork::DistanceField::getDistance( int index ) const
+{
+  const Item* item = _find( index );
+  return item ? item->distance : -1;
+}
+
+int RoadNetwork::DistanceField::getParent( int index ) const
+{
+  const Item* item = _find( index );
+  return item ? item->parent : -1;
+}
+
+int RoadNetwork::DistanceField::getMaxDistance() const { return _maxDistance; }
+
+RoadNetwork::RoadNetwork( Tilemap& tilemap ) : _d( new Impl )
+{
+  _d->tilemap = &tilemap;
+  _d->size = 0;
+  _d->revision = 0;
+  _d->nextComponentId = 0;
+  _d->useCounter = 0;
+}
+
+RoadNetwork::~RoadNetwork()
+{
+
+}
+
+int RoadNetwork::getComponent( const TilePos& pos )
+{
+  _d->sync();
+  if( !_d->isInside( pos.getI(), pos.getJ() ) )
+    return -1;
+
+  return _d->component[ _d->index( pos.getI(), pos.getJ() ) ];
+}
+
+RoadNetwork::DistanceFieldPtr RoadNetwork::getField( const Indexes& origins )
+{
+  _d->sync();
+
+  Indexes key = _d->normalize( origins );
+  Impl::Fields::iterator it = _d->fields.find( key );
+  if( it != _d->fields.end() )
+  {
+    it->second.lastUse = ++_d->useCounter;
+    return it->second.field;
+  }
+
+  Impl::FieldItem& item = _d->fields[ key ];
+  item.field = _d->computeField( key, item.components );
+  item.lastUse = ++_d->useCounter;
+
+  DistanceFieldPtr ret = item.field;
+  _d->evictOldest( _d->fields );
+
+  return ret;
+}
+
+const RoadNetwork::PathWayList* RoadNetwork::findWays( const Indexes& origins, int maxDistance )
+{
+  _d->sync();
+
+  Impl::Ways::iterator it = _d->ways.find( Impl::WaysKey( _d->normalize( origins ), maxDistance ) );
+  if( it == _d->ways.end() )
+    return 0;
+
+  it->second.lastUse = ++_d->useCounter;
+  return &it->second.ways;
+}
+
+const RoadNetwork::PathWayList& RoadNetwork::storeWays( const Indexes& origins, int maxDistance, PathWayList& ways )
+{
+  _d->sync();
+
+  Impl::WaysItem& item = _d->ways[ Impl::WaysKey( _d->normalize( origins ), maxDistance ) ];
+  item.ways.swap( ways );
+  item.lastUse = ++_d->useCounter;
+  item.components.clear();
+
+  // stored copies are owned by cache, so their tiles are read without casts
+  for( PathWayList::iterator wayIt=item.ways.begin(); wayIt != item.ways.end(); wayIt++ )
+  {
+    ConstTilemapTiles& tiles = wayIt->getAllTiles();
+    foreach( const Tile* tile, tiles )
+    {
+      int id = _d->component[ _d->index( tile->getI(), tile->getJ() ) ];
+      if( id >= 0 ) { item.components.insert( id ); }
+    }
+  }
+
+  // evicted item is the oldest one, so just stored ways stay in cache
+  _d->evictOldest( _d->ways );
+
+  return item.ways;
+}
+
+void RoadNetwork::Impl::sync()
+{
+  if( size != tilemap->getSize() )
+  {
+    rebuild();
+    return;
+  }
+
+  const TerrainStorage& terrain = tilemap->getTerrain();
+  if( terrain.getRevision() == revision )
+    return;
+
+  // only blocks which were touched after last check can contain changed tiles
+  Indexes changed;
+  for( int bi=0; bi < size; bi += TerrainStorage::blockSize )
+  {
+    for( int bj=0; bj < size; bj += TerrainStorage::blockSize )
+    {
+      if( terrain.getBlockRevision( bi, bj ) <= revision )
+        continue;
+
+      int stopI = std::min( bi + TerrainStorage::blockSize, size );
+      int stopJ = std::min( bj + TerrainStorage::blockSize, size );
+      for( int i=bi; i < stopI; i++ )
+      {
+        for( int j=bj; j < stopJ; j++ )
+        {
+          int idx = index( i, j );
+          if( (walkable[ idx ] != 0) != isRoad( i, j ) )
+          {
+            changed.push_back( idx );
+          }
+        }
+      }
+    }
+  }
+
+  revision = terrain.getRevision();
+
+  if( !changed.empty() )
+  {
+    relabel( changed );
+  }
+}
+
+void RoadNetwork::Impl::rebuild()
+{
+  size = tilemap->getSize();
+  revision = tilemap->getTerrain().getRevision();
+
+  int count = size * size;
+  walkable.assign( count, 0 );
+  component.assign( count, -1 );
+  touched.assign( count, 0 );
+  distance.assign( count, -1 );
+  componentTiles.clear();
+  fields.clear();
+  ways.clear();
+
+  for( int i=0; i < size; i++ )
+  {
+    for( int j=0; j < size; j++ )
+    {
+      walkable[ index( i, j ) ] = isRoad( i, j ) ? 1 : 0;
+    }
+  }
+
+  for( int idx=0; idx < count; idx++ )
+  {
+    if( walkable[ idx ] && component[ idx ] < 0 )
+    {
+      floodComponent( idx, nextComponentId++ );
+    }
+  }
+}
+
+void RoadNetwork::Impl::relabel( const Indexes& changed )
+{
+  // components which contain changed tiles or touch them can be split or merged
+  Components affected;
+  Indexes touchedList;
+  for( Indexes::const_iterator it=changed.begin(); it != changed.end(); it++ )
+  {
+    int idx = *it;
+    int ci = idx / size;
+    int cj = idx % size;
+    for( int k=-1; k < neighbourOffsetsCount; k++ )
+    {
+      int i = ci + (k < 0 ? 0 : neighbourOffsets[ k ][ 0 ]);
+      int j = cj + (k < 0 ? 0 : neighbourOffsets[ k ][ 1 ]);
+      if( !isInside( i, j ) )
+        continue;
+
+      int nIdx = index( i, j );
+      if( !touched[ nIdx ] )
+      {
+        touched[ nIdx ] = 1;
+        touchedList.push_back( nIdx );
+      }
+
+      if( component[ nIdx ] >= 0 ) { affected.insert( component[ nIdx ] ); }
+    }
+  }
+
+  // drop cached data which depends on affected components
+  for( Fields::iterator it=fields.begin(); it != fields.end(); )
+  {
+    if( isTouched( it->first, it->second.components, affected ) ) { fields.erase( it++ ); }
+    else { ++it; }
+  }
+
+  for( Ways::iterator it=ways.begin(); it != ways.end(); )
+  {
+    if( isTouched( it->first.first, it->second.components, affected ) ) { ways.erase( it++ ); }
+    else { ++it; }
+  }
+
+  foreach( int idx, touchedList ) { touched[ idx ] = 0; }
+
+  // relabel tiles of affected components, other components keep their ids
+  Indexes seeds = changed;
+  foreach( int id, affected )
+  {
+    ComponentTiles::iterator compIt = componentTiles.find( id );
+    if( compIt == componentTiles.end() )
+      continue;
+
+    for( Indexes::iterator it=compIt->second.begin(); it != compIt->second.end(); it++ )
+    {
+      component[ *it ] = -1;
+      seeds.push_back( *it );
+    }
+
+    componentTiles.erase( compIt );
+  }
+
+  for( Indexes::const_iterator it=changed.begin(); it != changed.end(); it++ )
+  {
+    walkable[ *it ] = walkable[ *it ] ? 0 : 1;
+  }
+
+  foreach( int idx, seeds )
+  {
+    if( walkable[ idx ] && component[ idx ] < 0 )
+    {
+      floodComponent( idx, nextComponentId++ );
+    }
+  }
+}
+
+void RoadNetwork::Impl::floodComponent( int seed, int id )
+{
+  Indexes& tiles = componentTiles[ id ];
+  tiles.push_back( seed );
+  component[ seed ] = id;
+
+  for( unsigned int head=0; head < tiles.size(); head++ )
+  {
+    int ci = tiles[ head ] / size;
+    int cj = tiles[ head ] % size;
+    for( int k=0; k < neighbourOffsetsCount; k++ )
+    {
+      int i = ci + neighbourOffsets[ k ][ 0 ];
+      int j = cj + neighbourOffsets[ k ][ 1 ];
+      if( !isInside( i, j ) )
+        continue;
+
+      int idx = index( i, j );
+      if( walkable[ idx ] && component[ idx ] < 0 )
+      {
+        component[ idx ] = id;
+        tiles.push_back( idx );
+      }
+    }
+  }
+}
+
+bool RoadNetwork::Impl::isTouched( const Indexes& origins, const Components& deps, const Components& affected ) const
+{
+  for( Indexes::const_iterator it=origins.begin(); it != origins.end(); it++ )
+  {
+    if( touched[ *it ] ) { return true; }
+  }
+
+  for( Components::const_iterator it=deps.begin(); it != deps.end(); it++ )
+  {
+    if( affected.count( *it ) > 0 ) { return true; }
+  }
+
+  return false;
+}
+
+RoadNetwork::Indexes RoadNetwork::Impl::normalize( const Indexes& origins ) const
+{
+  Indexes ret = origins;
+  std::sort( ret.begin(), ret.end() );
+  ret.erase( std::unique( ret.begin(), ret.end() ), ret.end() );
+  return ret;
+}
+
+RoadNetwork::DistanceFieldPtr RoadNetwork::Impl::computeField( const Indexes& origins, Components& deps )
+{
+  DistanceField* field = new DistanceField();
+  DistanceFieldPtr ret( field );
+  ret->drop();
+
+  Indexes order;
+  Indexes parents;
+  for( Indexes::const_iterator it=origins.begin(); it != origins.end(); it++ )
+  {
+    distance[ *it ] = 0;
+    order.push_back( *it );
+    parents.push_back( -1 );
+  }
+
+  // breadth-first wave over road tiles, same as Propagator does
+  for( unsigned int head=0; head < order.size(); head++ )
+  {
+    int current = order[ head ];
+    int ci = current / size;
+    int cj = current % size;
+    for( int k=0; k < neighbourOffsetsCount; k++ )
+    {
+      int i = ci + neighbourOffsets[ k ][ 0 ];
+      int j = cj + neighbourOffsets[ k ][ 1 ];
+      if( !isInside( i, j ) )
+        continue;
+
+      int idx = index( i, j );
+      if( walkable[ idx ] && distance[ idx ] < 0 )
+      {
+        distance[ idx ] = distance[ current ] + 1;
+        order.push_back( idx );
+        parents.push_back( current );
+      }
+    }
+  }
+
+  field->_maxDistance = 0;
+  field->_items.resize( order.size() );
+  for( unsigned int k=0; k < order.size(); k++ )
+  {
+    DistanceField::Item& item = field->_items[ k ];
+    item.index = order[ k ];
+    item.distance = distance[ item.index ];
+    item.parent = parents[ k ];
+    field->_maxDistance = std::max( field->_maxDistance, item.distance );
+
+    if( component[ item.index ] >= 0 ) { deps.insert( component[ item.index ] ); }
+    distance[ item.index ] = -1;
+  }
+
+  std::sort( field->_items.begin(), field->_items.end() );
+
+  return ret;
+}
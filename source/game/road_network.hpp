@@ -0,0 +1,88 @@
+// This file is part of openCaesar3.
+//
+// openCaesar3 is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// openCaesar3 is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with openCaesar3.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __OPENCAESAR3_ROADNETWORK_H_INCLUDED__
+#define __OPENCAESAR3_ROADNETWORK_H_INCLUDED__
+
+#include "core/referencecounted.hpp"
+#include "core/smartptr.hpp"
+#include "core/scopedptr.hpp"
+#include "core/predefinitions.hpp"
+#include "pathway.hpp"
+
+#include <vector>
+#include <list>
+
+// Graph of city road tiles shared by all walkers.
+// Keeps connected components of roads and caches propagation results
+// by origin tiles, caches are dropped only for components which changed.
+// Changes are found by terrain block revisions, only touched blocks are rescanned
+class RoadNetwork
+{
+public:
+  typedef std::vector< int > Indexes;
+  typedef std::list< Pathway > PathWayList;
+
+  // distances from origin tiles to every reachable road tile
+  class DistanceField : public ReferenceCounted
+  {
+  public:
+    // returns distance to tile with index, or -1 if it is unreachable
+    int getDistance( int index ) const;
+
+    // returns previous tile index on the shortest way, or -1 for origin tiles
+    int getParent( int index ) const;
+    int getMaxDistance() const;
+
+  private:
+    friend class RoadNetwork;
+
+    struct Item
+    {
+      int index;
+      int distance;
+      int parent;
+
+      bool operator<( const Item& other ) const { return index < other.index; }
+    };
+
+    const Item* _find( int index ) const;
+
+    std::vector< Item > _items; // sorted by tile index
+    int _maxDistance;
+  };
+
+  typedef SmartPtr< DistanceField > DistanceFieldPtr;
+
+  RoadNetwork( Tilemap& tilemap );
+  ~RoadNetwork();
+
+  // returns component id of road tile, or -1 if tile is not walkable road
+  int getComponent( const TilePos& pos );
+
+  // tile indexes are i * tilemap size + j
+  DistanceFieldPtr getField( const Indexes& origins );
+
+  // returns cached ways or null, list stays valid until next request to network
+  const PathWayList* findWays( const Indexes& origins, int maxDistance );
+  // moves ways into cache, ways list is empty after call
+  const PathWayList& storeWays( const Indexes& origins, int maxDistance, PathWayList& ways );
+
+private:
+  class Impl;
+  ScopedPtr< Impl > _d;
+};
+
+#endif //__OPENCAESAR3_ROADNETWORK_H_INCLUDED__
@@ -23,28 +23,235 @@
 #include "city.hpp"
 #include "gamedate.hpp"
 #include "game.hpp"
+#include "events/event.hpp"
+#include "core/gettext.hpp"
+#include "core/logger.hpp"
+#include "core/time.hpp"
+#include "settings.hpp"
+#include "tilemap.hpp"
+#include "gfx/tile.hpp"
 
-void GameSaver::save(const io::FilePath& filename, const Game& game )
+#include <SDL_thread.h>
+#include <SDL_mutex.h>
+
+class GameSaver::Impl
+{
+public:
+  typedef enum { idle=0, working, finished } State;
+
+  // state of game at request time, worker encodes and writes it
+  struct Snapshot
+  {
+    VariantMap state;
+    TerrainArraysPtr terrain;  // tilemap is packed by worker from arrays shared with game
+    io::FilePath filename;
+    SaveAdapter::Format format;
+  };
+
+  SDL_Thread* thread;
+  SDL_mutex* mutex;
+  State state;
+  bool saveOk;
+
+  Snapshot current;
+
+  // save requested while worker was busy, latest request wins
+  bool hasPending;
+  Snapshot pending;
+
+  // tilemap is saved only when withTilemap is true, otherwise snapshot shares its terrain
+  static void collect( const Game& game, VariantMap& vm, bool withTilemap );
+  static SaveAdapter::Format getFormat();
+  // writes map without copying it into variant, map is left empty
+  static bool write( VariantMap& vm, const io::FilePath& filename, SaveAdapter::Format format );
+  static void take( const Game& game, const io::FilePath& filename, Snapshot& snapshot );
+  static int saveThread( void* data );
+  void start();
+  void wait();
+};
+
+void GameSaver::Impl::collect( const Game& game, VariantMap& vm, bool withTilemap )
 {
-  VariantMap vm;
   vm[ "version" ] = Variant( 1 );
 
-  VariantMap vm_scenario;
+  // nested maps are filled in place, state of game is visited once without copies
+  VariantMap& vm_scenario = vm.createMap( "scenario" );
   vm_scenario[ "date" ] = GameDate::current();
-  vm[ "scenario" ] = vm_scenario;
 
-  VariantMap vm_empire;
-  game.getEmpire()->save( vm_empire );
-  vm[ "empire" ] = vm_empire;
+  game.getEmpire()->save( vm.createMap( "empire" ) );
+  game.getPlayer()->save( vm.createMap( "player" ) );
+
+  VariantMap& vm_city = vm.createMap( "city" );
+  if( withTilemap )
+  {
+    game.getCity()->save( vm_city );
+  }
+  else
+  {
+    game.getCity()->saveState( vm_city );
+  }
+}
+
+SaveAdapter::Format GameSaver::Impl::getFormat()
+{
+  std::string format = GameSettings::get( GameSettings::saveFormat ).toString();
+  return format == "json" ? SaveAdapter::json : SaveAdapter::binary;
+}
+
+bool GameSaver::Impl::write( VariantMap& vm, const io::FilePath& filename, SaveAdapter::Format format )
+{
+  Variant data = Variant( VariantMap() );
+  static_cast< VariantMap* >( data.data() )->swap( vm );
+
+  return SaveAdapter::save( data, filename, format );
+}
+
+void GameSaver::Impl::take( const Game& game, const io::FilePath& filename, Snapshot& snapshot )
+{
+  unsigned int startTime = DateTime::getElapsedTime();
+
+  snapshot.state.clear();
+  collect( game, snapshot.state, false );
+  snapshot.terrain = game.getCity()->getTilemap().shareTerrain();
+  snapshot.filename = filename;
+  snapshot.format = getFormat();
+
+  Logger::warning( "GameSaver: state of game for %s taken in %d ms", filename.toString().c_str(),
+                   DateTime::getElapsedTime() - startTime );
+}
 
-  VariantMap plm;
-  game.getPlayer()->save( plm );
-  vm[ "player" ] = plm;
+int GameSaver::Impl::saveThread( void* data )
+{
+  Impl* d = (Impl*)data;
+  Snapshot& snapshot = d->current;
+
+  // snapshot isn't shared with game, so it is used without lock.
+  // Terrain arrays are only read here, game copies them before changing
+  VariantMap::iterator cityIt = snapshot.state.find( "city" );
+  if( cityIt != snapshot.state.end() )
+  {
+    VariantMap& vm_city = *static_cast< VariantMap* >( cityIt->second.data() );
+    Tilemap::save( *snapshot.terrain.object(), vm_city.createMap( "tilemap" ) );
+  }
+
+  bool ok = write( snapshot.state, snapshot.filename, snapshot.format );
+
+  SDL_LockMutex( d->mutex );
+  d->saveOk = ok;
+  d->state = finished;
+  SDL_UnlockMutex( d->mutex );
+
+  return 0;
+}
+
+void GameSaver::Impl::start()
+{
+  state = working;
+
+  thread = SDL_CreateThread( &Impl::saveThread, this );
+  if( !thread )
+  {
+    Logger::warning( "Can't create thread for saving, save %s now", current.filename.toString().c_str() );
+    saveThread( this );
+  }
+}
+
+void GameSaver::Impl::wait()
+{
+  if( thread )
+  {
+    SDL_WaitThread( thread, 0 );
+    thread = 0;
+  }
+}
+
+GameSaver::GameSaver() : _d( new Impl )
+{
+  _d->thread = 0;
+  _d->mutex = SDL_CreateMutex();
+  _d->state = Impl::idle;
+  _d->saveOk = false;
+  _d->hasPending = false;
+}
+
+GameSaver::~GameSaver()
+{
+  _d->wait();
+  SDL_DestroyMutex( _d->mutex );
+}
+
+void GameSaver::save(const io::FilePath& filename, const Game& game )
+{
+  VariantMap vm;
+  Impl::collect( game, vm, true );
+
+  Impl::write( vm, filename, Impl::getFormat() );
+}
+
+void GameSaver::saveInBackground( const io::FilePath& filename, const Game& game )
+{
+  update( game );
+
+  if( _d->thread )
+  {
+    // game isn't stopped for previous save, its state is taken now and written later
+    Impl::take( game, filename, _d->pending );
+    _d->hasPending = true;
+    return;
+  }
+
+  Impl::take( game, filename, _d->current );
+  _d->start();
+}
+
+void GameSaver::finish( const Game& game )
+{
+  while( _d->thread || _d->hasPending )
+  {
+    _d->wait();
+    update( game );
+  }
+}
+
+bool GameSaver::isBusy() const
+{
+  SDL_LockMutex( _d->mutex );
+  bool busy = (_d->state == Impl::working);
+  SDL_UnlockMutex( _d->mutex );
+
+  return busy;
+}
+
+void GameSaver::update( const Game& game )
+{
+  SDL_LockMutex( _d->mutex );
+  bool isFinished = (_d->state == Impl::finished);
+  bool ok = _d->saveOk;
+  if( isFinished )
+  {
+    _d->state = Impl::idle;
+  }
+  SDL_UnlockMutex( _d->mutex );
 
-  VariantMap vm_city;
-  game.getCity()->save( vm_city );
-  vm[ "city" ] = vm_city;
+  if( isFinished )
+  {
+    _d->wait();
+    // shared terrain is released in main thread, reference counter isn't atomic
+    _d->current.terrain = TerrainArraysPtr();
 
+    events::GameEventPtr e = events::WarningMessageEvent::create( ok ? _("##game_saved##") : _("##game_save_failed##") );
+    e->dispatch();
+  }
 
-  SaveAdapter::save( vm, filename );
+  if( !_d->thread && _d->hasPending )
+  {
+    _d->hasPending = false;
+    _d->current.state.swap( _d->pending.state );
+    _d->current.terrain = _d->pending.terrain;
+    _d->current.filename = _d->pending.filename;
+    _d->current.format = _d->pending.format;
+    _d->pending.state.clear();
+    _d->pending.terrain = TerrainArraysPtr();
+    _d->start();
+  }
 }
@@ -24,10 +24,36 @@
 
 class Game;
 
+// Saves game to file. Background save copies state of game at request time,
+// terrain arrays of tilemap are shared with game until it changes them.
+// Packing of tilemap, encoding, compression and writing of file go on worker
+// thread while game goes on. Results are reported through events dispatcher.
+// Saves are binary, json ones are written when GameSettings::saveFormat is "json"
 class GameSaver
 {
 public:
-   void save( const io::FilePath& filename, const Game& game );
+  GameSaver();
+  // waits for running background save, queued one is dropped
+  ~GameSaver();
+
+  void save( const io::FilePath& filename, const Game& game );
+
+  // game isn't blocked by running save, state for new one is taken now, it is queued
+  // and written by update() when worker is free. Only latest queued request is kept
+  void saveInBackground( const io::FilePath& filename, const Game& game );
+
+  bool isBusy() const;
+
+  // called by game loop, dispatches message when background save is finished
+  // and starts queued save
+  void update( const Game& game );
+
+  // waits for running and queued saves, called before game is left
+  void finish( const Game& game );
+
+private:
+  class Impl;
+  ScopedPtr< Impl > _d;
 };
 
 
@@ -21,16 +21,27 @@
 #include "gfx/engine.hpp"
 #include "core/exception.hpp"
 #include "gfx/picture.hpp"
+#include "core/color.hpp"
+#include "core/rectangle.hpp"
+
+namespace {
+  static const Size progressSize( 400, 8 );
+}
 
 class ScreenWait::Impl
 {
 public:
 	Picture bgPicture;
 	GfxEngine* engine;
+	PictureRef progressBg;
+	PictureRef progressBar;
+	Point progressPos;
+	int progress;  // width of filled part of bar
 };
 
 ScreenWait::ScreenWait() : _d( new Impl )
 {
+  _d->progress = 0;
 }
 
 ScreenWait::~ScreenWait() {}
@@ -44,6 +55,14 @@ void ScreenWait::initialize()
   // center the bgPicture on the screen
   Size s = (engine.getScreenSize() - _d->bgPicture.getSize()) / 2;
   _d->bgPicture.setOffset( s.getWidth(), -s.getHeight() );
+
+  _d->progressBg.reset( Picture::create( progressSize ) );
+  _d->progressBg->fill( NColor( 255, 32, 24, 16 ), Rect() );
+  _d->progressBar.reset( Picture::create( progressSize ) );
+  _d->progressBar->fill( NColor( 255, 200, 160, 80 ), Rect() );
+
+  _d->progressPos = Point( (engine.getScreenWidth() - progressSize.getWidth()) / 2,
+                           engine.getScreenHeight() - 4 * progressSize.getHeight() );
 }
 
 void ScreenWait::draw()
@@ -51,6 +70,19 @@ void ScreenWait::draw()
   GfxEngine& engine = GfxEngine::instance();
 
   engine.drawPicture( _d->bgPicture, 0, 0);
+
+  if( _d->progress > 0 )
+  {
+    Rect clip( _d->progressPos, Size( _d->progress, progressSize.getHeight() ) );
+    engine.drawPicture( *_d->progressBg, _d->progressPos );
+    engine.drawPicture( *_d->progressBar, _d->progressPos, &clip );
+  }
+}
+
+void ScreenWait::setProgress( int value, int maxValue )
+{
+  _d->progress = maxValue > 0 ? progressSize.getWidth() * value / maxValue : 0;
+  drawFrame( GfxEngine::instance() );
 }
 
 int ScreenWait::getResult() const
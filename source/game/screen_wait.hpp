@@ -7,7 +7,7 @@
 class GfxEngine;
 class GuiEnv;
 
-// displays a background image
+// displays a background image and progress of loading
 class ScreenWait: public Screen
 {
 public:
@@ -18,6 +18,9 @@ public:
 
     virtual void draw();
 
+    // redraws screen with the new state of progress bar
+    void setProgress( int value, int maxValue );
+
 protected:
 	int getResult() const;
 
@@ -28,6 +28,10 @@ const char* GameSettings::resolution = "resolution";
 const char* GameSettings::fullscreen = "fullscreen";
 const char* GameSettings::localeName = "en_US";
 const char* GameSettings::emigrantSalaryKoeff = "emigrantSalaryKoeff";
+const char* GameSettings::workerThreads = "workerThreads";
+const char* GameSettings::autosaveInterval = "autosaveInterval";
+const char* GameSettings::saveFormat = "saveFormat";
+const char* GameSettings::render = "render";
 
 class GameSettings::Impl
 {
@@ -56,6 +60,10 @@ GameSettings::GameSettings() : _d( new Impl )
   _d->options[ resolution ] = Size( 1024, 768 );
   _d->options[ fullscreen ] = false;
   _d->options[ emigrantSalaryKoeff ] = 2.f;
+  _d->options[ workerThreads ] = -1; // count of cpu cores minus one
+  _d->options[ autosaveInterval ] = 0; // months between autosaves, 0 disables them
+  _d->options[ saveFormat ] = Variant( std::string( "binary" ) ); // binary or json, json saves are readable, but bigger and slower
+  _d->options[ render ] = Variant( std::string( "sdl" ) ); // sdl or opengl
 }
 
 void GameSettings::set( const std::string& option, const Variant& value )
@@ -36,6 +36,10 @@ public:
   static const char* resolution;
   static const char* fullscreen;
   static const char* emigrantSalaryKoeff;
+  static const char* workerThreads;
+  static const char* autosaveInterval;
+  static const char* saveFormat;
+  static const char* render;
 
   static GameSettings& getInstance();
 
@@ -0,0 +1,209 @@
+// This file is part of openCaesar3.
+//
+// openCaesar3 is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// openCaesar3 is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with openCaesar3.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "tickscheduler.hpp"
+#include "core/logger.hpp"
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+namespace {
+
+struct Entry
+{
+  const void* owner;  // NULL when job was removed while scheduler was running
+  TickScheduler::Job job;
+  bool guarded;
+};
+
+typedef std::vector< Entry > Bucket;
+typedef std::vector< Bucket > Buckets;  // bucket per phase
+
+struct Slot
+{
+  unsigned int period;
+  unsigned int phase;
+};
+
+typedef std::vector< Slot > Slots;
+
+}
+
+class TickScheduler::Impl
+{
+public:
+  typedef std::map< unsigned int, Buckets > Timelines;  // by period
+  typedef std::map< const void*, Slots > Owners;
+
+  Timelines timelines;
+  Owners owners;
+  bool updating;
+  bool haveRemoved;
+
+  unsigned int findPhase( const Buckets& buckets ) const
+  {
+    unsigned int ret = 0;
+    for( unsigned int phase=1; phase < buckets.size(); phase++ )
+    {
+      if( buckets[ phase ].size() < buckets[ ret ].size() )
+      {
+        ret = phase;
+      }
+    }
+
+    return ret;
+  }
+
+  void compact()
+  {
+    for( Timelines::iterator t=timelines.begin(); t != timelines.end(); t++ )
+    {
+      for( Buckets::iterator b=t->second.begin(); b != t->second.end(); b++ )
+      {
+        Bucket::iterator it = b->begin();
+        while( it != b->end() )
+        {
+          if( it->owner == 0 ) { it = b->erase( it ); }
+          else { it++; }
+        }
+      }
+    }
+
+    haveRemoved = false;
+  }
+};
+
+TickScheduler::TickScheduler() : _d( new Impl )
+{
+  _d->updating = false;
+  _d->haveRemoved = false;
+}
+
+TickScheduler::~TickScheduler()
+{
+}
+
+void TickScheduler::add( const void* owner, unsigned int period, Job job, bool guarded )
+{
+  if( owner == 0 || job.empty() )
+  {
+    Logger::warning( "TickScheduler: can't add job without owner" );
+    return;
+  }
+
+  period = std::max( period, 1u );
+
+  Buckets& buckets = _d->timelines[ period ];
+  if( buckets.empty() )
+  {
+    buckets.resize( period );
+  }
+
+  Slot slot;
+  slot.period = period;
+  slot.phase = _d->findPhase( buckets );
+
+  Entry entry;
+  entry.owner = owner;
+  entry.job = job;
+  entry.guarded = guarded;
+  buckets[ slot.phase ].push_back( entry );
+
+  _d->owners[ owner ].push_back( slot );
+}
+
+void TickScheduler::remove( const void* owner )
+{
+  Impl::Owners::iterator ownerIt = _d->owners.find( owner );
+  if( ownerIt == _d->owners.end() )
+  {
+    return;
+  }
+
+  for( Slots::iterator slot=ownerIt->second.begin(); slot != ownerIt->second.end(); slot++ )
+  {
+    Bucket& bucket = _d->timelines[ slot->period ][ slot->phase ];
+    Bucket::iterator it = bucket.begin();
+    while( it != bucket.end() )
+    {
+      if( it->owner != owner )
+      {
+        it++;
+      }
+      else if( _d->updating )
+      {
+        // bucket may be walked now, entry is erased after update
+        it->owner = 0;
+        it->job.clear();
+        _d->haveRemoved = true;
+        it++;
+      }
+      else
+      {
+        it = bucket.erase( it );
+      }
+    }
+  }
+
+  _d->owners.erase( ownerIt );
+}
+
+void TickScheduler::clear()
+{
+  _d->timelines.clear();
+  _d->owners.clear();
+}
+
+void TickScheduler::update( unsigned int time )
+{
+  _d->updating = true;
+
+  for( Impl::Timelines::iterator t=_d->timelines.begin(); t != _d->timelines.end(); t++ )
+  {
+    Bucket& bucket = t->second[ time % t->first ];
+
+    // jobs can add new jobs to this bucket, so walk it by index
+    for( unsigned int i=0; i < bucket.size(); i++ )
+    {
+      if( bucket[ i ].owner == 0 )
+        continue;
+
+      Job job = bucket[ i ].job;
+      if( !bucket[ i ].guarded )
+      {
+        job( time );
+        continue;
+      }
+
+      const void* owner = bucket[ i ].owner;
+      try
+      {
+        job( time );
+      }
+      catch(...)
+      {
+        Logger::warning( "TickScheduler: job of %p with period %d failed", owner, t->first );
+      }
+    }
+  }
+
+  _d->updating = false;
+
+  if( _d->haveRemoved )
+  {
+    _d->compact();
+  }
+}
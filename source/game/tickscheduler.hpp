@@ -0,0 +1,49 @@
+// This file is part of openCaesar3.
+//
+// openCaesar3 is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// openCaesar3 is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with openCaesar3.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __OPENCAESAR3_TICKSCHEDULER_H_INCLUDED__
+#define __OPENCAESAR3_TICKSCHEDULER_H_INCLUDED__
+
+#include "core/scopedptr.hpp"
+#include "core/delegate.hpp"
+
+// Runs recurring jobs of city objects instead of "time % period" checks in every object.
+// Jobs with the same period are kept in buckets by phase, so a tick touches only
+// jobs which are due. Phase of new job is the least loaded bucket of its period,
+// so objects with the same period do their work on different ticks.
+class TickScheduler
+{
+public:
+  typedef Delegate1< unsigned int > Job;
+
+  TickScheduler();
+  ~TickScheduler();
+
+  // job is called once per period ticks, owner is the key to remove its jobs later.
+  // exceptions of guarded job are logged and skipped, like errors of overlays' timeStep,
+  // other ones go to caller of update()
+  void add( const void* owner, unsigned int period, Job job, bool guarded=true );
+  void remove( const void* owner );
+  void clear();
+
+  // calls jobs which are due on this tick
+  void update( unsigned int time );
+
+private:
+  class Impl;
+  ScopedPtr< Impl > _d;
+};
+
+#endif //__OPENCAESAR3_TICKSCHEDULER_H_INCLUDED__
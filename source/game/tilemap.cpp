@@ -26,21 +26,22 @@
 #include "core/foreach.hpp"
 #include "core/logger.hpp"
 
-static Tile invalidTile = Tile( TilePos( -1, -1 ) );
-typedef std::vector< Tile > Row;
+static Tile invalidTile( TilePos( -1, -1 ) );
 
-class TileGrid : public std::vector< Row >
-{
-};
-
-class Tilemap::Impl : public TileGrid
+class Tilemap::Impl
 {
 public:
+  typedef std::vector< Tile > Tiles;
+
+  Tiles tiles;             // row-major handles of tiles, their data is kept in arrays below
+  TerrainStorage terrain;  // row-major terrain and render arrays, shared by tiles
+  int size;
+
   Tile& at( const int i, const int j )
   {
     if( isInside( TilePos( i, j ) ) )
     {
-      return TileGrid::at(i).at(j);
+      return tiles[ i * size + j ];
     }
 
     Logger::warning( "Need inside point current=[%d, %d]", i, j );
@@ -52,24 +53,6 @@ public:
     return( pos.getI() >= 0 && pos.getJ()>=0 && pos.getI() < size && pos.getJ() < size);
   }
 
-  void resize( const int s )
-  {
-    size = s;
-
-    // resize the tile array
-    TileGrid::resize( size );
-    for( int i = 0; i < size; ++i )
-    {
-      TileGrid::at( i ).reserve( size );
-
-      for (int j = 0; j < size; ++j)
-      {
-        TileGrid::at( i ).push_back( Tile( TilePos( i, j ) ));
-      }
-    }
-  }
-
-  int size;
 };
 
 Tilemap::Tilemap() : _d( new Impl )
@@ -79,7 +62,20 @@ Tilemap::Tilemap() : _d( new Impl )
 
 void Tilemap::resize( const int size )
 {
-  _d->resize( size );
+  _d->size = size;
+
+  // tiles refer to terrain by index, so both arrays are rebuilt together.
+  // copies of tile are standalone, so tiles are created empty and attached in place
+  _d->terrain.resize( size );
+  _d->tiles.clear();
+  _d->tiles.resize( size * size, Tile() );
+  for( int i = 0; i < size; ++i )
+  {
+    for (int j = 0; j < size; ++j)
+    {
+      _d->tiles[ i * size + j ]._attach( TilePos( i, j ), _d->terrain, i * size + j );
+    }
+  }
 }
 
 bool Tilemap::isInside(const TilePos& pos ) const
@@ -120,40 +116,25 @@ int Tilemap::getSize() const
   return _d->size;
 }
 
-TilemapTiles Tilemap::getRectangle( const TilePos& start, const TilePos& stop, const bool corners /*= true*/ )
+const TerrainStorage& Tilemap::getTerrain() const
 {
-  TilemapTiles res;
-
-  int delta_corners = 0;
-  if (! corners)
-  {
-    delta_corners = 1;
-  }
+  return _d->terrain;
+}
 
-  for(int i = start.getI() + delta_corners; i <= stop.getI() - delta_corners; ++i)
+void Tilemap::invalidate( const TilePos& pos, const Size& size )
+{
+  for( TileRange tile=TileRange::area( *this, pos, size ); tile.isValid(); tile.next() )
   {
-    if (isInside( TilePos( i, start.getJ() ) ))
-    {
-      res.push_back( &at(i, start.getJ() ));
-    }
-
-    if (isInside( TilePos( i, stop.getJ() ) ))
-    {
-      res.push_back( &at( i, stop.getJ() ));
-    }
+    _d->terrain.touch( tile->getI() * _d->size + tile->getJ() );
   }
+}
 
-  for (int j = start.getJ() + 1; j <= stop.getJ() - 1; ++j)  // corners have been handled already
+TilemapTiles Tilemap::getRectangle( const TilePos& start, const TilePos& stop, const bool corners /*= true*/ )
+{
+  TilemapTiles res;
+  for( TileRange range=TileRange::perimeter( *this, start, stop, corners ); range.isValid(); range.next() )
   {
-    if (isInside( TilePos( start.getI(), j ) ))
-    {
-      res.push_back(&at(start.getI(), j));
-    }
-
-    if (isInside( TilePos( stop.getI(), j ) ))
-    {
-      res.push_back(&at(stop.getI(), j));
-    }
+    res.push_back( &(*range) );
   }
 
   return res;
@@ -167,20 +148,13 @@ TilemapTiles Tilemap::getRectangle( const TilePos& pos, const Size& size, const
 // Get tiles inside of rectangle
 TilemapTiles Tilemap::getArea(const TilePos& start, const TilePos& stop )
 {
-   TilemapTiles res;
-
-   for (int i = start.getI(); i <= stop.getI(); ++i)
-   {
-      for (int j = start.getJ(); j <= stop.getJ(); ++j)
-      {
-         if( isInside( TilePos( i, j ) ))
-         {
-            res.push_back( &at( TilePos( i, j ) ) );
-         }
-      }
-   }
+  TilemapTiles res;
+  for( TileRange range=TileRange::area( *this, start, stop ); range.isValid(); range.next() )
+  {
+    res.push_back( &(*range) );
+  }
 
-   return res;
+  return res;
 }
 
 TilemapTiles Tilemap::getArea( const TilePos& start, const Size& size )
@@ -188,51 +162,120 @@ TilemapTiles Tilemap::getArea( const TilePos& start, const Size& size )
   return getArea( start, start + TilePos( size.getWidth()-1, size.getHeight()-1 ) );
 }
 
+// terrain arrays are saved as packed little-endian records, bytes per tile
+static const int bitsetBytes = 4;
+static const int desirabilityBytes = 2;
+static const int imgIdBytes = 2;
+
+static void packValue( ByteArray& data, int index, int bytes, unsigned int value )
+{
+  char* record = &data[ index * bytes ];
+  for( int k=0; k < bytes; k++ ) { record[ k ] = (char)( (value >> (k*8)) & 0xff ); }
+}
+
+static unsigned int unpackValue( const ByteArray& data, int index, int bytes )
+{
+  const unsigned char* record = (const unsigned char*)&data[ index * bytes ];
+  unsigned int value = 0;
+  for( int k=0; k < bytes; k++ ) { value |= (unsigned int)record[ k ] << (k*8); }
+  return value;
+}
+
+// json saves keep packed arrays as base64 strings
+static ByteArray unpackData( const VariantMap& stream, const std::string& name )
+{
+  Variant value = stream.get( name );
+  return value.type() == Variant::String ? ByteArray::fromBase64( value.toString() ) : value.toByteArray();
+}
+
 void Tilemap::save( VariantMap& stream ) const
+{
+  save( _d->terrain.getData(), stream );
+}
+
+TerrainArraysPtr Tilemap::shareTerrain() const
+{
+  return _d->terrain.share();
+}
+
+void Tilemap::save( const TerrainArrays& terrain, VariantMap& stream )
 {
   // saves the graphics map
-  VariantList bitsetInfo;
-  VariantList desInfo;
-  VariantList idInfo;
+  int count = terrain.side * terrain.side;
 
-  TilemapArea tiles = const_cast< Tilemap* >( this )->getArea( TilePos( 0, 0 ), Size( _d->size ) );
-  foreach( Tile* tile, tiles )
+  ByteArray bitsetInfo;
+  ByteArray desInfo;
+  ByteArray idInfo;
+  bitsetInfo.resize( count * bitsetBytes );
+  desInfo.resize( count * desirabilityBytes );
+  idInfo.resize( count * imgIdBytes );
+
+  for( int index=0; index < count; index++ )
   {
-    bitsetInfo.push_back( TileHelper::encode( *tile ) );
-    desInfo.push_back( tile->getDesirability() );
-    idInfo.push_back( tile->getOriginalImgId() );
+    packValue( bitsetInfo, index, bitsetBytes, TileHelper::encode( terrain.flags[ index ] ) );
+    packValue( desInfo, index, desirabilityBytes, (unsigned short)terrain.desirability[ index ] );
+    packValue( idInfo, index, imgIdBytes, terrain.imgId[ index ] );
   }
 
-  stream[ "bitset" ]       = bitsetInfo;
-  stream[ "desirability" ] = desInfo;
-  stream[ "imgId" ]        = idInfo;
-  stream[ "size" ]         = _d->size;
+  stream[ "bitsetData" ]       = bitsetInfo;
+  stream[ "desirabilityData" ] = desInfo;
+  stream[ "imgIdData" ]        = idInfo;
+  stream[ "size" ]             = terrain.side;
 }
 
 void Tilemap::load( const VariantMap& stream )
 {
-  VariantList bitsetInfo = stream.get( "bitset" ).toList();
-  VariantList desInfo    = stream.get( "desirability" ).toList();
-  VariantList idInfo     = stream.get( "imgId" ).toList();
-
   int size = stream.get( "size" ).toInt();
+  int count = size * size;
 
   resize( size );
 
-  VariantList::iterator imgIdIt        = idInfo.begin();
-  VariantList::iterator bitsetInfoIt   = bitsetInfo.begin();
-  VariantList::iterator desirabilityIt = desInfo.begin();
+  // saves with packed arrays, or older ones with lists of values
+  std::vector< int > bitsetInfo( count, 0 );
+  std::vector< int > desInfo( count, 0 );
+  std::vector< int > idInfo( count, 0 );
+
+  ByteArray bitsetData = unpackData( stream, "bitsetData" );
+  if( (int)bitsetData.size() >= count * bitsetBytes )
+  {
+    ByteArray desData = unpackData( stream, "desirabilityData" );
+    ByteArray idData  = unpackData( stream, "imgIdData" );
+    bool desOk = (int)desData.size() >= count * desirabilityBytes;
+    bool idOk = (int)idData.size() >= count * imgIdBytes;
+
+    for( int index=0; index < count; index++ )
+    {
+      bitsetInfo[ index ] = (int)unpackValue( bitsetData, index, bitsetBytes );
+      desInfo[ index ] = desOk ? (short)unpackValue( desData, index, desirabilityBytes ) : 0;
+      idInfo[ index ] = idOk ? (int)unpackValue( idData, index, imgIdBytes ) : 0;
+    }
+  }
+  else
+  {
+    VariantList bitsetList = stream.get( "bitset" ).toList();
+    VariantList desList    = stream.get( "desirability" ).toList();
+    VariantList idList     = stream.get( "imgId" ).toList();
+
+    VariantList::iterator bitsetIt = bitsetList.begin();
+    VariantList::iterator desIt = desList.begin();
+    VariantList::iterator idIt = idList.begin();
+    for( int index=0; index < count; index++ )
+    {
+      if( bitsetIt != bitsetList.end() ) { bitsetInfo[ index ] = (*bitsetIt).toInt(); bitsetIt++; }
+      if( desIt != desList.end() ) { desInfo[ index ] = (*desIt).toInt(); desIt++; }
+      if( idIt != idList.end() ) { idInfo[ index ] = (*idIt).toInt(); idIt++; }
+    }
+  }
 
-  TilemapArea tiles = getArea( TilePos( 0, 0 ), Size( _d->size ) );
-  for( TilemapArea::iterator it = tiles.begin(); it != tiles.end(); 
-       it++, imgIdIt++, bitsetInfoIt++, desirabilityIt++ )
+  int index = 0;
+  for( Impl::Tiles::iterator it = _d->tiles.begin(); it != _d->tiles.end(); it++, index++ )
   {
-    Tile* tile = *it;
+    Tile* tile = &(*it);
 
-    TileHelper::decode( *tile, (*bitsetInfoIt).toInt() );
-    tile->appendDesirability( (*desirabilityIt).toInt() );
+    TileHelper::decode( *tile, bitsetInfo[ index ] );
+    tile->appendDesirability( desInfo[ index ] );
 
-    int imgId = (*imgIdIt).toInt();
+    int imgId = idInfo[ index ];
     if( imgId != 0 )
     {
       std::string picName = TileHelper::convId2PicName( imgId );
@@ -264,3 +307,132 @@ Tilemap::~Tilemap()
 {
 
 }
+
+TileRange::TileRange( Tilemap& tilemap, int minI, int minJ, int maxI, int maxJ, bool perimeter, bool corners )
+  : _tilemap( &tilemap ), _minI( minI ), _minJ( minJ ), _maxI( maxI ), _maxJ( maxJ ),
+    _perimeter( perimeter ), _corners( corners ? 0 : 1 ), _phase( 0 ), _side( 0 )
+{
+  if( _perimeter )
+  {
+    _k = _minI + _corners;
+    _valid = _k <= _maxI - _corners || _minJ + 1 <= _maxJ - 1;
+  }
+  else
+  {
+    // inner tiles of area are always visited, so area is clipped once
+    int lastIndex = tilemap.getSize() - 1;
+    _minI = std::max( _minI, 0 );
+    _minJ = std::max( _minJ, 0 );
+    _maxI = std::min( _maxI, lastIndex );
+    _maxJ = std::min( _maxJ, lastIndex );
+    _i = _minI;
+    _j = _minJ;
+    _valid = _minI <= _maxI && _minJ <= _maxJ;
+    return;
+  }
+
+  if( _valid && _k > _maxI - _corners )
+  {
+    _phase = 1;
+    _k = _minJ + 1;
+  }
+
+  if( _valid )
+  {
+    _i = _phase == 0 ? _k : _minI;
+    _j = _phase == 0 ? _minJ : _k;
+    _seekInside();
+  }
+}
+
+TileRange TileRange::area( Tilemap& tilemap, const TilePos& start, const TilePos& stop )
+{
+  return TileRange( tilemap, start.getI(), start.getJ(), stop.getI(), stop.getJ(), false, true );
+}
+
+TileRange TileRange::area( Tilemap& tilemap, const TilePos& start, const Size& size )
+{
+  return area( tilemap, start, start + TilePos( size.getWidth()-1, size.getHeight()-1 ) );
+}
+
+TileRange TileRange::perimeter( Tilemap& tilemap, const TilePos& start, const TilePos& stop, bool corners )
+{
+  return TileRange( tilemap, start.getI(), start.getJ(), stop.getI(), stop.getJ(), true, corners );
+}
+
+TileRange TileRange::perimeter( Tilemap& tilemap, const TilePos& start, const Size& size, bool corners )
+{
+  return perimeter( tilemap, start, start + TilePos( size.getWidth()-1, size.getHeight()-1 ), corners );
+}
+
+TileRange TileRange::neighbours( Tilemap& tilemap, const TilePos& pos, bool corners )
+{
+  return perimeter( tilemap, pos - TilePos( 1, 1 ), pos + TilePos( 1, 1 ), corners );
+}
+
+void TileRange::next()
+{
+  if( !_valid )
+    return;
+
+  if( !_perimeter )
+  {
+    if( ++_j > _maxJ )
+    {
+      _j = _minJ;
+      _valid = ++_i <= _maxI;
+    }
+
+    return;
+  }
+
+  _valid = _step();
+  _seekInside();
+}
+
+bool TileRange::_step()
+{
+  // second side of the line, if it differs from the first one
+  if( _side == 0 && ( _phase == 0 ? _minJ != _maxJ : _minI != _maxI ) )
+  {
+    _side = 1;
+  }
+  else
+  {
+    _side = 0;
+    _k++;
+    if( _phase == 0 && _k > _maxI - _corners )
+    {
+      // corners have been handled already
+      _phase = 1;
+      _k = _minJ + 1;
+    }
+
+    if( _phase == 1 && _k > _maxJ - 1 )
+      return false;
+  }
+
+  if( _phase == 0 )
+  {
+    _i = _k;
+    _j = _side == 0 ? _minJ : _maxJ;
+  }
+  else
+  {
+    _i = _side == 0 ? _minI : _maxI;
+    _j = _k;
+  }
+
+  return true;
+}
+
+void TileRange::_seekInside()
+{
+  while( _valid && !_tilemap->isInside( TilePos( _i, _j ) ) )
+  {
+    _valid = _step();
+  }
+}
+
+Tile& TileRange::operator*() const { return _tilemap->at( _i, _j ); }
+Tile* TileRange::operator->() const { return &_tilemap->at( _i, _j ); }
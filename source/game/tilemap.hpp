@@ -23,6 +23,9 @@
 #include "core/predefinitions.hpp"
 #include "core/scopedptr.hpp"
 
+class TerrainStorage;
+class Tile;
+
 // Square Map of the Tiles.
 class Tilemap : public Serializable
 {
@@ -55,9 +58,21 @@ public:
   TilemapArea getArea( const TilePos& start, const Size& size );
   int getSize() const;
 
+  // terrain arrays of all tiles, tile (i, j) has index i * size + j
+  const TerrainStorage& getTerrain() const;
+
+  // marks tiles of area as changed for caches, which watch revisions of terrain.
+  // Setters of tile do it themselves, this one is for changes of overlays
+  void invalidate( const TilePos& pos, const Size& size );
+
   void save( VariantMap& stream) const;
   void load( const VariantMap& stream);
 
+  // terrain arrays for background save, they stay unchanged while result is alive.
+  // Result must be released in main thread, worker thread passes it to static save()
+  TerrainArraysPtr shareTerrain() const;
+  static void save( const TerrainArrays& terrain, VariantMap& stream );
+
   TilePos fit( const TilePos& pos ) const;
 
 private: 
@@ -66,4 +81,50 @@ private:
 };
 
 
+// Iterates tiles of rectangle, its perimeter or neighbours of tile without allocations,
+// positions outside of tilemap are skipped. Tiles come in the same order as
+// Tilemap::getArea and Tilemap::getRectangle return them.
+//
+//   for( TileRange range=TileRange::area( tilemap, start, stop ); range.isValid(); range.next() )
+//   {
+//     range->getOverlay();
+//   }
+class TileRange
+{
+public:
+  static TileRange area( Tilemap& tilemap, const TilePos& start, const TilePos& stop );
+  static TileRange area( Tilemap& tilemap, const TilePos& start, const Size& size );
+
+  // corners : if false, don't visit corner tiles
+  static TileRange perimeter( Tilemap& tilemap, const TilePos& start, const TilePos& stop, bool corners=true );
+  static TileRange perimeter( Tilemap& tilemap, const TilePos& start, const Size& size, bool corners=true );
+
+  // tiles around pos, only orthogonal ones when corners is false
+  static TileRange neighbours( Tilemap& tilemap, const TilePos& pos, bool corners=true );
+
+  // returns false when all tiles were visited
+  bool isValid() const { return _valid; }
+  void next();
+
+  Tile& operator*() const;
+  Tile* operator->() const;
+
+private:
+  TileRange( Tilemap& tilemap, int minI, int minJ, int maxI, int maxJ, bool perimeter, bool corners );
+
+  // moves to next position of rectangle or perimeter, returns false at end
+  bool _step();
+  void _seekInside();
+
+  Tilemap* _tilemap;
+  int _minI, _minJ, _maxI, _maxJ;
+  bool _perimeter;
+  int _corners;  // 0 when corners are visited, 1 otherwise
+  int _phase;    // perimeter: 0 - columns minJ and maxJ, 1 - rows minI and maxI
+  int _k;
+  int _side;
+  int _i, _j;
+  bool _valid;
+};
+
 #endif //__OPENCAESAR3_TILEMAP_H_INCLUDED__
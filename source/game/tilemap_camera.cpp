@@ -24,6 +24,9 @@
 #include "gfx/tile.hpp"
 #include "core/foreach.hpp"
 
+#include <algorithm>
+#include <cstdlib>
+
 class TilemapCamera::Impl
 {
 public:
@@ -34,18 +37,198 @@ public:
   Size viewSize;    // width of the view (in tiles)  nb_tilesX = 1+2*_view_width
                     // height of the view (in tiles)  nb_tilesY = 1+2*_view_height
 
-  TilemapArea tiles;  // cached list of visible tiles
+  Rows rows;    // rows of visible tiles, one for every depth of view, empty ones too
+  int rowsCenterX;  // center of view, for which rows were built
+  int rowsTopZ;
+  bool valid;
+
+  // updates rows after moving of view, vertical scroll moves rows which left view
+  // to other side and fills only them, horizontal scroll trims and extends ends of kept rows
+  void update();
+  void fillRow( int z, int cx, Row& row ) const;
+  void shiftRow( int z, int cx, Row& row ) const;
+  Tile* getTile( int x, int z ) const;
 
 public oc3_signals:
   Signal1<Point> onPositionChangedSignal;
 };
 
+void TilemapCamera::Impl::fillRow( int z, int cx, Row& row ) const
+{
+  int mapSize = tilemap->getSize();
+  int zm = mapSize + 1;
+
+  row.z = z - zm;
+  row.tiles.clear();
+
+  // depth axis. from far to near.
+  int xstart = cx - viewSize.getWidth();
+  if ((xstart + z) % 2 == 0)
+  {
+    ++xstart;
+  }
+  int xstop = cx + viewSize.getWidth();
+
+  if( (xstart + z - zm) % 2 == 0 )
+  {
+    // every x of row is tile, so row is clipped by borders of map without checking of tiles
+    int border = std::abs( z - zm );
+    xstart = std::max( xstart, border );
+    xstop = std::min( xstop, 2 * (mapSize - 1) - border );
+
+    for( int x = xstart; x <= xstop; x+=2 )
+    {
+      int j = (x + z - zm)/2;
+      row.tiles.push_back( &tilemap->at( x - j, j ) );
+    }
+  }
+  else
+  {
+    for (int x = xstart; x<=xstop; x+=2)
+    {
+      // left-right axis
+      int j = (x + z - zm)/2;
+      int i = x - j;
+
+      if( (i >= 0) && (j >= 0) && (i < mapSize) && (j < mapSize) )
+      {
+        row.tiles.push_back( &tilemap->at( i, j ));
+      }
+    }
+  }
+}
+
+Tile* TilemapCamera::Impl::getTile( int x, int z ) const
+{
+  int mapSize = tilemap->getSize();
+  int j = (x + z - mapSize - 1)/2;
+  int i = x - j;
+
+  return ( (i >= 0) && (j >= 0) && (i < mapSize) && (j < mapSize) ) ? &tilemap->at( i, j ) : NULL;
+}
+
+void TilemapCamera::Impl::shiftRow( int z, int cx, Row& row ) const
+{
+  int xstart = cx - viewSize.getWidth();
+  if ((xstart + z) % 2 == 0)
+  {
+    ++xstart;
+  }
+  int xstop = cx + viewSize.getWidth();
+
+  // x of tile is i + j, tiles of row go by x from left to right
+  Tiles& tiles = row.tiles;
+  Tiles::iterator first = tiles.begin();
+  while( first != tiles.end() && (*first)->getI() + (*first)->getJ() < xstart )
+  {
+    ++first;
+  }
+
+  Tiles::iterator last = tiles.end();
+  while( last != first && (*(last - 1))->getI() + (*(last - 1))->getJ() > xstop )
+  {
+    --last;
+  }
+
+  tiles.erase( last, tiles.end() );
+  tiles.erase( tiles.begin(), first );
+
+  if( tiles.empty() )
+  {
+    fillRow( z, cx, row );
+    return;
+  }
+
+  Tiles head;
+  for( int x = tiles.front()->getI() + tiles.front()->getJ() - 2; x >= xstart; x-=2 )
+  {
+    Tile* tile = getTile( x, z );
+    if( tile == NULL )
+      break;
+
+    head.push_back( tile );
+  }
+  tiles.insert( tiles.begin(), head.rbegin(), head.rend() );
+
+  for( int x = tiles.back()->getI() + tiles.back()->getJ() + 2; x <= xstop; x+=2 )
+  {
+    Tile* tile = getTile( x, z );
+    if( tile == NULL )
+      break;
+
+    tiles.push_back( tile );
+  }
+}
+
+void TilemapCamera::Impl::update()
+{
+  int cx = centerMapXZ.getX();
+  int cz = centerMapXZ.getY();
+  int topZ = cz + viewSize.getHeight();
+  int bottomZ = cz - viewSize.getHeight();
+  int count = topZ - bottomZ + 1;
+
+  // rows are kept while view overlaps them, long horizontal jump refills them
+  int oldBottomZ = rowsTopZ - (int)rows.size() + 1;
+  bool reuseRows = ( (int)rows.size() == count && std::abs( cx - rowsCenterX ) < 2 * viewSize.getWidth()
+                     && bottomZ <= rowsTopZ && topZ >= oldBottomZ );
+
+  if( !reuseRows )
+  {
+    rows.resize( count );
+    for( int k=0; k < count; k++ )
+    {
+      fillRow( topZ - k, cx, rows[ k ] );
+    }
+  }
+
+  // horizontal scroll: rows which stay in view get new tiles only at their ends
+  if( reuseRows && rowsCenterX != cx )
+  {
+    for( int k=0; k < count; k++ )
+    {
+      int z = rowsTopZ - k;
+      if( z <= topZ && z >= bottomZ )
+      {
+        shiftRow( z, cx, rows[ k ] );
+      }
+    }
+  }
+
+  // scroll to far side: nearest rows left view, they get tiles of new far rows
+  while( reuseRows && rowsTopZ < topZ )
+  {
+    rowsTopZ++;
+    rows.push_front( Row() );
+    rows.front().tiles.swap( rows.back().tiles );
+    rows.pop_back();
+    fillRow( rowsTopZ, cx, rows.front() );
+  }
+
+  // scroll to near side
+  while( reuseRows && rowsTopZ > topZ )
+  {
+    rowsTopZ--;
+    rows.push_back( Row() );
+    rows.back().tiles.swap( rows.front().tiles );
+    rows.pop_front();
+    fillRow( rowsTopZ - count + 1, cx, rows.back() );
+  }
+
+  rowsCenterX = cx;
+  rowsTopZ = topZ;
+  valid = true;
+}
+
 TilemapCamera::TilemapCamera() : _d( new Impl )
 {
   _d->tilemap = NULL;
   _d->viewSize = Size( 0 );
   _d->center = TilePos( 0, 0 );
   _d->centerMapXZ = Point( 0, 0 );
+  _d->rowsCenterX = 0;
+  _d->rowsTopZ = 0;
+  _d->valid = false;
 }
 
 TilemapCamera::~TilemapCamera()
@@ -55,14 +238,15 @@ TilemapCamera::~TilemapCamera()
 void TilemapCamera::init(Tilemap &tilemap)
 {
   _d->tilemap = &tilemap;
+  _d->rows.clear();
+  _d->valid = false;
 }
 
 void TilemapCamera::setViewport(const Size& newSize )
 {
-  if( _d->viewSize != newSize )
-  {
-    _d->tiles.clear();
-  }
+  // rows have width of old view
+  _d->rows.clear();
+  _d->valid = false;
 
   _d->viewSize = Size( (newSize.getWidth() + 59) / 60, ( newSize.getHeight() + 29) / 30 );
   
@@ -82,9 +266,9 @@ void TilemapCamera::setCenter( const Point& pos )
 {
   if( _d->centerMapXZ != pos  )
   {
-    _d->tiles.clear();
+    _d->valid = false;
   }
-  
+
   _d->centerMapXZ = pos;
 }
 
@@ -118,56 +302,12 @@ void TilemapCamera::moveDown(const int amount)
   setCenter( Point( getCenterX(), getCenterZ() - amount ) );
 }
 
-const TilemapArea& TilemapCamera::getTiles() const
+const TilemapCamera::Rows& TilemapCamera::getRows() const
 {
-  if( _d->tiles.empty() )
+  if( !_d->valid )
   {
-    int mapSize = _d->tilemap->getSize();
-    int zm = _d->tilemap->getSize() + 1;
-    int cx = _d->centerMapXZ.getX();
-    int cz = _d->centerMapXZ.getY();
-
-    Size sizeT = _d->viewSize;  // size x
-
-    for (int z = cz + sizeT.getHeight(); z>=cz - sizeT.getHeight(); --z)
-    {
-      // depth axis. from far to near.
-
-      int xstart = cx - sizeT.getWidth();
-      if ((xstart + z) % 2 == 0)
-      {
-	      ++xstart;
-      }
-
-      for (int x = xstart; x<=cx + sizeT.getWidth(); x+=2)
-      {
-	// left-right axis
-        int j = (x + z - zm)/2;
-        int i = x - j;
-
-        if( (i >= 0) && (j >= 0) && (i < mapSize) && (j < mapSize) )
-        {
-          _d->tiles.push_back( &_d->tilemap->at( i, j ));
-        }
-      }
-    }
-
-    /*for( int y=0; y < mapSize; y++ )
-    {
-      for( int t=0; t <= y; t++ )
-      {
-        _d->tiles.push_back( &_d->tilemap->at( t, mapSize - 1 - ( y - t ) ) );
-      }
-    }
-
-    for( int x=1; x < mapSize; x++ )
-    {
-      for( int t=0; t < mapSize-x; t++ )
-      {
-        _d->tiles.push_back( &_d->tilemap->at( x + t, t ) );
-      }
-    }*/
+    _d->update();
   }
 
-  return _d->tiles;
+  return _d->rows;
 }
@@ -25,10 +25,24 @@
 #include "core/position.hpp"
 #include "core/signals.hpp"
 
+#include <vector>
+#include <deque>
+
 /* A subset of the tilemap, this is the visible area. Has convenient methods to sort tiles per depth */
 class TilemapCamera
 {
 public:
+  typedef std::vector< Tile* > Tiles;
+
+  // visible tiles of one depth row from left to right, all of them have depth z
+  struct Row
+  {
+    int z;
+    Tiles tiles;
+  };
+  // rows from far to near, one for every depth of view, empty ones too
+  typedef std::deque< Row > Rows;
+
   TilemapCamera();
   ~TilemapCamera();
 
@@ -44,8 +58,9 @@ public:
   void moveUp(const int amount);
   void moveDown(const int amount);
 
-  // return tile coordinates (i, j), in order of depth
-  const TilemapArea& getTiles() const;
+  // returns visible tiles by rows of depth. Rows are changed only after moving of camera,
+  // vertical scroll computes only rows which came into view
+  const Rows& getRows() const;
 
   int getCenterX() const;
   int getCenterZ() const;
@@ -21,6 +21,7 @@
 #include "gfx/picture.hpp"
 #include "core/logger.hpp"
 #include "walker/emigrant.hpp"
+#include "core/stringhelper.hpp"
 #include <vector>
 
 using namespace constants;
@@ -45,6 +46,7 @@ namespace{
   static const Point backCartOffsetSouthWest  = Point( -20, 20 );
 
   static const int noneGoodsPicId = 1;
+  static const int directionPicsCount = 8;  // pictures of all directions follow one another
 }
 
 class AnimationBank::Impl
@@ -67,73 +69,116 @@ public:
   void loadWalkers();
 };
 
-void AnimationBank::Impl::loadCarts()
+namespace {
+
+struct CartInfo
+{
+  int id;
+  int start;  // index of the first frame
+  bool back;
+};
+
+struct WalkerInfo
+{
+  gfx::Type type;
+  const char* prefix;
+  int start;  // index of the first frame
+  int size;   // count of frames for every direction
+  Walker::Action action;
+};
+
+// tables are built on first call, after names of resource groups were initialized
+static const CartInfo* getCartsInfo( int& count )
 {
   //number of animations with goods + emmigrants + immigrants
-  bool frontCart = false;
-
-  carts[Good::none] = fillCart(ResourceGroup::carts, noneGoodsPicId, frontCart);
-  carts[Good::wheat] = fillCart(ResourceGroup::carts, 9, frontCart);
-  carts[Good::vegetable] = fillCart(ResourceGroup::carts, 17, frontCart);
-  carts[Good::fruit] = fillCart( ResourceGroup::carts, 25, frontCart);
-  carts[Good::olive] = fillCart( ResourceGroup::carts, 33, frontCart);
-  carts[Good::grape] = fillCart( ResourceGroup::carts, 41, frontCart);
-  carts[Good::meat] = fillCart( ResourceGroup::carts, 49, frontCart);
-  carts[Good::wine] = fillCart( ResourceGroup::carts, 57, frontCart);
-  carts[Good::oil] = fillCart( ResourceGroup::carts, 65, frontCart);
-  carts[Good::iron] = fillCart( ResourceGroup::carts, 73, frontCart);
-  carts[Good::timber] = fillCart( ResourceGroup::carts, 81, frontCart);
-  carts[Good::clay] =  fillCart( ResourceGroup::carts, 89, frontCart);
-  carts[Good::marble] = fillCart( ResourceGroup::carts, 97, frontCart);
-  carts[Good::weapon] = fillCart( ResourceGroup::carts, 105, frontCart);
-  carts[Good::furniture] = fillCart( ResourceGroup::carts, 113, frontCart);
-  carts[Good::pottery] = fillCart( ResourceGroup::carts, 121, frontCart);
-  carts[Emigrant::G_EMIGRANT_CART1] = fillCart( ResourceGroup::carts, 129, !frontCart);
-  carts[Emigrant::G_EMIGRANT_CART2] = fillCart( ResourceGroup::carts, 137, !frontCart);
-  carts[Good::fish] = fillCart( ResourceGroup::carts, 697, frontCart);
+  static const CartInfo carts[] = {
+    { Good::none,     noneGoodsPicId, false },
+    { Good::wheat,     9, false },  { Good::vegetable, 17, false },
+    { Good::fruit,    25, false },  { Good::olive,     33, false },
+    { Good::grape,    41, false },  { Good::meat,      49, false },
+    { Good::wine,     57, false },  { Good::oil,       65, false },
+    { Good::iron,     73, false },  { Good::timber,    81, false },
+    { Good::clay,     89, false },  { Good::marble,    97, false },
+    { Good::weapon,  105, false },  { Good::furniture, 113, false },
+    { Good::pottery, 121, false },
+    { Emigrant::G_EMIGRANT_CART1, 129, true },
+    { Emigrant::G_EMIGRANT_CART2, 137, true },
+    { Good::fish,    697, false }
+  };
+
+  count = sizeof( carts ) / sizeof( CartInfo );
+  return carts;
+}
+
+static const WalkerInfo* getWalkersInfo( int& count )
+{
+  static const WalkerInfo walkers[] = {
+    { gfx::citizen,          ResourceGroup::citizen1, 1, 12, Walker::acMove },
+    { gfx::bathlady,         ResourceGroup::citizen1, 105, 12, Walker::acMove },
+    { gfx::priest,           ResourceGroup::citizen1, 209, 12, Walker::acMove },
+    { gfx::actor,            ResourceGroup::citizen1, 313, 12, Walker::acMove },
+    { gfx::tamer,            ResourceGroup::citizen1, 417, 12, Walker::acMove },
+    { gfx::taxCollector,     ResourceGroup::citizen1, 617, 12, Walker::acMove },
+    { gfx::scholar,          ResourceGroup::citizen1, 721, 12, Walker::acMove },
+    { gfx::marketlady,       ResourceGroup::citizen1, 825, 12, Walker::acMove },
+    { gfx::cartPusher,       ResourceGroup::citizen1, 929, 12, Walker::acMove },
+    { gfx::cartPusher2,      ResourceGroup::citizen1, 1033, 12, Walker::acMove },
+    { gfx::engineer,         ResourceGroup::citizen1, 1137, 12, Walker::acMove },
+    { gfx::gladiator,        ResourceGroup::citizen2, 1, 12, Walker::acMove },
+    { gfx::gladiator2,       ResourceGroup::citizen2, 199, 12, Walker::acMove },
+    { gfx::protestor,        ResourceGroup::citizen2, 351, 12, Walker::acMove },
+    { gfx::barber,           ResourceGroup::citizen2, 463, 12, Walker::acMove },
+    { gfx::prefect,          ResourceGroup::citizen2, 615, 12, Walker::acMove },
+    { gfx::prefectDragWater, ResourceGroup::citizen2, 767, 12, Walker::acMove },
+    { gfx::prefectFightFire, ResourceGroup::citizen2, 863, 6, Walker::acFight },
+    { gfx::prefectFight,     ResourceGroup::citizen2, 719, 6, Walker::acFight },
+    { gfx::homeless,         ResourceGroup::citizen2, 911, 12, Walker::acMove },
+    { gfx::patrician,        ResourceGroup::citizen3, 713, 12, Walker::acMove },
+    { gfx::doctor,           ResourceGroup::citizen3, 817, 12, Walker::acMove },
+    { gfx::patrician2,       ResourceGroup::citizen3, 921, 12, Walker::acMove },
+    { gfx::teacher,          ResourceGroup::citizen3, 1025, 12, Walker::acMove },
+    { gfx::soldier,          ResourceGroup::citizen3, 553, 12, Walker::acMove },
+    { gfx::javelineer,       ResourceGroup::citizen3, 241, 12, Walker::acMove },
+    { gfx::horseman,         ResourceGroup::citizen4, 1, 12, Walker::acMove },
+    { gfx::horseMerchant,    ResourceGroup::carts, 145, 12, Walker::acMove },
+    { gfx::camelMerchant,    ResourceGroup::carts, 273, 12, Walker::acMove },
+    { gfx::marketkid,        ResourceGroup::carts, 369, 12, Walker::acMove },
+    { gfx::sheep,            ResourceGroup::animals, 153, 5, Walker::acMove },
+    { gfx::fishingBoat,      ResourceGroup::carts, 249, 1, Walker::acMove },
+    { gfx::fishingBoatWork,  ResourceGroup::carts, 257, 1, Walker::acMove },
+    { gfx::homelessSit,      ResourceGroup::citizen2, 1015, 1, Walker::acMove },
+    { gfx::lion,             ResourceGroup::lion, 1, 12, Walker::acMove },
+    { gfx::charioter,        ResourceGroup::citizen5, 1, 12, Walker::acMove }
+  };
+
+  count = sizeof( walkers ) / sizeof( WalkerInfo );
+  return walkers;
+}
+
+}
+
+void AnimationBank::Impl::loadCarts()
+{
+  int count;
+  const CartInfo* info = getCartsInfo( count );
+  for( int k=0; k < count; k++ )
+  {
+    carts[ info[ k ].id ] = fillCart( ResourceGroup::carts, info[ k ].start, info[ k ].back );
+  }
 }
 
 void AnimationBank::Impl::loadWalkers()
 {
   animations.resize( gfx::countType );
 
-  animations[gfx::unknown              ] = AnimationBank::MovementAnimation();
-  animations[gfx::citizen              ] = loadAnimation( ResourceGroup::citizen1, 1, 12 );
-  animations[gfx::bathlady              ] = loadAnimation( ResourceGroup::citizen1, 105, 12);
-  animations[gfx::priest            ] = loadAnimation( ResourceGroup::citizen1, 209, 12);
-  animations[gfx::actor             ] = loadAnimation( ResourceGroup::citizen1, 313, 12);
-  animations[gfx::tamer             ] = loadAnimation( ResourceGroup::citizen1, 417, 12);
-  animations[gfx::taxCollector               ] = loadAnimation( ResourceGroup::citizen1, 617, 12);
-  animations[gfx::scholar             ] = loadAnimation( ResourceGroup::citizen1, 721, 12);
-  animations[gfx::marketlady        ] = loadAnimation( ResourceGroup::citizen1, 825, 12);
-  animations[gfx::cartPusher            ] = loadAnimation( ResourceGroup::citizen1, 929, 12);
-  animations[gfx::cartPusher2           ] = loadAnimation( ResourceGroup::citizen1, 1033, 12);
-  animations[gfx::engineer          ] = loadAnimation( ResourceGroup::citizen1, 1137, 12);
-  animations[gfx::gladiator         ] = loadAnimation( ResourceGroup::citizen2, 1, 12);
-  animations[gfx::gladiator2        ] = loadAnimation( ResourceGroup::citizen2, 199, 12);
-  animations[gfx::protestor         ] = loadAnimation( ResourceGroup::citizen2, 351, 12);
-  animations[gfx::barber            ] = loadAnimation( ResourceGroup::citizen2, 463, 12);
-  animations[gfx::prefect           ] = loadAnimation( ResourceGroup::citizen2, 615, 12);
-  animations[gfx::prefectDragWater] = loadAnimation( ResourceGroup::citizen2, 767, 12);
-  animations[gfx::prefectFightFire]= loadAnimation( ResourceGroup::citizen2, 863, 6, Walker::acFight );
-  animations[gfx::prefectFight     ] = loadAnimation( ResourceGroup::citizen2, 719, 6, Walker::acFight );
-  animations[gfx::homeless          ] = loadAnimation( ResourceGroup::citizen2, 911, 12);
-  animations[gfx::patrician              ] = loadAnimation( ResourceGroup::citizen3, 713, 12);
-  animations[gfx::doctor            ] = loadAnimation( ResourceGroup::citizen3, 817, 12);
-  animations[gfx::patrician2             ] = loadAnimation( ResourceGroup::citizen3, 921, 12);
-  animations[gfx::teacher           ] = loadAnimation( ResourceGroup::citizen3, 1025, 12);
-  animations[gfx::soldier           ] = loadAnimation( ResourceGroup::citizen3, 553, 12);
-  animations[gfx::javelineer        ] = loadAnimation( ResourceGroup::citizen3, 241, 12);
-  animations[gfx::horseman          ] = loadAnimation( ResourceGroup::citizen4, 1, 12);
-  animations[gfx::horseMerchant     ] = loadAnimation( ResourceGroup::carts, 145, 12);
-  animations[gfx::camelMerchant     ] = loadAnimation( ResourceGroup::carts, 273, 12);
-  animations[gfx::marketkid        ] = loadAnimation( ResourceGroup::carts, 369, 12);
-  animations[gfx::sheep ] = loadAnimation( ResourceGroup::animals, 153, 5 );
-  animations[gfx::fishingBoat      ] = loadAnimation( ResourceGroup::carts, 249, 1 );
-  animations[gfx::fishingBoatWork ] = loadAnimation( ResourceGroup::carts, 257, 1 );
-  animations[gfx::homelessSit      ] = loadAnimation( ResourceGroup::citizen2, 1015, 1 );
-  animations[gfx::lion              ] = loadAnimation( ResourceGroup::lion, 1, 12 );
-  animations[gfx::charioter           ] = loadAnimation( ResourceGroup::citizen5, 1, 12 );
+  animations[gfx::unknown] = AnimationBank::MovementAnimation();
+
+  int count;
+  const WalkerInfo* info = getWalkersInfo( count );
+  for( int k=0; k < count; k++ )
+  {
+    animations[ info[ k ].type ] = loadAnimation( info[ k ].prefix, info[ k ].start, info[ k ].size, info[ k ].action );
+  }
 }
 
 AnimationBank& AnimationBank::instance()
@@ -184,6 +229,32 @@ const AnimationBank::MovementAnimation& AnimationBank::getWalker( gfx::Type anim
   return inst._d->animations[ anim ];
 }
 
+StringArray AnimationBank::getPictureNames()
+{
+  StringArray names;
+
+  int count;
+  const CartInfo* carts = getCartsInfo( count );
+  for( int k=0; k < count; k++ )
+  {
+    for( int frame=0; frame < directionPicsCount; frame++ )
+    {
+      names.push_back( StringHelper::format( 0xff, "%s_%05d.png", ResourceGroup::carts, carts[ k ].start + frame ) );
+    }
+  }
+
+  const WalkerInfo* walkers = getWalkersInfo( count );
+  for( int k=0; k < count; k++ )
+  {
+    for( int frame=0; frame < walkers[ k ].size * directionPicsCount; frame++ )
+    {
+      names.push_back( StringHelper::format( 0xff, "%s_%05d.png", walkers[ k ].prefix, walkers[ k ].start + frame ) );
+    }
+  }
+
+  return names;
+}
+
 void AnimationBank::loadWalkers()
 {
   Logger::warning( "Start loading walkers graphics" );
@@ -23,6 +23,7 @@
 #include "game/good.hpp"
 #include "core/direction.hpp"
 #include "constants.hpp"
+#include "core/stringarray.hpp"
 
 #include <map>
 
@@ -37,6 +38,9 @@ public:
   static void loadCarts();
   static void loadWalkers();
 
+  // resource names of all cart and walker pictures, for preloading them
+  static StringArray getPictureNames();
+
   static const Picture& getCart( int cartID, constants::Direction direction );
 
   static const MovementAnimation& getWalker( const constants::gfx::Type walkerGraphic );
@@ -51,6 +51,7 @@
 #include "layerdesirability.hpp"
 #include "layerentertainment.hpp"
 #include "layercrime.hpp"
+#include "terrain_cache.hpp"
 
 using namespace constants;
 
@@ -82,6 +83,7 @@ public:
 
   Layer::VisibleWalkers visibleWalkers;
   LayerPtr currentLayer;
+  TerrainCache terrainCache;  // flat land of simple layer
 
 
   void getSelectedArea( TilePos& outStartPos, TilePos& outStopPos );
@@ -101,13 +103,38 @@ public:
 
   Tile* getTile( const Point& pos, bool overborder);
 
-  WalkerList getVisibleWalkerList();
-  void drawWalkersBetweenZ( WalkerList walkerList, int minZ, int maxZ );
+  // walkers of visible tiles sorted by depth, bucket of depth z
+  // takes walkers from depthWalkers[ depthStart[ z-minDepth ] ] to depthWalkers[ depthStart[ z-minDepth+1 ] ]
+  int minDepth;
+  std::vector< int > depthStart;
+  std::vector< Walker* > depthWalkers;
+  std::vector< Walker* > culledWalkers;
+  PicturesArray walkerPictures;
 
-  void resetWasDrawn( TilemapArea tiles )
+  void sortVisibleWalkers( const TilemapCamera::Rows& rows );
+  void drawWalkers( int z );
+
+  // tiles of destroy area and tiles of buildings, which lay on it, marked by index i * mapSize + j.
+  // marks are changed only when area changes, or when overlays or terrain of tilemap were changed
+  TilePos destroyStart, destroyStop;
+  unsigned int destroyRevision;
+  std::vector< bool > destroyMarks;
+  std::vector< int > destroyIndexes;
+
+  void updateDestroyArea( const TilePos& start, const TilePos& stop );
+  void clearDestroyArea();
+  bool isInDestroyArea( const Tile& tile ) const
+  {
+    return destroyMarks[ tile.getI() * tilemap->getSize() + tile.getJ() ];
+  }
+
+  void resetWasDrawn( const TilemapCamera::Rows& rows )
   {
-    foreach( Tile* tile, tiles )
-      tile->resetWasDrawn();
+    for( TilemapCamera::Rows::const_iterator row=rows.begin(); row != rows.end(); row++ )
+    {
+      for( TilemapCamera::Tiles::const_iterator it=row->tiles.begin(); it != row->tiles.end(); it++ )
+        (*it)->resetWasDrawn();
+    }
   }
 
 oc3_signals public:
@@ -128,6 +155,10 @@ void CityRenderer::initialize( CityPtr city, GfxEngine* engine )
   _d->city = city;
   _d->tilemap = &city->getTilemap();
   _d->camera.init( *_d->tilemap );
+  _d->terrainCache.init( *_d->tilemap );
+  _d->destroyMarks.assign( _d->tilemap->getSize() * _d->tilemap->getSize(), false );
+  _d->destroyIndexes.clear();
+  _d->destroyRevision = 0;
   _d->engine = engine;
   _d->clearPic = Picture::load( "oc3_land", 2 );
 
@@ -213,89 +244,120 @@ void CityRenderer::Impl::drawTileInSelArea( Tile& tile, Tile* master )
   }
 }
 
-void CityRenderer::Impl::renderTilesRTools()
+void CityRenderer::Impl::clearDestroyArea()
 {
-  // center the map on the screen
-  mapOffset = Point( engine->getScreenWidth() / 2 - 30 * (camera.getCenterX() + 1) + 1,
-                     engine->getScreenHeight() / 2 + 15 * (camera.getCenterZ()-tilemap->getSize() + 1) - 30 );
+  foreach( int index, destroyIndexes )
+  {
+    destroyMarks[ index ] = false;
+  }
+
+  destroyIndexes.clear();
+}
+
+void CityRenderer::Impl::updateDestroyArea( const TilePos& start, const TilePos& stop )
+{
+  unsigned int revision = tilemap->getTerrain().getRevision();
+  if( !destroyIndexes.empty() && start == destroyStart && stop == destroyStop && revision == destroyRevision )
+    return;
 
-  int lastZ = -1000;  // dummy value
+  clearDestroyArea();
+  destroyStart = start;
+  destroyStop = stop;
+  destroyRevision = revision;
 
-  TilemapArea visibleTiles = camera.getTiles();
-  resetWasDrawn( visibleTiles );
+  int mapSize = tilemap->getSize();
 
-  TilePos startPos, stopPos;
-  getSelectedArea( startPos, stopPos );
- 
-  std::set<int> hashDestroyArea;
-  TilemapArea destroyArea = tilemap->getArea( startPos, stopPos );
-  
   //create list of destroy tiles add full area building if some of it tile constain in destroy area
-  foreach( Tile* tile, destroyArea)
+  for( TileRange tile=TileRange::area( *tilemap, start, stop ); tile.isValid(); tile.next() )
   {
-    hashDestroyArea.insert( tile->getJ() * 1000 + tile->getI() );
+    int index = tile->getI() * mapSize + tile->getJ();
+    if( !destroyMarks[ index ] )
+    {
+      destroyMarks[ index ] = true;
+      destroyIndexes.push_back( index );
+    }
 
     TileOverlayPtr overlay = tile->getOverlay();
     if( overlay.isValid() )
     {
-      TilemapArea overlayArea = tilemap->getArea( overlay->getTilePos(), overlay->getSize() );
-      foreach( Tile* ovelayTile, overlayArea )
+      for( TileRange ovelayTile=TileRange::area( *tilemap, overlay->getTilePos(), overlay->getSize() );
+           ovelayTile.isValid(); ovelayTile.next() )
       {
-        hashDestroyArea.insert( ovelayTile->getJ() * 1000 + ovelayTile->getI() );
+        index = ovelayTile->getI() * mapSize + ovelayTile->getJ();
+        if( !destroyMarks[ index ] )
+        {
+          destroyMarks[ index ] = true;
+          destroyIndexes.push_back( index );
+        }
       }
     }
   }
-  //Rect destroyArea = Rect( startPos.getI(), startPos.getJ(), stopPos.getI(), stopPos.getJ() );
+}
+
+void CityRenderer::Impl::renderTilesRTools()
+{
+  // center the map on the screen
+  mapOffset = Point( engine->getScreenWidth() / 2 - 30 * (camera.getCenterX() + 1) + 1,
+                     engine->getScreenHeight() / 2 + 15 * (camera.getCenterZ()-tilemap->getSize() + 1) - 30 );
+
+  const TilemapCamera::Rows& rows = camera.getRows();
+  resetWasDrawn( rows );
+
+  TilePos startPos, stopPos;
+  getSelectedArea( startPos, stopPos );
+  updateDestroyArea( startPos, stopPos );
 
   // FIRST PART: draw all flat land (walkable/boatable)
-  foreach( Tile* tile, visibleTiles )
+  for( TilemapCamera::Rows::const_iterator row=rows.begin(); row != rows.end(); row++ )
   {
-    Tile* master = tile->getMasterTile();
+    for( TilemapCamera::Tiles::const_iterator it=row->tiles.begin(); it != row->tiles.end(); it++ )
+    {
+      Tile* tile = *it;
+      Tile* master = tile->getMasterTile();
 
-    if( !tile->isFlat() )
-      continue;
+      if( !tile->isFlat() )
+        continue;
 
-    int tilePosHash = tile->getJ() * 1000 + tile->getI();
-    if( hashDestroyArea.find( tilePosHash ) != hashDestroyArea.end() )
-    {
-      drawTileInSelArea( *tile, master );
-    }
-    else
-    {
-      if( master==NULL )
+      if( isInDestroyArea( *tile ) )
       {
-        // single-tile
-        drawTile( *tile );
+        drawTileInSelArea( *tile, master );
       }
-      else if( !master->getFlag( Tile::wasDrawn ) )
+      else
       {
-        // multi-tile: draw the master tile.
-        drawTile( *master );
-      }    
+        if( master==NULL )
+        {
+          // single-tile
+          drawTile( *tile );
+        }
+        else if( !master->getFlag( Tile::wasDrawn ) )
+        {
+          // multi-tile: draw the master tile.
+          drawTile( *master );
+        }
+      }
     }
-  }  
+  }
 
   // SECOND PART: draw all sprites, impassable land and buildings
-  WalkerList walkerList = getVisibleWalkerList();
-  foreach( Tile* tile, visibleTiles )
+  sortVisibleWalkers( rows );
+  for( TilemapCamera::Rows::const_iterator row=rows.begin(); row != rows.end(); row++ )
   {
-    int z = tile->getIJ().getZ();
+    if( row->tiles.empty() )
+      continue;
 
-    if (z != lastZ)
-    {
-      // TODO: pre-sort all animations
-      lastZ = z;
-      drawWalkersBetweenZ(walkerList, z, z+1);
-    }   
+    drawWalkers( row->z+1 );
 
-    int tilePosHash = tile->getJ() * 1000 + tile->getI();
-    if( hashDestroyArea.find( tilePosHash ) != hashDestroyArea.end() )
+    for( TilemapCamera::Tiles::const_iterator it=row->tiles.begin(); it != row->tiles.end(); it++ )
     {
-      engine->setTileDrawMask( 0x00ff0000, 0, 0, 0xff000000 );      
-    }
+      Tile* tile = *it;
+      if( isInDestroyArea( *tile ) )
+      {
+        engine->setTileDrawMask( 0x00ff0000, 0, 0, 0xff000000 );
+      }
 
-    drawTileEx( *tile, z );
-    engine->resetTileDrawMask();
+      drawTileEx( *tile, row->z );
+      engine->resetTileDrawMask();
+    }
   }
 }
 
@@ -305,51 +367,68 @@ void CityRenderer::Impl::renderTiles()
   mapOffset = Point( engine->getScreenWidth() / 2 - 30 * (camera.getCenterX() + 1) + 1,
                      engine->getScreenHeight() / 2 + 15 * (camera.getCenterZ() - tilemap->getSize() + 1) - 30 );
 
-  int lastZ = -1000;  // dummy value
+  const TilemapCamera::Rows& rows = camera.getRows();
+  resetWasDrawn( rows );
 
-  TilemapArea visibleTiles = camera.getTiles();
-
-  foreach( Tile* tile, visibleTiles )
+  // FIRST PART: draw all flat land (walkable/boatable)
+  // other layers colorize land by city state, so only simple layer takes it from cache.
+  // Terrain which may be cached is drawn before other flat tiles on both ways,
+  // so picture of land doesn't depend on cache
+  bool useTerrainCache = ( currentLayer->getType() == citylayer::simple );
+  if( useTerrainCache )
+  {
+    terrainCache.draw( *engine, mapOffset );
+  }
+  else
   {
-    tile->resetWasDrawn();
+    for( TilemapCamera::Rows::const_iterator row=rows.begin(); row != rows.end(); row++ )
+    {
+      for( TilemapCamera::Tiles::const_iterator it=row->tiles.begin(); it != row->tiles.end(); it++ )
+      {
+        if( TerrainCache::isCached( **it ) )
+          drawTile( **it );
+      }
+    }
   }
 
-  // FIRST PART: draw all flat land (walkable/boatable)
-  foreach( Tile* tile, visibleTiles )
+  for( TilemapCamera::Rows::const_iterator row=rows.begin(); row != rows.end(); row++ )
   {
-    Tile* master = tile->getMasterTile();
+    for( TilemapCamera::Tiles::const_iterator it=row->tiles.begin(); it != row->tiles.end(); it++ )
+    {
+      Tile* tile = *it;
+      Tile* master = tile->getMasterTile();
 
-    if( !tile->isFlat() )
-      continue;
+      if( !tile->isFlat() || TerrainCache::isCached( *tile ) )
+        continue;
 
-    if( master==NULL )
-    {
-      // single-tile
-      drawTile( *tile );
+      if( master==NULL )
+      {
+        // single-tile
+        drawTile( *tile );
+      }
+      else
+      {
+        // multi-tile: draw the master tile.
+        if( !master->getFlag( Tile::wasDrawn ) )
+          drawTile( *master );
+      }
     }
-    else
-    {
-      // multi-tile: draw the master tile.
-      if( !master->getFlag( Tile::wasDrawn ) )
-        drawTile( *master );
-    }    
-  }  
+  }
 
   // SECOND PART: draw all sprites, impassable land and buildings
-  WalkerList walkerList = getVisibleWalkerList();
+  sortVisibleWalkers( rows );
 
-  foreach( Tile* tile, visibleTiles )
+  for( TilemapCamera::Rows::const_iterator row=rows.begin(); row != rows.end(); row++ )
   {
-    int z = tile->getIJ().getZ();
+    if( row->tiles.empty() )
+      continue;
 
-    if (z != lastZ)
-    {
-      // TODO: pre-sort all animations
-      lastZ = z;
-      drawWalkersBetweenZ( walkerList, z, z+1);
-    }   
+    drawWalkers( row->z+1 );
 
-    drawTileEx( *tile, z );
+    for( TilemapCamera::Tiles::const_iterator it=row->tiles.begin(); it != row->tiles.end(); it++ )
+    {
+      drawTileEx( **it, row->z );
+    }
   }
 }
 
@@ -587,39 +666,97 @@ void CityRenderer::Impl::buildAll()
   }
 }
 
-void CityRenderer::Impl::drawWalkersBetweenZ(WalkerList walkerList, int minZ, int maxZ)
+void CityRenderer::Impl::sortVisibleWalkers( const TilemapCamera::Rows& rows )
 {
-  PicturesArray pictureList;
+  depthStart.clear();
+  depthWalkers.clear();
+  culledWalkers.clear();
 
-  foreach( WalkerPtr walker, walkerList )
+  TilemapCamera::Rows::const_iterator first = rows.begin();
+  while( first != rows.end() && first->tiles.empty() ) { first++; }
+
+  if( first == rows.end() )
+    return;
+
+  TilemapCamera::Rows::const_iterator last = rows.end() - 1;
+  while( last->tiles.empty() ) { last--; }
+
+  // rows go from far to near, walker of depth z is drawn before tiles of depth z-1
+  minDepth = last->z + 1;
+  int maxDepth = first->z + 1;
+  if( maxDepth < minDepth )
   {
-    // TODO: calculate once && sort
-    int zAnim = walker->getIJ().getZ();// getJ() - walker.getI();
-    if( zAnim > minZ && zAnim <= maxZ )
-    {
-      pictureList.clear();
-      walker->getPictureList( pictureList );
-      foreach( Picture& picRef, pictureList )
-      {
-        if( picRef.isValid() )
-        {
-          engine->drawPicture( picRef, walker->getPosition() + mapOffset );
-        }
-      }
-    }
+    std::swap( minDepth, maxDepth );
+  }
+
+  // walker pictures may stand out of its tile
+  const int margin = 120;
+  int minX = -margin - mapOffset.getX();
+  int maxX = engine->getScreenWidth() + margin - mapOffset.getX();
+
+  bool allWalkers = visibleWalkers.count( walker::all ) > 0;
+  depthStart.resize( maxDepth - minDepth + 2, 0 );
+
+  const WalkerList& walkers = city->getWalkerList();
+  for( WalkerList::const_iterator it=walkers.begin(); it != walkers.end(); it++ )
+  {
+    Walker* wlk = it->object();
+    int z = wlk->getIJ().getZ();
+    if( z < minDepth || z > maxDepth )
+      continue;
+
+    int x = wlk->getPosition().getX();
+    if( x < minX || x > maxX )
+      continue;
+
+    if( !allWalkers && visibleWalkers.count( wlk->getType() ) == 0 )
+      continue;
+
+    culledWalkers.push_back( wlk );
+    depthStart[ z - minDepth + 1 ]++;
+  }
+
+  // counting sort, walkers of one depth keep order of city list
+  for( unsigned int k=1; k < depthStart.size(); k++ )
+  {
+    depthStart[ k ] += depthStart[ k-1 ];
   }
+
+  // placing moves start of every bucket to start of next one
+  depthWalkers.resize( culledWalkers.size() );
+  for( std::vector< Walker* >::iterator it=culledWalkers.begin(); it != culledWalkers.end(); it++ )
+  {
+    int z = (*it)->getIJ().getZ();
+    depthWalkers[ depthStart[ z - minDepth ]++ ] = *it;
+  }
+
+  for( int k=depthStart.size()-1; k > 0; k-- )
+  {
+    depthStart[ k ] = depthStart[ k-1 ];
+  }
+  depthStart[ 0 ] = 0;
 }
 
-WalkerList CityRenderer::Impl::getVisibleWalkerList()
+void CityRenderer::Impl::drawWalkers( int z )
 {
-  WalkerList walkerList;
-  foreach( int wtAct, visibleWalkers )
+  int bucket = z - minDepth;
+  if( bucket < 0 || bucket + 1 >= (int)depthStart.size() )
+    return;
+
+  for( int k=depthStart[ bucket ]; k < depthStart[ bucket+1 ]; k++ )
   {
-    WalkerList foundWalkers = city->getWalkers( (walker::Type)wtAct );
-    walkerList.insert( walkerList.end(), foundWalkers.begin(), foundWalkers.end() );
-  }
+    Walker* wlk = depthWalkers[ k ];
 
-  return walkerList;
+    walkerPictures.clear();
+    wlk->getPictureList( walkerPictures );
+    foreach( Picture& picRef, walkerPictures )
+    {
+      if( picRef.isValid() )
+      {
+        engine->drawPicture( picRef, wlk->getPosition() + mapOffset );
+      }
+    }
+  }
 }
 
 void CityRenderer::handleEvent( NEvent& event )
@@ -815,6 +952,7 @@ Signal1< const Tile& >& CityRenderer::onShowTileInfo()
 void CityRenderer::setMode( const TilemapChangeCommandPtr command )
 {
   _d->changeCommand = command;
+  _d->clearDestroyArea();
   _d->startCursorPos = _d->lastCursorPos;
   _d->lmbPressed = false;
 
@@ -830,11 +968,14 @@ void CityRenderer::setMode( const TilemapChangeCommandPtr command )
 
 void CityRenderer::animate(unsigned int time)
 {
-  TilemapArea visibleTiles = _d->camera.getTiles();
+  const TilemapCamera::Rows& rows = _d->camera.getRows();
 
-  foreach( Tile* tile, visibleTiles )
+  for( TilemapCamera::Rows::const_iterator row=rows.begin(); row != rows.end(); row++ )
   {
-    tile->animate( time );
+    for( TilemapCamera::Tiles::const_iterator it=row->tiles.begin(); it != row->tiles.end(); it++ )
+    {
+      (*it)->animate( time );
+    }
   }
 }
 
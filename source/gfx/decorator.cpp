@@ -34,7 +34,7 @@ void PictureDecorator::drawFrame(Picture &dstpic, const Rect& rectangle, const i
    // pics are: 0TopLeft, 1Top, 2TopRight, 3Left, 4Center, 5Right, 6BottomLeft, 7Bottom, 8BottomRight
 
    // draws the inside of the box
-  const Picture& bg = Picture::load( ResourceGroup::panelBackground, picId+4);
+  const Picture& bg = Picture::load( ResourceGroup::idPanelBackground, picId+4);
   const int sw = bg.getWidth();
   const int sh = bg.getHeight();
   for (int j = 0; j<(rectangle.getHeight()/sh-1); ++j)
@@ -46,8 +46,8 @@ void PictureDecorator::drawFrame(Picture &dstpic, const Rect& rectangle, const i
   }
 
   // draws horizontal borders
-  const Picture& topBorder = Picture::load( ResourceGroup::panelBackground, picId+1);
-  const Picture& bottomBorder = Picture::load( ResourceGroup::panelBackground, picId+7);
+  const Picture& topBorder = Picture::load( ResourceGroup::idPanelBackground, picId+1);
+  const Picture& bottomBorder = Picture::load( ResourceGroup::idPanelBackground, picId+7);
   for (int i = 0; i<(rectangle.getWidth()/sw-1); ++i)
   {
      dstpic.draw( topBorder, rectangle.UpperLeftCorner + Point( sw+sw*i, 0 ), useAlpha);
@@ -55,8 +55,8 @@ void PictureDecorator::drawFrame(Picture &dstpic, const Rect& rectangle, const i
   }
 
   // draws vertical borders
-  const Picture& leftBorder = Picture::load( ResourceGroup::panelBackground, picId+3);
-  const Picture& rightBorder = Picture::load( ResourceGroup::panelBackground, picId+5);
+  const Picture& leftBorder = Picture::load( ResourceGroup::idPanelBackground, picId+3);
+  const Picture& rightBorder = Picture::load( ResourceGroup::idPanelBackground, picId+5);
   for (int i = 0; i<(rectangle.getHeight()/sh-1); ++i)
   {
      dstpic.draw( leftBorder, rectangle.UpperLeftCorner + Point( 0, sh+sh*i ), useAlpha );
@@ -64,23 +64,23 @@ void PictureDecorator::drawFrame(Picture &dstpic, const Rect& rectangle, const i
   }
 
   // topLeft corner
-  dstpic.draw(Picture::load( ResourceGroup::panelBackground, picId+0), rectangle.UpperLeftCorner, useAlpha );
+  dstpic.draw(Picture::load( ResourceGroup::idPanelBackground, picId+0), rectangle.UpperLeftCorner, useAlpha );
   // topRight corner
-  dstpic.draw(Picture::load( ResourceGroup::panelBackground, picId+2), Point( rectangle.getRight()-sh, rectangle.getTop() ), useAlpha );
+  dstpic.draw(Picture::load( ResourceGroup::idPanelBackground, picId+2), Point( rectangle.getRight()-sh, rectangle.getTop() ), useAlpha );
   // bottomLeft corner
-  dstpic.draw(Picture::load( ResourceGroup::panelBackground, picId+6), Point( rectangle.getLeft(), rectangle.getBottom() - sh ), useAlpha );
+  dstpic.draw(Picture::load( ResourceGroup::idPanelBackground, picId+6), Point( rectangle.getLeft(), rectangle.getBottom() - sh ), useAlpha );
   // bottomRight corner
-  dstpic.draw(Picture::load( ResourceGroup::panelBackground, picId+8), rectangle.LowerRightCorner - Point( 16, 16 ), useAlpha );
+  dstpic.draw(Picture::load( ResourceGroup::idPanelBackground, picId+8), rectangle.LowerRightCorner - Point( 16, 16 ), useAlpha );
 }
 
 void PictureDecorator::drawBorder(Picture &dstpic, const Rect& rectangle, const int offset, bool useAlpha)
 {
   // pics are: 0TopLeft, 1Top, 2TopRight, 3Right, 4BottomRight, 5Bottom, 6BottomLeft, 7Left
   // draws horizontal borders
-  const Picture& topborder = Picture::load( ResourceGroup::panelBackground, offset+1);
+  const Picture& topborder = Picture::load( ResourceGroup::idPanelBackground, offset+1);
   const int sw = topborder.getWidth();
   const int sh = topborder.getHeight();
-  const Picture& bottomBorder = Picture::load( ResourceGroup::panelBackground, offset+5);
+  const Picture& bottomBorder = Picture::load( ResourceGroup::idPanelBackground, offset+5);
   for (int i = 0; i<(rectangle.getWidth()/sw-1); ++i)
   {
      dstpic.draw( topborder, rectangle.UpperLeftCorner + Point( sw+sw*i, 0 ), useAlpha);
@@ -88,8 +88,8 @@ void PictureDecorator::drawBorder(Picture &dstpic, const Rect& rectangle, const
   }
 
   // draws vertical borders
-  const Picture& leftborder = Picture::load( ResourceGroup::panelBackground, offset+7);
-  const Picture& rightborder = Picture::load( ResourceGroup::panelBackground, offset+3);
+  const Picture& leftborder = Picture::load( ResourceGroup::idPanelBackground, offset+7);
+  const Picture& rightborder = Picture::load( ResourceGroup::idPanelBackground, offset+3);
   for (int i = 0; i<(rectangle.getHeight()/sh-1); ++i)
   {
      dstpic.draw( leftborder, rectangle.UpperLeftCorner + Point( 0, sh+sh*i ), useAlpha );
@@ -97,29 +97,29 @@ void PictureDecorator::drawBorder(Picture &dstpic, const Rect& rectangle, const
   }
 
   // topLeft corner
-  dstpic.draw( Picture::load( ResourceGroup::panelBackground, offset+0), rectangle.UpperLeftCorner, useAlpha);
+  dstpic.draw( Picture::load( ResourceGroup::idPanelBackground, offset+0), rectangle.UpperLeftCorner, useAlpha);
   // topRight corner
-  dstpic.draw(Picture::load( ResourceGroup::panelBackground, offset+2), rectangle.getRight()-sw, rectangle.getTop(), useAlpha );
+  dstpic.draw(Picture::load( ResourceGroup::idPanelBackground, offset+2), rectangle.getRight()-sw, rectangle.getTop(), useAlpha );
   // bottomLeft corner
-  dstpic.draw(Picture::load( ResourceGroup::panelBackground, offset+6), rectangle.getLeft(), rectangle.getBottom()-sh, useAlpha);
+  dstpic.draw(Picture::load( ResourceGroup::idPanelBackground, offset+6), rectangle.getLeft(), rectangle.getBottom()-sh, useAlpha);
   // bottomRight corner
-  dstpic.draw(Picture::load( ResourceGroup::panelBackground, offset+4), rectangle.getRight()-16, rectangle.getBottom()-sh, useAlpha);
+  dstpic.draw(Picture::load( ResourceGroup::idPanelBackground, offset+4), rectangle.getRight()-16, rectangle.getBottom()-sh, useAlpha);
 }
 
 void PictureDecorator::drawPanel( Picture &dstpic, const Rect& rectangle, int picId, bool useAlpha )
 {
   // left side
-  dstpic.draw( Picture::load( ResourceGroup::panelBackground, picId), rectangle.UpperLeftCorner );
+  dstpic.draw( Picture::load( ResourceGroup::idPanelBackground, picId), rectangle.UpperLeftCorner );
 
   // draws the inside
-  const Picture& centerPic = Picture::load( ResourceGroup::panelBackground, picId+1);
+  const Picture& centerPic = Picture::load( ResourceGroup::idPanelBackground, picId+1);
   for (int i = 0; i<(rectangle.getWidth()/16-1); ++i)
   {
     dstpic.draw( centerPic, rectangle.UpperLeftCorner + Point( 16+16*i, 0 ), useAlpha );
   }
 
   // right side
-  dstpic.draw( Picture::load( ResourceGroup::panelBackground, picId+2), 
+  dstpic.draw( Picture::load( ResourceGroup::idPanelBackground, picId+2), 
                rectangle.UpperLeftCorner + Point( rectangle.getWidth()-16, 0) );
 }
 
@@ -162,28 +162,28 @@ void PictureDecorator::drawBorder( Picture &dstpic, const Rect& rectangle,
                                    int ltc, int lbc, int rtc, int rbc, bool useAlpha )
 {
   // draws horizontal borders
-  Size size = Picture::load( ResourceGroup::panelBackground, tp ).getSize();
+  Size size = Picture::load( ResourceGroup::idPanelBackground, tp ).getSize();
   const int sw = size.getWidth();
   const int sh = size.getHeight();
   for (int i = 0; i<(rectangle.getWidth()/size.getWidth()-1); ++i)
   {
     Point offset = rectangle.UpperLeftCorner + Point( sw+sw*i, 0 );
-    dstpic.draw( Picture::load( ResourceGroup::panelBackground, tp+i%pCount), offset, useAlpha );      // top border
-    dstpic.draw( Picture::load( ResourceGroup::panelBackground, bp+i%pCount), offset + Point( 0, rectangle.getHeight()-sh ), useAlpha );      // bottom border
+    dstpic.draw( Picture::load( ResourceGroup::idPanelBackground, tp+i%pCount), offset, useAlpha );      // top border
+    dstpic.draw( Picture::load( ResourceGroup::idPanelBackground, bp+i%pCount), offset + Point( 0, rectangle.getHeight()-sh ), useAlpha );      // bottom border
   }
 
   // draws vertical borders
   for (int i = 0; i<(rectangle.getHeight()/size.getHeight()-1); ++i)
   {
     Point offset = rectangle.UpperLeftCorner + Point( 0, sh+sh*i );
-    dstpic.draw( Picture::load( ResourceGroup::panelBackground, lp+hCount*(i%pCount)), offset, useAlpha );      // left border
-    dstpic.draw( Picture::load( ResourceGroup::panelBackground, rp+hCount*(i%pCount)), offset + Point( rectangle.getWidth()-sw, 0 ), useAlpha );      // right border
+    dstpic.draw( Picture::load( ResourceGroup::idPanelBackground, lp+hCount*(i%pCount)), offset, useAlpha );      // left border
+    dstpic.draw( Picture::load( ResourceGroup::idPanelBackground, rp+hCount*(i%pCount)), offset + Point( rectangle.getWidth()-sw, 0 ), useAlpha );      // right border
   }
 
-  dstpic.draw( Picture::load( ResourceGroup::panelBackground, ltc), rectangle.UpperLeftCorner );    // left-top corner
-  dstpic.draw( Picture::load( ResourceGroup::panelBackground, lbc), Point( rectangle.getLeft(), rectangle.getBottom()-sh ), useAlpha );    // left-bottom corner
-  dstpic.draw( Picture::load( ResourceGroup::panelBackground, rtc ), Point( rectangle.getRight() - sw, rectangle.getTop() ), useAlpha );     // right-top corner
-  dstpic.draw( Picture::load( ResourceGroup::panelBackground, rbc), rectangle.LowerRightCorner - Point( sw, sh ), useAlpha );    // right-bottom corner
+  dstpic.draw( Picture::load( ResourceGroup::idPanelBackground, ltc), rectangle.UpperLeftCorner );    // left-top corner
+  dstpic.draw( Picture::load( ResourceGroup::idPanelBackground, lbc), Point( rectangle.getLeft(), rectangle.getBottom()-sh ), useAlpha );    // left-bottom corner
+  dstpic.draw( Picture::load( ResourceGroup::idPanelBackground, rtc ), Point( rectangle.getRight() - sw, rectangle.getTop() ), useAlpha );     // right-top corner
+  dstpic.draw( Picture::load( ResourceGroup::idPanelBackground, rbc), rectangle.LowerRightCorner - Point( sw, sh ), useAlpha );    // right-bottom corner
 }
 
 void PictureDecorator::drawArea(Picture &dstpic, const Rect& rectangle, int picId, int picCount, int offset, bool useAlpha)
@@ -193,7 +193,7 @@ void PictureDecorator::drawArea(Picture &dstpic, const Rect& rectangle, int picI
     for (int i = 0; i<(rectangle.getWidth()/16+1); ++i)
     {
       // use some clipping to remove the right and bottom areas
-      const Picture &srcpic = Picture::load( ResourceGroup::panelBackground, picId + (i%picCount) + offset*(j%picCount) );
+      const Picture &srcpic = Picture::load( ResourceGroup::idPanelBackground, picId + (i%picCount) + offset*(j%picCount) );
 
       int dx = 16*i;
       int dy = 16*j;
@@ -32,7 +32,7 @@ public:
   typedef Size Mode;
   typedef std::vector<Size> Modes;
 
-  typedef enum { fullscreen=0, debugInfo } Flags;
+  typedef enum { fullscreen=0, debugInfo, rleSprites } Flags;
   static GfxEngine& instance();
 
   GfxEngine();
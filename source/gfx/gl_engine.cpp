@@ -20,20 +20,276 @@
 
 #include <cstdlib>
 #include <string>
-#include <sstream>
-#include <iostream>
 #include <vector>
+#include <map>
+#include <algorithm>
 #include <SDL.h>
+#include <SDL_opengl.h>
 #include <SDL_ttf.h>
 
 #include "core/exception.hpp"
+#include "core/logger.hpp"
+#include "core/rectangle.hpp"
 #include "picture.hpp"
 #include "core/position.hpp"
 #include "core/eventconverter.hpp"
+#include "core/time.hpp"
 
+namespace {
 
-GfxGlEngine::GfxGlEngine() : GfxEngine()
+// Collects quads of the same texture into vertex arrays and draws them by one call
+class SpriteBatch
 {
+public:
+  GLuint texture;
+  std::vector< GLfloat > vertices;
+  std::vector< GLfloat > texCoords;
+
+  SpriteBatch() : texture( 0 ) {}
+
+  void append( GLuint quadTexture, float x0, float y0, float x1, float y1, const RectF& rect )
+  {
+    if( quadTexture != texture )
+    {
+      flush();
+      texture = quadTexture;
+    }
+
+    const GLfloat v[8] = { x0, y0, x1, y0, x1, y1, x0, y1 };
+    const GLfloat t[8] = { rect.getLeft(), rect.getTop(), rect.getRight(), rect.getTop(),
+                           rect.getRight(), rect.getBottom(), rect.getLeft(), rect.getBottom() };
+
+    vertices.insert( vertices.end(), v, v + 8 );
+    texCoords.insert( texCoords.end(), t, t + 8 );
+  }
+
+  void flush()
+  {
+    if( vertices.empty() )
+      return;
+
+    glBindTexture( GL_TEXTURE_2D, texture );
+    glVertexPointer( 2, GL_FLOAT, 0, &vertices[0] );
+    glTexCoordPointer( 2, GL_FLOAT, 0, &texCoords[0] );
+    glDrawArrays( GL_QUADS, 0, (GLsizei)(vertices.size() / 2) );
+
+    vertices.clear();
+    texCoords.clear();
+  }
+
+  // pending quads must be drawn with old pixels, before texture is changed
+  void flush( GLuint changedTexture )
+  {
+    if( changedTexture == texture )
+    {
+      flush();
+    }
+  }
+};
+
+// Packs pictures into big textures, every resource group (land1a, housing, citizen01...)
+// gets own pages, so neighbour draws mostly use the same texture.
+// Pictures are placed by shelves: left to right in rows, row height is the
+// highest picture of row.
+class TextureAtlas
+{
+public:
+  struct Page
+  {
+    GLuint texture;
+    int x, y;       // place for next picture
+    int rowHeight;
+  };
+
+  typedef std::vector< Page > Pages;
+  typedef std::map< std::string, Pages > Groups;
+
+  struct Entry
+  {
+    GLuint texture;
+    int x, y;                 // place on texture in pixels
+    RectF rect;
+    bool own;
+    unsigned int revision;    // revision of picture when it was uploaded
+  };
+
+  // copies of picture share uid, new surface on the same address gets other uid
+  typedef std::map< unsigned int, Entry > Entries;
+
+  static const int padding = 1;
+
+  int pageSize;
+  Groups groups;
+  Entries entries;
+  SpriteBatch* batch;
+
+  TextureAtlas() : pageSize( 1024 ), batch( 0 ) {}
+
+  void init( SpriteBatch& spriteBatch )
+  {
+    GLint maxSize = 0;
+    glGetIntegerv( GL_MAX_TEXTURE_SIZE, &maxSize );
+    pageSize = std::min( 2048, std::max( 256, (int)maxSize ) );
+    batch = &spriteBatch;
+  }
+
+  // group is name of picture before index, "land1a_00001" belongs to "land1a"
+  static std::string getGroup( const std::string& name )
+  {
+    std::string::size_type pos = name.rfind( '_' );
+    return pos == std::string::npos ? name : name.substr( 0, pos );
+  }
+
+  static GLuint createTexture( int width, int height, const void* pixels )
+  {
+    GLuint texture = 0;
+    glGenTextures( 1, &texture );
+    glBindTexture( GL_TEXTURE_2D, texture );
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST );
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST );
+    glTexImage2D( GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_BGRA, GL_UNSIGNED_BYTE, pixels );
+
+    return texture;
+  }
+
+  void upload( const Entry& entry, SDL_Surface* surface )
+  {
+    if( batch )
+    {
+      batch->flush( entry.texture );
+    }
+
+    glBindTexture( GL_TEXTURE_2D, entry.texture );
+    SDL_LockSurface( surface );
+    glPixelStorei( GL_UNPACK_ROW_LENGTH, surface->pitch / surface->format->BytesPerPixel );
+    glTexSubImage2D( GL_TEXTURE_2D, 0, entry.x, entry.y, surface->w, surface->h,
+                     GL_BGRA, GL_UNSIGNED_BYTE, surface->pixels );
+    glPixelStorei( GL_UNPACK_ROW_LENGTH, 0 );
+    SDL_UnlockSurface( surface );
+  }
+
+  // finds place for picture on last page of group, opens new page when it is full
+  Page& findPlace( Pages& pages, int width, int height )
+  {
+    if( !pages.empty() )
+    {
+      Page& page = pages.back();
+      if( page.x + width > pageSize )
+      {
+        page.x = 0;
+        page.y += page.rowHeight + padding;
+        page.rowHeight = 0;
+      }
+
+      if( page.y + height <= pageSize )
+      {
+        return page;
+      }
+    }
+
+    Page page;
+    page.texture = createTexture( pageSize, pageSize, 0 );
+    page.x = 0;
+    page.y = 0;
+    page.rowHeight = 0;
+    pages.push_back( page );
+
+    return pages.back();
+  }
+
+  Entry append( const Picture& picture )
+  {
+    SDL_Surface* surface = picture.getSurface();
+    Entry entry;
+
+    if( picture.getName().empty() || surface->w > pageSize || surface->h > pageSize )
+    {
+      // runtime pictures and big backgrounds get own texture
+      entry.texture = createTexture( surface->w, surface->h, 0 );
+      entry.x = 0;
+      entry.y = 0;
+      entry.rect = RectF( 0.f, 0.f, 1.f, 1.f );
+      entry.own = true;
+    }
+    else
+    {
+      Page& page = findPlace( groups[ getGroup( picture.getName() ) ], surface->w, surface->h );
+
+      float k = 1.f / pageSize;
+      entry.texture = page.texture;
+      entry.x = page.x;
+      entry.y = page.y;
+      entry.own = false;
+      entry.rect = RectF( page.x * k, page.y * k, (page.x + surface->w) * k, (page.y + surface->h) * k );
+
+      page.x += surface->w + padding;
+      page.rowHeight = std::max( page.rowHeight, surface->h );
+    }
+
+    upload( entry, surface );
+    entry.revision = picture.getRevision();
+
+    return entry;
+  }
+
+  // sets texture of picture, packs it on first use.
+  // pictures drawn into after upload are uploaded again on the same place
+  void bind( const Picture& picture )
+  {
+    Entries::iterator it = entries.find( picture.getUid() );
+    if( it == entries.end() )
+    {
+      it = entries.insert( std::make_pair( picture.getUid(), append( picture ) ) ).first;
+    }
+    else if( it->second.revision != picture.getRevision() )
+    {
+      upload( it->second, picture.getSurface() );
+      it->second.revision = picture.getRevision();
+    }
+
+    picture.getGlTextureID() = it->second.texture;
+    picture.getGlTextureRect() = it->second.rect;
+  }
+
+  void remove( const Picture& picture )
+  {
+    Entries::iterator it = entries.find( picture.getUid() );
+    if( it == entries.end() )
+      return;
+
+    // place on atlas page isn't reused, own textures are deleted
+    if( it->second.own )
+    {
+      if( batch )
+      {
+        batch->flush( it->second.texture );
+      }
+
+      glDeleteTextures( 1, &it->second.texture );
+    }
+
+    entries.erase( it );
+  }
+};
+
+}
+
+class GfxGlEngine::Impl
+{
+public:
+  SDL_Surface* screen;
+  TextureAtlas atlas;
+  SpriteBatch batch;
+  unsigned int fps, lastFps;
+  unsigned int lastUpdateFps;
+};
+
+GfxGlEngine::GfxGlEngine() : GfxEngine(), _d( new Impl )
+{
+  _d->screen = NULL;
+  _d->fps = 0;
+  _d->lastFps = 0;
+  _d->lastUpdateFps = 0;
 }
 
 GfxGlEngine::~GfxGlEngine()
@@ -42,6 +298,9 @@ GfxGlEngine::~GfxGlEngine()
 
 void GfxGlEngine::init()
 {
+   _d->lastUpdateFps = DateTime::getElapsedTime();
+   _d->fps = 0;
+
    int rc;
    rc = SDL_Init(SDL_INIT_VIDEO);
    if (rc != 0) THROW("Unable to initialize SDL: " << SDL_GetError());
@@ -50,8 +309,11 @@ void GfxGlEngine::init()
 
    SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 0);
 
-   _screen = SDL_SetVideoMode( _srcSize.getWidth(), _srcSize.getHeight(), 32, SDL_OPENGL | SDL_FULLSCREEN);
-   if( _screen == NULL )
+   unsigned int flags = SDL_OPENGL;
+   flags |= (getFlag( GfxEngine::fullscreen ) > 0 ? SDL_FULLSCREEN : 0);
+
+   _d->screen = SDL_SetVideoMode( _srcSize.getWidth(), _srcSize.getHeight(), 32, flags );
+   if( _d->screen == NULL )
    {
        THROW("Unable to set video mode: " << SDL_GetError());
    }
@@ -72,6 +334,11 @@ void GfxGlEngine::init()
 
    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
    glEnable(GL_BLEND);
+
+   glEnableClientState( GL_VERTEX_ARRAY );
+   glEnableClientState( GL_TEXTURE_COORD_ARRAY );
+
+   _d->atlas.init( _d->batch );
 }
 
 
@@ -84,8 +351,7 @@ void GfxGlEngine::exit()
 
 void GfxGlEngine::unloadPicture(Picture &ioPicture)
 {
-  const GLuint& texture = (GLuint)ioPicture.getGlTextureID();
-  glDeleteTextures(1, &texture );
+  _d->atlas.remove( ioPicture );
   SDL_FreeSurface(ioPicture.getSurface());
 
   ioPicture = Picture();
@@ -93,113 +359,100 @@ void GfxGlEngine::unloadPicture(Picture &ioPicture)
 
 void GfxGlEngine::loadPicture(Picture& ioPicture)
 {
-   GLuint& texture(ioPicture.getGlTextureID());
-   SDL_Surface *surface = ioPicture.getSurface();
-   GLenum texture_format;
-   GLint nOfColors;
-
-   // SDL_Surface *surface2
-   // get the number of channels in the SDL surface
-   nOfColors = surface->format->BytesPerPixel;
-   if (nOfColors == 4)     // contains an alpha channel
-   {
-      if (surface->format->Rmask == 0x000000ff)
-         texture_format = GL_RGBA;
-      else
-         texture_format = GL_BGRA;
-   }
-   else if (nOfColors == 3)     // no alpha channel
-   {
-      if (surface->format->Rmask == 0x000000ff)
-         texture_format = GL_RGB;
-      else
-         texture_format = GL_BGR;
-   }
-   else
-   {
-      THROW("Invalid image format");
-   }
+  // pixels are written to surface after loading, so texture is
+  // filled on first drawing, when picture is already named by its resource
+  ioPicture.getGlTextureID() = 0;
+}
 
-   if (texture == 0)
-   {
-      // the picture has no texture ID!
-      // generate a texture ID
-      glGenTextures( 1, &texture );
-   }
+void GfxGlEngine::deletePicture( Picture* pic )
+{
+  if( pic )
+    unloadPicture( *pic );
+}
 
-   // Bind the texture object
-   glBindTexture( GL_TEXTURE_2D, texture );
+Picture* GfxGlEngine::createPicture( const Size& size )
+{
+  // memory order is BGRA, so surface goes to GL without conversion
+  SDL_Surface* img = SDL_CreateRGBSurface( SDL_SWSURFACE, size.getWidth(), size.getHeight(), 32,
+                                           0x00ff0000, 0x0000ff00, 0x000000ff, 0xff000000 );
+  if (img == NULL)
+  {
+    THROW( "Cannot make surface, size=" << size.getWidth() << "x" << size.getHeight() );
+  }
 
-   // Set the texture's stretching properties
-   glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST );
-   glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST );
+  Picture *pic = new Picture();
+  pic->init(img, Point( 0, 0 ));  // no offset
 
-   // Edit the texture object's image data using the information SDL_Surface gives us
-   ioPicture.lock();
-   glTexImage2D( GL_TEXTURE_2D, 0, nOfColors, surface->w, surface->h, 0,
-                 texture_format, GL_UNSIGNED_BYTE, surface->pixels );
-   ioPicture.unlock();
+  return pic;
 }
 
-
-void GfxGlEngine::init_frame()
+void GfxGlEngine::startRenderFrame()
 {
    glClear(GL_COLOR_BUFFER_BIT);  // black screen
 }
 
 
-void GfxGlEngine::exit_frame()
+void GfxGlEngine::endRenderFrame()
 {
+   _d->batch.flush();
    SDL_GL_SwapBuffers(); //Refresh the screen
+   _d->fps++;
+
+   if( DateTime::getElapsedTime() - _d->lastUpdateFps > 1000 )
+   {
+     _d->lastUpdateFps = DateTime::getElapsedTime();
+     _d->lastFps = _d->fps;
+     _d->fps = 0;
+   }
 }
 
 
 void GfxGlEngine::drawPicture(const Picture &picture, const int dx, const int dy, Rect* clipRect)
 {
-   GLuint aTextureID = picture.getGlTextureID();
+   if( !picture.isValid() )
+     return;
+
+   // any picture may be drawn into after its first drawing, so revision is checked every time
+   _d->atlas.bind( picture );
+
    float x0 = (float)( dx+picture.getOffset().getX());
    float x1 = x0+picture.getWidth();
    float y0 = (float)(dy-picture.getOffset().getY());
    float y1 = y0+picture.getHeight();
 
+   if( clipRect != 0 )
+   {
+     _d->batch.flush();
+     glEnable( GL_SCISSOR_TEST );
+     glScissor( clipRect->getLeft(), _srcSize.getHeight() - clipRect->getBottom(),
+                clipRect->getWidth(), clipRect->getHeight() );
+   }
 
-   // Bind the texture to which subsequent calls refer to
-   glBindTexture( GL_TEXTURE_2D, aTextureID);
-
-   glBegin( GL_QUADS );
-
-   //Bottom-left vertex (corner)
-   glTexCoord2i( 0, 0 );
-   glVertex2f( x0, y0 );
-
-   //Bottom-right vertex (corner)
-   glTexCoord2i( 1, 0 );
-   glVertex2f( x1, y0 );
-
-   //Top-right vertex (corner)
-   glTexCoord2i( 1, 1 );
-   glVertex2f( x1, y1 );
-
-   //Top-left vertex (corner)
-   glTexCoord2i( 0, 1 );
-   glVertex2f( x0, y1 );
+   _d->batch.append( picture.getGlTextureID(), x0, y0, x1, y1, picture.getGlTextureRect() );
 
-   glEnd();
+   if( clipRect != 0 )
+   {
+     _d->batch.flush();
+     glDisable( GL_SCISSOR_TEST );
+   }
 }
 
 void GfxGlEngine::drawPicture( const Picture &picture, const Point& pos, Rect* clipRect )
 {
-  drawPicture( picture, pos.getX(), pos.getY() );
+  drawPicture( picture, pos.getX(), pos.getY(), clipRect );
 }
 
 void GfxGlEngine::setTileDrawMask( int rmask, int gmask, int bmask, int amask )
 {
-
+  // masked channels are kept, other ones are dropped by vertex color
+  _d->batch.flush();
+  glColor4f( rmask ? 1.f : 0.f, gmask ? 1.f : 0.f, bmask ? 1.f : 0.f, amask ? 1.f : 0.f );
 }
 
 void GfxGlEngine::resetTileDrawMask()
 {
-
+  _d->batch.flush();
+  glColor4f( 1.f, 1.f, 1.f, 1.f );
 }
 
 void GfxGlEngine::createScreenshot( const std::string& filename )
@@ -209,7 +462,7 @@ void GfxGlEngine::createScreenshot( const std::string& filename )
 
 unsigned int GfxGlEngine::getFps() const
 {
-  return 0;
+  return _d->lastFps;
 }
 
 void GfxGlEngine::delay( const unsigned int msec )
@@ -20,16 +20,13 @@
 #define GFX_GL_ENGINE_HPP
 
 #include "engine.hpp"
-
-#include <list>
-#include <vector>
-#include <SDL.h>
-#include <SDL_opengl.h>
-
+#include "core/scopedptr.hpp"
 #include "picture.hpp"
 
 // This is the OpenGL engine
-// It does a dumb drawing from back to front, in a 2D projection, with no depth buffer
+// It does a dumb drawing from back to front, in a 2D projection, with no depth buffer.
+// Pictures of resource groups are packed into atlas pages, quads are collected
+// into vertex arrays and sent to GL only when texture or state changes.
 class GfxGlEngine : public GfxEngine
 {
 public:
@@ -41,11 +38,14 @@ public:
 
    virtual void loadPicture(Picture &ioPicture);
    virtual void unloadPicture(Picture &ioPicture);
+   virtual void deletePicture( Picture* pic );
+   virtual Picture* createPicture(const Size& size );
+
+   virtual void startRenderFrame();
+   virtual void endRenderFrame();
 
-   void init_frame();
    void drawPicture(const Picture &picture, const int dx, const int dy, Rect* clipRect=0);
    void drawPicture(const Picture &picture, const Point& pos, Rect* clipRect=0 );
-   void exit_frame();
 
    void setTileDrawMask( int rmask, int gmask, int bmask, int amask );
    void resetTileDrawMask();
@@ -57,7 +57,8 @@ public:
    Modes getAvailableModes() const;
 
 private:
-   SDL_Surface *_screen;
+   class Impl;
+   ScopedPtr< Impl > _d;
 };
 
 #endif
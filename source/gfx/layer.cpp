@@ -31,7 +31,7 @@ void Layer::drawTilePass( GfxEngine& engine, Tile& tile, Point offset, Renderer:
   }
 }
 
-void Layer::drawArea( GfxEngine& engine, const TilemapArea& area, Point offset, std::string resourceGroup, int tileId)
+void Layer::drawArea( GfxEngine& engine, const TilemapArea& area, Point offset, ResourceGroup::Id group, int tileId)
 {
   Tile* baseTile = area.front();
   TileOverlayPtr overlay = baseTile->getOverlay();
@@ -43,17 +43,17 @@ void Layer::drawArea( GfxEngine& engine, const TilemapArea& area, Point offset,
     Tile* tile = *it;
     int tileBorders = ( tile->getI() == leftBorderAtI ? 0 : OverlayPic::skipLeftBorder )
                       + ( tile->getJ() == rightBorderAtJ ? 0 : OverlayPic::skipRightBorder );
-    pic = &Picture::load(resourceGroup, tileBorders + tileId);
+    pic = &Picture::load( group, tileBorders + tileId );
     engine.drawPicture( *pic, tile->getXY() + offset );
   }
 }
 
 void Layer::drawColumn( GfxEngine& engine, const Point& pos, const int startPicId, const int percent)
 {
-  engine.drawPicture( Picture::load( ResourceGroup::sprites, startPicId + 2 ), pos + Point( 5, 15 ) );
+  engine.drawPicture( Picture::load( ResourceGroup::idSprites, startPicId + 2 ), pos + Point( 5, 15 ) );
 
   int roundPercent = ( percent / 10 ) * 10;
-  Picture& pic = Picture::load( ResourceGroup::sprites, startPicId + 1 );
+  Picture& pic = Picture::load( ResourceGroup::idSprites, startPicId + 1 );
   for( int offsetY=10; offsetY < roundPercent; offsetY += 10 )
   {
     engine.drawPicture( pic, pos - Point( -13, -5 + offsetY ) );
@@ -61,6 +61,6 @@ void Layer::drawColumn( GfxEngine& engine, const Point& pos, const int startPicI
 
   if( percent >= 10 )
   {
-    engine.drawPicture( Picture::load( ResourceGroup::sprites, startPicId ), pos - Point( -1, -6 + roundPercent ) );
+    engine.drawPicture( Picture::load( ResourceGroup::idSprites, startPicId ), pos - Point( -1, -6 + roundPercent ) );
   }
 }
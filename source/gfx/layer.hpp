@@ -34,7 +34,7 @@ public:
   virtual void drawTile( GfxEngine& engine, Tile& tile, Point offset ) = 0;
   virtual void drawTilePass(GfxEngine& engine, Tile& tile, Point offset, Renderer::Pass pass );
   virtual void drawArea( GfxEngine& engine, const TilemapArea& area, Point offset,
-                             std::string resourceGroup, int tileId );
+                             ResourceGroup::Id group, int tileId );
 
   virtual void drawColumn(GfxEngine& engine, const Point& pos, const int startPicId, const int percent );
 };
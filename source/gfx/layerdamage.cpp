@@ -69,7 +69,7 @@ void LayerDamage::drawTile(GfxEngine& engine, Tile& tile, Point offset)
         needDrawAnimations = (house->getSpec().getLevel() == 1) && (house->getHabitants().size() == 0);
 
         CityHelper helper( _city );
-        drawArea( engine, helper.getArea( overlay ), offset, ResourceGroup::foodOverlay, OverlayPic::inHouseBase );
+        drawArea( engine, helper.getArea( overlay ), offset, ResourceGroup::idFoodOverlay, OverlayPic::inHouseBase );
       }
       break;
 
@@ -83,7 +83,7 @@ void LayerDamage::drawTile(GfxEngine& engine, Tile& tile, Point offset)
         }
 
         CityHelper helper( _city );
-        drawArea( engine, helper.getArea( overlay ), offset, ResourceGroup::foodOverlay, OverlayPic::base );
+        drawArea( engine, helper.getArea( overlay ), offset, ResourceGroup::idFoodOverlay, OverlayPic::base );
       }
       break;
     }
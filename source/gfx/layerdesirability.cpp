@@ -48,7 +48,7 @@ void LayerDesirability::drawTile(GfxEngine& engine, Tile& tile, Point offset)
       int picOffset = tile.getDesirability() < 0
                           ? math::clamp( tile.getDesirability() / 25, -3, 0 )
                           : math::clamp( tile.getDesirability() / 15, 0, 6 );
-      Picture& pic = Picture::load( ResourceGroup::land2a, 37 + picOffset );
+      Picture& pic = Picture::load( ResourceGroup::idLand2a, 37 + picOffset );
 
       engine.drawPicture( pic, screenPos );
     }
@@ -75,7 +75,7 @@ void LayerDesirability::drawTile(GfxEngine& engine, Tile& tile, Point offset)
         int picOffset = tile.getDesirability() < 0
                           ? math::clamp( tile.getDesirability() / 25, -3, 0 )
                           : math::clamp( tile.getDesirability() / 15, 0, 6 );
-        Picture& pic = Picture::load( ResourceGroup::land2a, 37 + picOffset );
+        Picture& pic = Picture::load( ResourceGroup::idLand2a, 37 + picOffset );
 
         CityHelper helper( _city );
         TilemapTiles tiles4clear = helper.getArea( overlay );
@@ -73,7 +73,7 @@ void LayerEntertainment::drawTile(GfxEngine& engine, Tile& tile, Point offset)
       else
       {
         CityHelper helper( _city );
-        drawArea( engine, helper.getArea( overlay ), offset, ResourceGroup::foodOverlay, OverlayPic::base );
+        drawArea( engine, helper.getArea( overlay ), offset, ResourceGroup::idFoodOverlay, OverlayPic::base );
       }
     break;
 
@@ -89,7 +89,7 @@ void LayerEntertainment::drawTile(GfxEngine& engine, Tile& tile, Point offset)
 
         needDrawAnimations = (house->getSpec().getLevel() == 1) && (house->getHabitants().size() == 0);
         CityHelper helper( _city );
-        drawArea( engine, helper.getArea( overlay ), offset, ResourceGroup::foodOverlay, OverlayPic::inHouseBase );
+        drawArea( engine, helper.getArea( overlay ), offset, ResourceGroup::idFoodOverlay, OverlayPic::inHouseBase );
       }
     break;
 
@@ -97,7 +97,7 @@ void LayerEntertainment::drawTile(GfxEngine& engine, Tile& tile, Point offset)
     default:
       {
         CityHelper helper( _city );
-        drawArea( engine, helper.getArea( overlay ), offset, ResourceGroup::foodOverlay, OverlayPic::base );
+        drawArea( engine, helper.getArea( overlay ), offset, ResourceGroup::idFoodOverlay, OverlayPic::base );
       }
     break;
     }
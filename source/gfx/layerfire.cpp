@@ -75,7 +75,7 @@ void LayerFire::drawTile(GfxEngine& engine, Tile& tile, Point offset)
         needDrawAnimations = (house->getSpec().getLevel() == 1) && (house->getHabitants().size() ==0);
 
         CityHelper helper( _city );
-        drawArea( engine, helper.getArea( overlay ), offset, ResourceGroup::foodOverlay, OverlayPic::inHouseBase  );
+        drawArea( engine, helper.getArea( overlay ), offset, ResourceGroup::idFoodOverlay, OverlayPic::inHouseBase  );
       }
     break;
 
@@ -89,7 +89,7 @@ void LayerFire::drawTile(GfxEngine& engine, Tile& tile, Point offset)
         }
 
         CityHelper helper( _city );
-        drawArea( engine, helper.getArea( overlay ), offset, ResourceGroup::foodOverlay, OverlayPic::base  );
+        drawArea( engine, helper.getArea( overlay ), offset, ResourceGroup::idFoodOverlay, OverlayPic::base  );
       }
     break;
     }
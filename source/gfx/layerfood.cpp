@@ -70,7 +70,7 @@ void LayerFood::drawTile(GfxEngine& engine, Tile& tile, Point offset)
     case building::house:
       {
         CityHelper helper( _city );
-        drawArea( engine, helper.getArea( overlay ), offset, ResourceGroup::foodOverlay, OverlayPic::inHouseBase );
+        drawArea( engine, helper.getArea( overlay ), offset, ResourceGroup::idFoodOverlay, OverlayPic::inHouseBase );
         HousePtr house = overlay.as< House >();
         foodLevel = house->getFoodLevel();
         needDrawAnimations = (house->getSpec().getLevel() == 1) && (house->getHabitants().size() == 0);
@@ -81,7 +81,7 @@ void LayerFood::drawTile(GfxEngine& engine, Tile& tile, Point offset)
     default:
       {
         CityHelper helper( _city );
-        drawArea( engine, helper.getArea( overlay ), offset, ResourceGroup::foodOverlay, OverlayPic::base);
+        drawArea( engine, helper.getArea( overlay ), offset, ResourceGroup::idFoodOverlay, OverlayPic::base);
       }
       break;
     }
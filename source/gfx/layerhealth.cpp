@@ -70,7 +70,7 @@ void LayerHealth::drawTile(GfxEngine& engine, Tile& tile, Point offset)
       else
       {
         CityHelper helper( _city );
-        drawArea( engine, helper.getArea( overlay ), offset, ResourceGroup::foodOverlay, OverlayPic::base );
+        drawArea( engine, helper.getArea( overlay ), offset, ResourceGroup::idFoodOverlay, OverlayPic::base );
       }
     break;
 
@@ -87,7 +87,7 @@ void LayerHealth::drawTile(GfxEngine& engine, Tile& tile, Point offset)
         needDrawAnimations = (house->getSpec().getLevel() == 1) && (house->getHabitants().size() == 0);
 
         CityHelper helper( _city );
-        drawArea( engine, helper.getArea( overlay ), offset, ResourceGroup::foodOverlay, OverlayPic::inHouseBase );
+        drawArea( engine, helper.getArea( overlay ), offset, ResourceGroup::idFoodOverlay, OverlayPic::inHouseBase );
       }
     break;
 
@@ -95,7 +95,7 @@ void LayerHealth::drawTile(GfxEngine& engine, Tile& tile, Point offset)
     default:
       {
         CityHelper helper( _city );
-        drawArea( engine, helper.getArea( overlay ), offset, ResourceGroup::foodOverlay, OverlayPic::base );
+        drawArea( engine, helper.getArea( overlay ), offset, ResourceGroup::idFoodOverlay, OverlayPic::base );
       }
     break;
     }
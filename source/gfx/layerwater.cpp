@@ -78,7 +78,7 @@ void LayerWater::drawTile(GfxEngine& engine, Tile& tile, Point offset)
       tileNumber += tile.getWaterService( WTR_RESERVOIR ) > 0 ? OverlayPic::reservoirRange : 0;
 
       CityHelper helper( _city );
-      drawArea( engine, helper.getArea( overlay ), offset, ResourceGroup::waterOverlay, OverlayPic::base + tileNumber );
+      drawArea( engine, helper.getArea( overlay ), offset, ResourceGroup::idWaterOverlay, OverlayPic::base + tileNumber );
 
       pic = Picture::getInvalid();
       areaSize = 0;
@@ -113,7 +113,7 @@ void LayerWater::drawTile(GfxEngine& engine, Tile& tile, Point offset)
         int picIndex = reservoirWater ? OverlayPic::reservoirRange : 0;
         picIndex |= fontainWater > 0 ? OverlayPic::haveWater : 0;
         picIndex |= OverlayPic::skipLeftBorder | OverlayPic::skipRightBorder;
-        engine.drawPicture( Picture::load( ResourceGroup::waterOverlay, picIndex + OverlayPic::base ), rtile->getXY() + offset );
+        engine.drawPicture( Picture::load( ResourceGroup::idWaterOverlay, picIndex + OverlayPic::base ), rtile->getXY() + offset );
       }
     }
   }
@@ -40,6 +40,102 @@ void PNGAPI user_read_data_fcn(png_structp png_ptr, png_bytep data, png_size_t l
   }
 }
 
+// reads info section and sets conversion of any png into 32bit BGRA rows
+static void setupTransforms( png_structp png_ptr, png_infop info_ptr, unsigned int& Width, unsigned int& Height )
+{
+  png_read_info(png_ptr, info_ptr); // Read the info section of the png file
+
+  int BitDepth;
+  int ColorType;
+  {
+        // Use temporary variables to avoid passing casted pointers
+        png_uint_32 w,h;
+        // Extract info
+        png_get_IHDR(png_ptr, info_ptr,
+                &w, &h,
+                &BitDepth, &ColorType, NULL, NULL, NULL);
+        Width=w;
+        Height=h;
+  }
+
+  // Convert palette color to true color
+  if (ColorType==PNG_COLOR_TYPE_PALETTE)
+        png_set_palette_to_rgb(png_ptr);
+
+  // Convert low bit colors to 8 bit colors
+  if (BitDepth < 8)
+  {
+        if (ColorType==PNG_COLOR_TYPE_GRAY || ColorType==PNG_COLOR_TYPE_GRAY_ALPHA)
+                png_set_expand_gray_1_2_4_to_8(png_ptr);
+        else
+                png_set_packing(png_ptr);
+  }
+
+  if (png_get_valid(png_ptr, info_ptr, PNG_INFO_tRNS))
+        png_set_tRNS_to_alpha(png_ptr);
+
+  // Convert high bit colors to 8 bit colors
+  if (BitDepth == 16)
+        png_set_strip_16(png_ptr);
+
+  // Convert gray color to true color
+  if (ColorType==PNG_COLOR_TYPE_GRAY || ColorType==PNG_COLOR_TYPE_GRAY_ALPHA)
+        png_set_gray_to_rgb(png_ptr);
+
+  int intent;
+  const double screen_gamma = 2.2;
+
+  if (png_get_sRGB(png_ptr, info_ptr, &intent))
+        png_set_gamma(png_ptr, screen_gamma, 0.45455);
+  else
+  {
+        double image_gamma;
+        if (png_get_gAMA(png_ptr, info_ptr, &image_gamma))
+                png_set_gamma(png_ptr, screen_gamma, image_gamma);
+        else
+                png_set_gamma(png_ptr, screen_gamma, 0.45455);
+  }
+
+  // Update the changes in between, as we need to get the new color type
+  // for proper processing of the RGBA type
+  png_read_update_info(png_ptr, info_ptr);
+  {
+     // Use temporary variables to avoid passing casted pointers
+     png_uint_32 w,h;
+     // Extract info
+     png_get_IHDR(png_ptr, info_ptr,
+             &w, &h,
+             &BitDepth, &ColorType, NULL, NULL, NULL);
+     Width=w;
+     Height=h;
+  }
+
+  // Convert RGBA to BGRA
+  if (ColorType==PNG_COLOR_TYPE_RGB_ALPHA)
+  {
+    png_set_bgr(png_ptr);
+  }
+}
+
+// PNG function for reading from memory
+struct MemoryReader
+{
+  const ByteArray* data;
+  unsigned int position;
+};
+
+static void PNGAPI user_read_memory_fcn(png_structp png_ptr, png_bytep data, png_size_t length)
+{
+  MemoryReader* reader = (MemoryReader*)png_get_io_ptr(png_ptr);
+  if( reader->position + length > reader->data->size() )
+  {
+    png_error(png_ptr, "Read Error");
+  }
+
+  memcpy( data, reader->data->data() + reader->position, length );
+  reader->position += length;
+}
+
 //! returns true if the file maybe is able to be loaded by this class
 //! based on the file extension (e.g. ".tga")
 bool PictureLoaderPng::isALoadableFileExtension(const io::FilePath& filename) const
@@ -123,80 +219,9 @@ Picture PictureLoaderPng::load( io::NFile file ) const
 
   png_set_sig_bytes(png_ptr, 8); // Tell png that we read the signature
 
-  png_read_info(png_ptr, info_ptr); // Read the info section of the png file
-
   unsigned int Width;
   unsigned int Height;
-  int BitDepth;
-  int ColorType;
-  {
-        // Use temporary variables to avoid passing casted pointers
-        png_uint_32 w,h;
-        // Extract info
-        png_get_IHDR(png_ptr, info_ptr,
-                &w, &h,
-                &BitDepth, &ColorType, NULL, NULL, NULL);
-        Width=w;
-        Height=h;
-  }
-
-  // Convert palette color to true color
-  if (ColorType==PNG_COLOR_TYPE_PALETTE)
-        png_set_palette_to_rgb(png_ptr);
-
-  // Convert low bit colors to 8 bit colors
-  if (BitDepth < 8)
-  {
-        if (ColorType==PNG_COLOR_TYPE_GRAY || ColorType==PNG_COLOR_TYPE_GRAY_ALPHA)
-                png_set_expand_gray_1_2_4_to_8(png_ptr);
-        else
-                png_set_packing(png_ptr);
-  }
-
-  if (png_get_valid(png_ptr, info_ptr, PNG_INFO_tRNS))
-        png_set_tRNS_to_alpha(png_ptr);
-
-  // Convert high bit colors to 8 bit colors
-  if (BitDepth == 16)
-        png_set_strip_16(png_ptr);
-
-  // Convert gray color to true color
-  if (ColorType==PNG_COLOR_TYPE_GRAY || ColorType==PNG_COLOR_TYPE_GRAY_ALPHA)
-        png_set_gray_to_rgb(png_ptr);
-
-  int intent;
-  const double screen_gamma = 2.2;
-
-  if (png_get_sRGB(png_ptr, info_ptr, &intent))
-        png_set_gamma(png_ptr, screen_gamma, 0.45455);
-  else
-  {
-        double image_gamma;
-        if (png_get_gAMA(png_ptr, info_ptr, &image_gamma))
-                png_set_gamma(png_ptr, screen_gamma, image_gamma);
-        else
-                png_set_gamma(png_ptr, screen_gamma, 0.45455);
-  }
-
-  // Update the changes in between, as we need to get the new color type
-  // for proper processing of the RGBA type
-  png_read_update_info(png_ptr, info_ptr);
-  {
-     // Use temporary variables to avoid passing casted pointers
-     png_uint_32 w,h;
-     // Extract info
-     png_get_IHDR(png_ptr, info_ptr,
-             &w, &h,
-             &BitDepth, &ColorType, NULL, NULL, NULL);
-     Width=w;
-     Height=h;
-  }
-
-  // Convert RGBA to BGRA
-  if (ColorType==PNG_COLOR_TYPE_RGB_ALPHA)
-  {
-    png_set_bgr(png_ptr);
-  }
+  setupTransforms( png_ptr, info_ptr, Width, Height );
 
   // Create the image structure to be filled by png data
   Picture* pic = GfxEngine::instance().createPicture( Size( Width, Height ) );
@@ -246,3 +271,76 @@ Picture PictureLoaderPng::load( io::NFile file ) const
 
   return *pic;
 }
+
+SDL_Surface* PictureLoaderPng::decode( const ByteArray& data, const std::string& name )
+{
+  if( data.size() < 8 || png_sig_cmp( (png_bytep)data.data(), 0, 8) )
+  {
+    Logger::warning( "LOAD PNG: not really a png %s", name.c_str() );
+    return 0;
+  }
+
+  png_structp png_ptr = png_create_read_struct( PNG_LIBPNG_VER_STRING,
+                                                NULL, (png_error_ptr)png_cpexcept_error,
+                                                (png_error_ptr)png_cpexcept_warn);
+  if( !png_ptr )
+  {
+    Logger::warning( "LOAD PNG: Internal PNG create read struct failure %s", name.c_str() );
+    return 0;
+  }
+
+  png_infop info_ptr = png_create_info_struct(png_ptr);
+  if (!info_ptr)
+  {
+    Logger::warning( "LOAD PNG: Internal PNG create info struct failure %s", name.c_str() );
+    png_destroy_read_struct(&png_ptr, NULL, NULL);
+    return 0;
+  }
+
+  // volatile, because it is changed between setjmp and longjmp
+  SDL_Surface* volatile surface = 0;
+  png_bytep* volatile RowPointers = 0;
+
+  if (setjmp(png_jmpbuf(png_ptr)))
+  {
+    png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
+    delete [] RowPointers;
+    SDL_FreeSurface( surface );
+    return 0;
+  }
+
+  MemoryReader reader = { &data, 8 };
+  png_set_read_fn(png_ptr, &reader, user_read_memory_fcn);
+  png_set_sig_bytes(png_ptr, 8);
+
+  unsigned int Width;
+  unsigned int Height;
+  setupTransforms( png_ptr, info_ptr, Width, Height );
+
+  // same layout as surfaces of engine after conversion to display format
+  surface = SDL_CreateRGBSurface( SDL_SWSURFACE, Width, Height, 32,
+                                  0x00ff0000, 0x0000ff00, 0x000000ff, 0xff000000 );
+  if( surface == 0 || !Height )
+  {
+    Logger::warning( "LOAD PNG: Internal PNG create image struct failure %s", name.c_str() );
+    png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
+    SDL_FreeSurface( surface );
+    return 0;
+  }
+
+  RowPointers = new png_bytep[ Height ];
+  unsigned char* pixels = (unsigned char*)surface->pixels;
+  for(unsigned int i=0; i<Height; ++i)
+  {
+    RowPointers[i] = pixels;
+    pixels += surface->pitch;
+  }
+
+  png_read_image( png_ptr, RowPointers );
+  png_read_end( png_ptr, NULL );
+  png_destroy_read_struct( &png_ptr, &info_ptr, 0 );
+
+  delete [] RowPointers;
+
+  return surface;
+}
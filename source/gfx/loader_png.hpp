@@ -5,6 +5,9 @@
 #define __OC3_PICTURELOADER_PNG_H_INCLUDED__
 
 #include "loader.hpp"
+#include "core/bytearray.hpp"
+
+struct SDL_Surface;
 
 //!  Surface Loader for PNG files
 class PictureLoaderPng : public AbstractPictureLoader
@@ -20,6 +23,10 @@ public:
 
    //! creates a surface from the file
    virtual Picture load( io::NFile file ) const;
+
+   //! creates 32bit ARGB surface from png data, returns 0 on failure.
+   //! doesn't use graphic engine, so may be called from worker threads
+   static SDL_Surface* decode( const ByteArray& data, const std::string& name );
 };
 
 #endif //__OC3_PICTURELOADER_PNG_H_INCLUDED__
@@ -24,12 +24,29 @@
 #include "gfx/engine.hpp"
 #include "core/requirements.hpp"
 #include "core/color.hpp"
+#include "rlesprite.hpp"
 #include <SDL.h>
 
 // Picture class functions
 
 static const Picture _invalidPicture = Picture();
 
+// state of surface pixels, copies of picture share it with surface
+class PictureState : public ReferenceCounted
+{
+public:
+  unsigned int uid;       // surface addresses are reused, uid is not
+  unsigned int revision;  // changed on every drawing into surface
+
+  // visible spans for software blitter, valid while revision is the same
+  RleSpritePtr rle;
+  unsigned int rleRevision;
+};
+
+typedef SmartPtr< PictureState > PictureStatePtr;
+
+static unsigned int _lastPictureUid = 0;
+
 class Picture::Impl
 {
 public:
@@ -46,6 +63,18 @@ public:
 
   // for OPEN_GL surface
   unsigned int glTextureID;  // texture ID for openGL
+  RectF glTextureRect;
+
+  PictureStatePtr state;
+
+  void changed()
+  {
+    if( state.isValid() )
+    {
+      state->revision++;
+      state->rle = RleSpritePtr();
+    }
+  }
 };
 
 Picture::Picture() : _d( new Impl )
@@ -53,6 +82,7 @@ Picture::Picture() : _d( new Impl )
   _d->surface = NULL;
   _d->offset = Point( 0, 0 );
   _d->glTextureID = 0;
+  _d->glTextureRect = RectF( 0.f, 0.f, 1.f, 1.f );
   _d->size = Size( 0 );
   _d->name = "";
 }
@@ -67,6 +97,13 @@ void Picture::init(SDL_Surface *surface, const Point& offset )
   _d->surface = surface;
   _d->offset = offset;
   _d->size = Size( _d->surface->w, _d->surface->h );
+  _d->glTextureID = 0;
+
+  _d->state = PictureStatePtr( new PictureState() );
+  _d->state->drop();
+  _d->state->uid = ++_lastPictureUid;
+  _d->state->revision = 0;
+  _d->state->rleRevision = 0;
 }
 
 void Picture::setOffset(const int xoffset, const int yoffset)
@@ -128,6 +165,11 @@ Picture& Picture::load( const std::string& group, const int id )
   return PictureBank::instance().getPicture( group, id );
 }
 
+Picture& Picture::load( ResourceGroup::Id group, const int id )
+{
+  return PictureBank::instance().getPicture( group, id );
+}
+
 Picture& Picture::load( const std::string& filename )
 {
   return PictureBank::instance().getPicture( filename );
@@ -170,6 +212,7 @@ void Picture::draw( const Picture &srcpic, const Rect& srcrect, const Rect& dstr
     return;
   }
 
+  _d->changed();
   SDL_Rect srcRect, dstRect;
 
   srcRect.x = srcrect.getLeft();
@@ -218,6 +261,9 @@ void Picture::lock()
 
 void Picture::unlock()
 {
+  // pixels may be written while surface is locked
+  _d->changed();
+
   if (SDL_MUSTLOCK(_d->surface))
   {
     SDL_UnlockSurface(_d->surface);
@@ -266,6 +312,8 @@ int Picture::getPixel(Point pos )
 
 void Picture::setPixel(Point pos, const int color)
 {
+  _d->changed();
+
   // validate arguments
   if (_d->surface == NULL || pos.getX() < 0 || pos.getY() < 0 || pos.getX() >= _d->surface->w || pos.getY() >= _d->surface->h)
     return;
@@ -311,7 +359,9 @@ Picture& Picture::operator=( const Picture& other )
 
   // for OPEN_GL surface
   _d->glTextureID = other._d->glTextureID;  // texture ID for openGL
+  _d->glTextureRect = other._d->glTextureRect;
 
+  _d->state = other._d->state;
   _d->offset = other._d->offset;
 
   return *this;
@@ -327,6 +377,42 @@ unsigned int& Picture::getGlTextureID() const
   return _d->glTextureID;
 }
 
+RectF& Picture::getGlTextureRect() const
+{
+  return _d->glTextureRect;
+}
+
+void Picture::setRle( RleSpritePtr rle )
+{
+  if( _d->state.isValid() )
+  {
+    _d->state->rle = rle;
+    _d->state->rleRevision = _d->state->revision;
+  }
+}
+
+const RleSpritePtr& Picture::getRle() const
+{
+  static const RleSpritePtr noRle;
+  // spans are shared by all copies, so copy drawn into drops them for others too
+  if( _d->state.isValid() && _d->state->rleRevision == _d->state->revision )
+  {
+    return _d->state->rle;
+  }
+
+  return noRle;
+}
+
+unsigned int Picture::getUid() const
+{
+  return _d->state.isValid() ? _d->state->uid : 0;
+}
+
+unsigned int Picture::getRevision() const
+{
+  return _d->state.isValid() ? _d->state->revision : 0;
+}
+
 void Picture::destroy( Picture* ptr )
 {
   GfxEngine::instance().deletePicture( ptr );
@@ -335,6 +421,7 @@ void Picture::destroy( Picture* ptr )
 void Picture::fill( const NColor& color, const Rect& rect )
 {
   SDL_Surface* source = _d->surface;
+  _d->changed();
 
   SDL_LockSurface( source );
   SDL_Rect sdlRect = { (short)rect.getLeft(), (short)rect.getTop(), (Uint16)rect.getWidth(), (Uint16)rect.getHeight() };
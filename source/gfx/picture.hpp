@@ -24,9 +24,14 @@
 #include "core/size.hpp"
 #include "core/scopedptr.hpp"
 #include "core/referencecounted.hpp"
+#include "core/smartptr.hpp"
 #include "core/position.hpp"
+#include "game/resourcegroup.hpp"
 
 class Rect;
+class RectF;
+class RleSprite;
+typedef SmartPtr< RleSprite > RleSpritePtr;
 class NColor;
 struct SDL_Surface;
   
@@ -73,6 +78,8 @@ public:
   bool isValid() const;
 
   static Picture& load( const std::string& group, const int id );
+  // fast version for drawing code, no resource name is formatted
+  static Picture& load( ResourceGroup::Id group, const int id );
   static Picture& load( const std::string& filename ); 
 
   static Picture* create( const Size& size );
@@ -80,6 +87,18 @@ public:
   static void destroy( Picture* ptr );
 
   unsigned int& getGlTextureID() const;
+  // texture coordinates of picture in its texture, it may be atlas page
+  RectF& getGlTextureRect() const;
+
+  // spans of visible pixels for software blitter, copies of picture share them.
+  // drawing into picture drops them
+  void setRle( RleSpritePtr rle );
+  const RleSpritePtr& getRle() const;
+
+  // unique id of surface, copies of picture have the same id, new surface gets new one
+  unsigned int getUid() const;
+  // changes after every drawing into surface, copies of picture see it too
+  unsigned int getRevision() const;
 private:
   class Impl;
   ScopedPtr< Impl > _d;
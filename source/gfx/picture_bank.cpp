@@ -22,6 +22,9 @@
 #include <memory>
 #include <sys/stat.h>
 #include <map>
+#include <set>
+#include <algorithm>
+#include <vector>
 #include <SDL.h>
 
 #include "core/position.hpp"
@@ -33,8 +36,36 @@
 #include "core/logger.hpp"
 #include "picture_info_bank.hpp"
 #include "engine.hpp"
+#include "rlesprite.hpp"
+#include "picture_pack.hpp"
 #include "loader.hpp"
+#include "loader_png.hpp"
+#include "core/threadpool.hpp"
 #include "vfs/file.hpp"
+#include "vfs/filesystem.hpp"
+
+namespace {
+
+// count of files, which are read and decoded together
+static const unsigned int preloadBatchSize = 64;
+
+class DecodeTask : public ThreadPool::Task
+{
+public:
+  StringArray names;
+  std::vector< ByteArray > files;
+  std::vector< SDL_Surface* > surfaces;
+
+  virtual void exec( int begin, int end )
+  {
+    for( int k=begin; k < end; k++ )
+    {
+      surfaces[ k ] = files[ k ].empty() ? 0 : PictureLoaderPng::decode( files[ k ], names[ k ] );
+    }
+  }
+};
+
+}
 
 class PictureBank::Impl
 {
@@ -43,6 +74,14 @@ public:
   typedef Pictures::iterator ItPicture;
 
   Pictures resources;  // key=image name, value=picture
+  PicturePack pack;    // decoded pictures, mapped from file
+
+  // pictures of resources by group and index, they point to values of resources
+  std::vector< Picture* > groups[ ResourceGroup::idCount ];
+  Signal2<int, int> onPreloadProgressSignal;
+
+  // memory of packed png files, reused for every picture loaded from hdd
+  ByteArray fileBuffer;
 };
 
 PictureBank& PictureBank::instance()
@@ -75,7 +114,34 @@ Picture& PictureBank::getPicture(const std::string &name)
   Impl::ItPicture it = _d->resources.find( hash );
   if( it == _d->resources.end() )
   {
+    Picture packPicture;
+    if( _d->pack.load( name, packPicture ) )
+    {
+      if( GfxEngine::instance().getFlag( GfxEngine::rleSprites ) > 0 )
+      {
+        packPicture.setRle( RleSprite::create( packPicture ) );
+      }
+
+      _d->resources[ hash ] = packPicture;
+      return _d->resources[ hash ];
+    }
+
     //can't find image in valid resources, try load from hdd
+    if( io::FilePath( name ).isExtension( ".png", false )
+        && io::FileSystem::instance().readFile( name, _d->fileBuffer ) && !_d->fileBuffer.empty() )
+    {
+      SDL_Surface* surface = PictureLoaderPng::decode( _d->fileBuffer, name );
+      if( surface != 0 )
+      {
+        Picture tmpPicture;
+        tmpPicture.init( surface, Point( 0, 0 ) );
+        GfxEngine::instance().loadPicture( tmpPicture );
+
+        _d->resources[ hash ] = makePicture( tmpPicture.getSurface(), name );
+        return _d->resources[ hash ];
+      }
+    }
+
     io::NFile file = io::NFile::open( name );
 
     if( file.isOpen() )
@@ -103,6 +169,30 @@ Picture& PictureBank::getPicture(const std::string &prefix, const int idx)
    return getPicture(resource_name);
 }
 
+Picture& PictureBank::getPicture( ResourceGroup::Id group, const int idx )
+{
+  if( group < 0 || group >= ResourceGroup::idCount || idx < 0 )
+  {
+    return getPicture( ResourceGroup::getName( group ), idx );
+  }
+
+  std::vector< Picture* >& table = _d->groups[ group ];
+  if( idx < (int)table.size() && table[ idx ] != 0 )
+  {
+    return *table[ idx ];
+  }
+
+  // values of map never move, so pointer stays valid when picture is replaced by setPicture()
+  Picture& pic = getPicture( ResourceGroup::getName( group ), idx );
+  if( idx >= (int)table.size() )
+  {
+    table.resize( idx + 1, 0 );
+  }
+  table[ idx ] = &pic;
+
+  return pic;
+}
+
 Picture PictureBank::makePicture(SDL_Surface *surface, const std::string& resource_name) const
 {
    Point offset( 0, 0 );
@@ -132,9 +222,79 @@ Picture PictureBank::makePicture(SDL_Surface *surface, const std::string& resour
    pic.init( surface, offset );
    pic.setName(filename);
 
+   // engine blits transparent sprites by spans
+   if( GfxEngine::instance().getFlag( GfxEngine::rleSprites ) > 0 )
+   {
+     pic.setRle( RleSprite::create( pic ) );
+   }
+
    return pic;
 }
 
+bool PictureBank::loadPack( const io::FilePath& filename )
+{
+  return _d->pack.open( filename );
+}
+
+void PictureBank::preload( const StringArray& names, ThreadPool& workers )
+{
+  StringArray loadNames;
+  std::set< unsigned int > hashes;
+  for( StringArray::const_iterator it=names.begin(); it != names.end(); it++ )
+  {
+    unsigned int hash = StringHelper::hash( *it );
+    if( _d->resources.find( hash ) == _d->resources.end() && !_d->pack.contains( *it )
+        && hashes.insert( hash ).second )
+    {
+      loadNames.push_back( *it );
+    }
+  }
+
+  Logger::warning( "Preload %d pictures on %d workers", loadNames.size(), workers.getThreadsCount() + 1 );
+
+  DecodeTask task;
+  for( unsigned int start=0; start < loadNames.size(); start += preloadBatchSize )
+  {
+    unsigned int count = std::min< unsigned int >( preloadBatchSize, loadNames.size() - start );
+    task.names.assign( loadNames.begin() + start, loadNames.begin() + start + count );
+    task.files.resize( count );
+    task.surfaces.assign( count, 0 );
+
+    // archives can't be read from several threads, workers get only decoding
+    // buffers of task are kept between batches, so files are unpacked without new allocations
+    for( unsigned int k=0; k < count; k++ )
+    {
+      if( !io::FileSystem::instance().readFile( task.names[ k ], task.files[ k ] ) )
+      {
+        task.files[ k ].clear();
+      }
+    }
+
+    workers.run( task, count );
+
+    // missed pictures will be reported by getPicture()
+    for( unsigned int k=0; k < count; k++ )
+    {
+      if( task.surfaces[ k ] == 0 )
+        continue;
+
+      Picture tmpPicture;
+      tmpPicture.init( task.surfaces[ k ], Point( 0, 0 ) );
+      GfxEngine::instance().loadPicture( tmpPicture );
+
+      Picture pic = makePicture( tmpPicture.getSurface(), task.names[ k ] );
+      _d->resources[ StringHelper::hash( task.names[ k ] ) ] = pic;
+    }
+
+    _d->onPreloadProgressSignal.emit( start + count, loadNames.size() );
+  }
+}
+
+Signal2<int, int>& PictureBank::onPreloadProgress()
+{
+  return _d->onPreloadProgressSignal;
+}
+
 void PictureBank::createResources()
 {
   Picture& originalPic = getPicture( ResourceGroup::utilitya, 34 );
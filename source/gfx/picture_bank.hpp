@@ -25,8 +25,12 @@
 #include "walker/action.hpp"
 #include "game/good.hpp"
 #include "core/scopedptr.hpp"
+#include "vfs/filepath.hpp"
+#include "core/stringarray.hpp"
+#include "core/signals.hpp"
 
 class GfxEngine;
+class ThreadPool;
 
 // loads pictures from files
 class PictureBank
@@ -44,6 +48,16 @@ public:
   // show resource
   Picture& getPicture(const std::string &prefix, const int idx);
 
+  // show resource, picture is taken from table of group by index
+  Picture& getPicture( ResourceGroup::Id group, const int idx );
+
+  // pictures of pack are used instead of png files with the same names
+  bool loadPack( const io::FilePath& filename );
+
+  // decodes png files of resources on workers, surfaces are converted and stored on calling thread.
+  // pictures which already are in bank or in pack are skipped
+  void preload( const StringArray& names, ThreadPool& workers );
+
   // create runtime resources
   void createResources();
 
@@ -51,6 +65,10 @@ public:
   //void loadArchive(const std::string &filename, GfxEngine& engine );
   ~PictureBank();
 
+oc3_signals public:
+  // count of preloaded pictures and count of all pictures to preload
+  Signal2<int, int>& onPreloadProgress();
+
 private:
   PictureBank();
 
@@ -0,0 +1,315 @@
+// This file is part of openCaesar3.
+//
+// openCaesar3 is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// openCaesar3 is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with openCaesar3.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "picture_pack.hpp"
+#include "picture.hpp"
+#include "engine.hpp"
+#include "vfs/mappedfile.hpp"
+#include "core/stringhelper.hpp"
+#include "core/logger.hpp"
+
+#include <SDL.h>
+#include <fstream>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+static const char packMagic[4] = { 'O', 'C', '3', 'P' };
+static const unsigned int packVersion = 1;
+static const unsigned int packByteOrder = 0x01020304;
+
+// pixel data of every picture starts on aligned offset
+static const unsigned int dataAlign = 16;
+
+struct PackHeader
+{
+  char magic[4];
+  unsigned int byteOrder;
+  unsigned int version;
+  unsigned int count;
+  unsigned int entriesOffset;
+};
+
+struct PackEntry
+{
+  unsigned int hash;        // StringHelper::hash of resource name
+  unsigned int nameOffset;  // zero terminated resource name
+  unsigned short width;
+  unsigned short height;
+  short offsetX;
+  short offsetY;
+  unsigned int dataOffset;  // width*height pixels
+};
+
+struct EntryLess
+{
+  bool operator()( const PackEntry& a, const PackEntry& b ) const { return a.hash < b.hash; }
+  bool operator()( const PackEntry& a, unsigned int hash ) const { return a.hash < hash; }
+  bool operator()( unsigned int hash, const PackEntry& b ) const { return hash < b.hash; }
+};
+
+}
+
+class PicturePack::Impl
+{
+public:
+  io::MappedFile file;
+  const PackHeader* header;
+  const PackEntry* entries;
+
+  const PackEntry* find( const std::string& name ) const;
+};
+
+PicturePack::PicturePack() : _d( new Impl )
+{
+  _d->header = 0;
+  _d->entries = 0;
+}
+
+PicturePack::~PicturePack()
+{
+}
+
+bool PicturePack::open( const io::FilePath& filename )
+{
+  _d->header = 0;
+  _d->entries = 0;
+
+  if( !_d->file.open( filename ) )
+    return false;
+
+  const PackHeader* header = (const PackHeader*)_d->file.data();
+  unsigned int size = _d->file.getSize();
+
+  if( size < sizeof( PackHeader )
+      || memcmp( header->magic, packMagic, sizeof( packMagic ) ) != 0
+      || header->byteOrder != packByteOrder || header->version != packVersion
+      || header->entriesOffset > size
+      || (size - header->entriesOffset) / sizeof( PackEntry ) < header->count )
+  {
+    Logger::warning( "PicturePack: %s has unsupported format", filename.toString().c_str() );
+    _d->file.close();
+    return false;
+  }
+
+  // names and pixels are read straight from mapping, so every entry must lay inside file
+  const PackEntry* entries = (const PackEntry*)( _d->file.data() + header->entriesOffset );
+  for( unsigned int k=0; k < header->count; k++ )
+  {
+    const PackEntry& entry = entries[ k ];
+    unsigned long long dataEnd = (unsigned long long)entry.dataOffset + (unsigned long long)entry.width * entry.height * 4;
+    if( entry.nameOffset >= size || memchr( _d->file.data() + entry.nameOffset, 0, size - entry.nameOffset ) == 0
+        || dataEnd > size )
+    {
+      Logger::warning( "PicturePack: %s is damaged, entry %d lays outside of file", filename.toString().c_str(), k );
+      _d->file.close();
+      return false;
+    }
+  }
+
+  _d->header = header;
+  _d->entries = entries;
+
+  Logger::warning( "PicturePack: %s has %d pictures", filename.toString().c_str(), header->count );
+  return true;
+}
+
+bool PicturePack::isOpen() const
+{
+  return _d->header != 0;
+}
+
+unsigned int PicturePack::getCount() const
+{
+  return _d->header ? _d->header->count : 0;
+}
+
+const PackEntry* PicturePack::Impl::find( const std::string& name ) const
+{
+  if( header == 0 )
+    return 0;
+
+  unsigned int hash = StringHelper::hash( name );
+  const PackEntry* end = entries + header->count;
+  const PackEntry* it = std::lower_bound( entries, end, hash, EntryLess() );
+
+  // names with the same hash lay together
+  for( ; it != end && it->hash == hash; it++ )
+  {
+    if( name == file.data() + it->nameOffset )
+      return it;
+  }
+
+  return 0;
+}
+
+bool PicturePack::contains( const std::string& name ) const
+{
+  return _d->find( name ) != 0;
+}
+
+bool PicturePack::load( const std::string& name, Picture& outPicture ) const
+{
+  const PackEntry* entry = _d->find( name );
+  if( entry == 0 )
+    return false;
+
+  // surface only points to pixels of mapped file, SDL_FreeSurface won't free them
+  void* pixels = const_cast< char* >( _d->file.data() ) + entry->dataOffset;
+  SDL_Surface* surface = SDL_CreateRGBSurfaceFrom( pixels, entry->width, entry->height, 32, entry->width * 4,
+                                                   0x00ff0000, 0x0000ff00, 0x000000ff, 0xff000000 );
+  if( surface == 0 )
+    return false;
+
+  outPicture.init( surface, Point( entry->offsetX, entry->offsetY ) );
+
+  std::string pictureName = name.substr( 0, name.find( '.' ) );
+  outPicture.setName( pictureName );
+
+  GfxEngine::instance().loadPicture( outPicture );
+  return true;
+}
+
+class PicturePackWriter::Impl
+{
+public:
+  std::ofstream stream;
+  std::vector< PackEntry > entries;
+  std::string names;
+  unsigned int position;
+
+  void write( const void* data, unsigned int size )
+  {
+    stream.write( (const char*)data, size );
+    position += size;
+  }
+};
+
+PicturePackWriter::PicturePackWriter() : _d( new Impl )
+{
+  _d->position = 0;
+}
+
+PicturePackWriter::~PicturePackWriter()
+{
+  if( _d->stream.is_open() )
+  {
+    close();
+  }
+}
+
+bool PicturePackWriter::open( const io::FilePath& filename )
+{
+  _d->stream.open( filename.toString().c_str(), std::ios::out | std::ios::binary | std::ios::trunc );
+  _d->entries.clear();
+  _d->names.clear();
+  _d->position = 0;
+
+  if( !_d->stream.is_open() )
+  {
+    Logger::warning( "PicturePackWriter: can't create %s", filename.toString().c_str() );
+    return false;
+  }
+
+  // header is written again by close()
+  PackHeader header;
+  memset( &header, 0, sizeof( header ) );
+  _d->write( &header, sizeof( header ) );
+
+  return true;
+}
+
+bool PicturePackWriter::append( const std::string& name, const Picture& picture )
+{
+  SDL_Surface* surface = picture.getSurface();
+  if( !_d->stream.is_open() || surface == 0 )
+    return false;
+
+  const SDL_PixelFormat* format = surface->format;
+  if( format->BitsPerPixel != 32 || format->Amask != 0xff000000 || format->Rmask != 0x00ff0000
+      || format->Gmask != 0x0000ff00 || format->Bmask != 0x000000ff
+      || surface->w > 0xffff || surface->h > 0xffff )
+  {
+    Logger::warning( "PicturePackWriter: %s has unsupported format", name.c_str() );
+    return false;
+  }
+
+  static const char zeros[ dataAlign ] = { 0 };
+  unsigned int padding = (dataAlign - _d->position % dataAlign) % dataAlign;
+  _d->write( zeros, padding );
+
+  PackEntry entry;
+  entry.hash = StringHelper::hash( name );
+  entry.nameOffset = _d->names.size();
+  entry.width = surface->w;
+  entry.height = surface->h;
+  entry.offsetX = picture.getOffset().getX();
+  entry.offsetY = picture.getOffset().getY();
+  entry.dataOffset = _d->position;
+
+  SDL_LockSurface( surface );
+  for( int y=0; y < surface->h; y++ )
+  {
+    _d->write( (const char*)surface->pixels + y * surface->pitch, surface->w * 4 );
+  }
+  SDL_UnlockSurface( surface );
+
+  _d->names.append( name.c_str(), name.size() + 1 );
+  _d->entries.push_back( entry );
+
+  return _d->stream.good();
+}
+
+bool PicturePackWriter::close()
+{
+  if( !_d->stream.is_open() )
+    return false;
+
+  // names go after pixels, offsets of names become absolute
+  unsigned int namesOffset = _d->position;
+  _d->write( _d->names.data(), _d->names.size() );
+
+  for( std::vector< PackEntry >::iterator it=_d->entries.begin(); it != _d->entries.end(); it++ )
+  {
+    it->nameOffset += namesOffset;
+  }
+
+  static const char zeros[ dataAlign ] = { 0 };
+  _d->write( zeros, (dataAlign - _d->position % dataAlign) % dataAlign );
+
+  std::stable_sort( _d->entries.begin(), _d->entries.end(), EntryLess() );
+
+  PackHeader header;
+  memcpy( header.magic, packMagic, sizeof( packMagic ) );
+  header.byteOrder = packByteOrder;
+  header.version = packVersion;
+  header.count = _d->entries.size();
+  header.entriesOffset = _d->position;
+
+  if( !_d->entries.empty() )
+  {
+    _d->write( &_d->entries[0], _d->entries.size() * sizeof( PackEntry ) );
+  }
+
+  _d->stream.seekp( 0 );
+  _d->stream.write( (const char*)&header, sizeof( header ) );
+
+  bool ok = _d->stream.good();
+  _d->stream.close();
+
+  return ok;
+}
@@ -0,0 +1,71 @@
+// This file is part of openCaesar3.
+//
+// openCaesar3 is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// openCaesar3 is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with openCaesar3.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __OPENCAESAR3_PICTURE_PACK_H_INCLUDED__
+#define __OPENCAESAR3_PICTURE_PACK_H_INCLUDED__
+
+#include "core/scopedptr.hpp"
+#include "vfs/filepath.hpp"
+
+#include <string>
+
+class Picture;
+
+// Pictures decoded by picpacker tool and stored in one file, which is mapped into memory.
+// File has header, table of entries sorted by hash of resource name, names and pixels.
+// Pixels are 32-bit ARGB in byte order of machine which made the pack, offsets
+// of pictures are already computed by PictureInfoBank rules.
+class PicturePack
+{
+public:
+  PicturePack();
+  ~PicturePack();
+
+  bool open( const io::FilePath& filename );
+  bool isOpen() const;
+
+  unsigned int getCount() const;
+  bool contains( const std::string& name ) const;
+
+  // creates picture over pixels of pack without copying them,
+  // name is resource name like "land1a_00001.png"
+  bool load( const std::string& name, Picture& outPicture ) const;
+
+private:
+  class Impl;
+  ScopedPtr< Impl > _d;
+};
+
+// writes pictures to pack file
+class PicturePackWriter
+{
+public:
+  PicturePackWriter();
+  ~PicturePackWriter();
+
+  bool open( const io::FilePath& filename );
+
+  // picture must have 32-bit ARGB surface
+  bool append( const std::string& name, const Picture& picture );
+
+  // writes table of entries, returns false on write error
+  bool close();
+
+private:
+  class Impl;
+  ScopedPtr< Impl > _d;
+};
+
+#endif //__OPENCAESAR3_PICTURE_PACK_H_INCLUDED__
@@ -0,0 +1,211 @@
+// This file is part of openCaesar3.
+//
+// openCaesar3 is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// openCaesar3 is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with openCaesar3.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "pixelblender.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #define OC3_BLEND_SSE2
+  #include <emmintrin.h>
+#endif
+
+// avx2 kernel is built with target attribute, so whole project doesn't need -mavx2
+#if defined(OC3_BLEND_SSE2) && (defined(__x86_64__) || defined(__i386__)) \
+    && ( defined(__clang__) || __GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9) )
+  #define OC3_BLEND_AVX2
+  #include <immintrin.h>
+#endif
+
+namespace {
+
+typedef void (*BlendKernel)( unsigned int*, const unsigned int*, int, unsigned int, unsigned int );
+
+static const unsigned int alphaBits = 0xff000000;
+
+inline unsigned int blendPixel( unsigned int d, unsigned int s )
+{
+  unsigned int a = s >> 24;
+  if( a == 0 )
+    return d;
+
+  if( a == 255 )
+    return (s & ~alphaBits) | (d & alphaBits);
+
+  unsigned int na = 256 - a;
+
+  // red and blue are computed together, every channel has 16 bits for product
+  unsigned int rb = ( ( (s & 0x00ff00ff) * a + (d & 0x00ff00ff) * na ) >> 8 ) & 0x00ff00ff;
+  unsigned int g  = ( ( (s & 0x0000ff00) * a + (d & 0x0000ff00) * na ) >> 8 ) & 0x0000ff00;
+
+  return rb | g | (d & alphaBits);
+}
+
+void blendRowScalar( unsigned int* dst, const unsigned int* src, int count, unsigned int srcMask, unsigned int alphaOr )
+{
+  for( int k=0; k < count; k++ )
+  {
+    dst[ k ] = blendPixel( dst[ k ], (src[ k ] & srcMask) | alphaOr );
+  }
+}
+
+#ifdef OC3_BLEND_SSE2
+// blends 4 pixels, the same math as blendPixel
+inline __m128i blend4( __m128i d, __m128i s )
+{
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i c256 = _mm_set1_epi16( 256 );
+  const __m128i alpha = _mm_set1_epi32( (int)alphaBits );
+
+  __m128i slo = _mm_unpacklo_epi8( s, zero );
+  __m128i shi = _mm_unpackhi_epi8( s, zero );
+  __m128i dlo = _mm_unpacklo_epi8( d, zero );
+  __m128i dhi = _mm_unpackhi_epi8( d, zero );
+
+  // alpha of every pixel to all its channels
+  __m128i alo = _mm_shufflehi_epi16( _mm_shufflelo_epi16( slo, 0xff ), 0xff );
+  __m128i ahi = _mm_shufflehi_epi16( _mm_shufflelo_epi16( shi, 0xff ), 0xff );
+
+  __m128i rlo = _mm_add_epi16( _mm_mullo_epi16( slo, alo ), _mm_mullo_epi16( dlo, _mm_sub_epi16( c256, alo ) ) );
+  __m128i rhi = _mm_add_epi16( _mm_mullo_epi16( shi, ahi ), _mm_mullo_epi16( dhi, _mm_sub_epi16( c256, ahi ) ) );
+  __m128i res = _mm_packus_epi16( _mm_srli_epi16( rlo, 8 ), _mm_srli_epi16( rhi, 8 ) );
+
+  // opaque pixels are copied
+  __m128i opaque = _mm_cmpeq_epi32( _mm_and_si128( s, alpha ), alpha );
+  res = _mm_or_si128( _mm_and_si128( opaque, s ), _mm_andnot_si128( opaque, res ) );
+
+  return _mm_or_si128( _mm_andnot_si128( alpha, res ), _mm_and_si128( alpha, d ) );
+}
+
+void blendRowSse2( unsigned int* dst, const unsigned int* src, int count, unsigned int srcMask, unsigned int alphaOr )
+{
+  const __m128i mask = _mm_set1_epi32( (int)srcMask );
+  const __m128i addAlpha = _mm_set1_epi32( (int)alphaOr );
+  const __m128i alpha = _mm_set1_epi32( (int)alphaBits );
+  const __m128i zero = _mm_setzero_si128();
+
+  int k=0;
+  for( ; k + 4 <= count; k += 4 )
+  {
+    __m128i s = _mm_or_si128( _mm_and_si128( _mm_loadu_si128( (const __m128i*)(src + k) ), mask ), addAlpha );
+
+    // transparent pixels leave destination as is
+    if( _mm_movemask_epi8( _mm_cmpeq_epi32( _mm_and_si128( s, alpha ), zero ) ) == 0xffff )
+      continue;
+
+    __m128i d = _mm_loadu_si128( (const __m128i*)(dst + k) );
+    _mm_storeu_si128( (__m128i*)(dst + k), blend4( d, s ) );
+  }
+
+  blendRowScalar( dst + k, src + k, count - k, srcMask, alphaOr );
+}
+#endif
+
+#ifdef OC3_BLEND_AVX2
+__attribute__((target("avx2")))
+void blendRowAvx2( unsigned int* dst, const unsigned int* src, int count, unsigned int srcMask, unsigned int alphaOr )
+{
+  const __m256i mask = _mm256_set1_epi32( (int)srcMask );
+  const __m256i addAlpha = _mm256_set1_epi32( (int)alphaOr );
+  const __m256i alpha = _mm256_set1_epi32( (int)alphaBits );
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i c256 = _mm256_set1_epi16( 256 );
+
+  int k=0;
+  for( ; k + 8 <= count; k += 8 )
+  {
+    __m256i s = _mm256_or_si256( _mm256_and_si256( _mm256_loadu_si256( (const __m256i*)(src + k) ), mask ), addAlpha );
+
+    if( _mm256_movemask_epi8( _mm256_cmpeq_epi32( _mm256_and_si256( s, alpha ), zero ) ) == -1 )
+      continue;
+
+    __m256i d = _mm256_loadu_si256( (const __m256i*)(dst + k) );
+
+    // unpack and pack work inside 128-bit lanes, so pixel order is kept
+    __m256i slo = _mm256_unpacklo_epi8( s, zero );
+    __m256i shi = _mm256_unpackhi_epi8( s, zero );
+    __m256i dlo = _mm256_unpacklo_epi8( d, zero );
+    __m256i dhi = _mm256_unpackhi_epi8( d, zero );
+
+    __m256i alo = _mm256_shufflehi_epi16( _mm256_shufflelo_epi16( slo, 0xff ), 0xff );
+    __m256i ahi = _mm256_shufflehi_epi16( _mm256_shufflelo_epi16( shi, 0xff ), 0xff );
+
+    __m256i rlo = _mm256_add_epi16( _mm256_mullo_epi16( slo, alo ), _mm256_mullo_epi16( dlo, _mm256_sub_epi16( c256, alo ) ) );
+    __m256i rhi = _mm256_add_epi16( _mm256_mullo_epi16( shi, ahi ), _mm256_mullo_epi16( dhi, _mm256_sub_epi16( c256, ahi ) ) );
+    __m256i res = _mm256_packus_epi16( _mm256_srli_epi16( rlo, 8 ), _mm256_srli_epi16( rhi, 8 ) );
+
+    __m256i opaque = _mm256_cmpeq_epi32( _mm256_and_si256( s, alpha ), alpha );
+    res = _mm256_blendv_epi8( res, s, opaque );
+    res = _mm256_blendv_epi8( res, d, alpha );
+
+    _mm256_storeu_si256( (__m256i*)(dst + k), res );
+  }
+
+  blendRowSse2( dst + k, src + k, count - k, srcMask, alphaOr );
+}
+#endif
+
+struct KernelInfo
+{
+  BlendKernel kernel;
+  const char* name;
+};
+
+KernelInfo selectKernel()
+{
+  KernelInfo ret = { blendRowScalar, "scalar" };
+
+#ifdef OC3_BLEND_SSE2
+  ret.kernel = blendRowSse2;
+  ret.name = "sse2";
+#endif
+
+#ifdef OC3_BLEND_AVX2
+  __builtin_cpu_init();
+  if( __builtin_cpu_supports( "avx2" ) )
+  {
+    ret.kernel = blendRowAvx2;
+    ret.name = "avx2";
+  }
+#endif
+
+  return ret;
+}
+
+const KernelInfo& getKernel()
+{
+  static KernelInfo info = selectKernel();
+  return info;
+}
+
+}
+
+void PixelBlender::blendRow( unsigned int* dst, const unsigned int* src, int count,
+                             unsigned int srcMask, unsigned int alphaOr )
+{
+  getKernel().kernel( dst, src, count, srcMask, alphaOr );
+}
+
+void PixelBlender::copyRow( unsigned int* dst, const unsigned int* src, int count, unsigned int srcMask )
+{
+  unsigned int colorMask = srcMask & ~alphaBits;
+  for( int k=0; k < count; k++ )
+  {
+    dst[ k ] = (src[ k ] & colorMask) | (dst[ k ] & alphaBits);
+  }
+}
+
+std::string PixelBlender::getKernelName()
+{
+  return getKernel().name;
+}
@@ -0,0 +1,40 @@
+// This file is part of openCaesar3.
+//
+// openCaesar3 is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// openCaesar3 is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with openCaesar3.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __OPENCAESAR3_PIXELBLENDER_H_INCLUDED__
+#define __OPENCAESAR3_PIXELBLENDER_H_INCLUDED__
+
+#include <string>
+
+// Blends rows of 32-bit pixels with alpha in the high byte (ARGB, ABGR)
+// over rows of the same format, like SDL does it for per-pixel alpha:
+// dst = dst + (src - dst) * alpha / 256, alpha byte of dst is kept.
+// Scalar, SSE2 and AVX2 kernels are chosen once by cpu features.
+class PixelBlender
+{
+public:
+  // srcMask is applied to source pixels before blending, it drops color channels.
+  // alphaOr is added to source pixels after masking, 0xff000000 makes them opaque
+  static void blendRow( unsigned int* dst, const unsigned int* src, int count,
+                        unsigned int srcMask=0xffffffff, unsigned int alphaOr=0 );
+
+  // copies color of opaque pixels, alpha byte of dst is kept
+  static void copyRow( unsigned int* dst, const unsigned int* src, int count, unsigned int srcMask=0xffffffff );
+
+  // name of kernel used on this cpu
+  static std::string getKernelName();
+};
+
+#endif //__OPENCAESAR3_PIXELBLENDER_H_INCLUDED__
@@ -0,0 +1,107 @@
+// This file is part of openCaesar3.
+//
+// openCaesar3 is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// openCaesar3 is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with openCaesar3.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "rlesprite.hpp"
+
+#include <SDL.h>
+
+namespace {
+  // picture with less transparent pixels is drawn by plain blit
+  static const int minTransparentPercent = 25;
+}
+
+RleSprite::RleSprite()
+{
+}
+
+RleSpritePtr RleSprite::create( const unsigned int* pixels, int width, int height, int pitch )
+{
+  if( pixels == 0 || width <= 0 || height <= 0 || width > 0xffff )
+    return RleSpritePtr();
+
+  RleSprite* rle = new RleSprite();
+  RleSpritePtr ret( rle );
+  ret->drop();
+
+  int transparent = 0;
+  rle->_rows.reserve( height + 1 );
+
+  for( int y=0; y < height; y++ )
+  {
+    rle->_rows.push_back( rle->_spans.size() );
+    const unsigned int* row = pixels + y * pitch;
+
+    int x = 0;
+    while( x < width )
+    {
+      unsigned int alpha = row[ x ] >> 24;
+      if( alpha == 0 )
+      {
+        transparent++;
+        x++;
+        continue;
+      }
+
+      // span goes while pixels are visible and have the same opacity
+      bool opaque = (alpha == 0xff);
+      Span span;
+      span.x = x;
+      span.opaque = opaque;
+
+      while( x < width )
+      {
+        alpha = row[ x ] >> 24;
+        if( alpha == 0 || (alpha == 0xff) != opaque )
+          break;
+
+        x++;
+      }
+
+      span.length = x - span.x;
+      rle->_spans.push_back( span );
+    }
+  }
+
+  rle->_rows.push_back( rle->_spans.size() );
+
+  if( transparent * 100 < width * height * minTransparentPercent )
+    return RleSpritePtr();
+
+  return ret;
+}
+
+RleSpritePtr RleSprite::create( const Picture& picture )
+{
+  SDL_Surface* surface = picture.getSurface();
+  if( surface == 0 || surface->format->BitsPerPixel != 32 || surface->format->Amask != 0xff000000 )
+    return RleSpritePtr();
+
+  if( SDL_MUSTLOCK( surface ) ) { SDL_LockSurface( surface ); }
+  RleSpritePtr ret = create( (const unsigned int*)surface->pixels, surface->w, surface->h, surface->pitch / 4 );
+  if( SDL_MUSTLOCK( surface ) ) { SDL_UnlockSurface( surface ); }
+
+  return ret;
+}
+
+int RleSprite::getHeight() const
+{
+  return (int)_rows.size() - 1;
+}
+
+const RleSprite::Span* RleSprite::getSpans( int row, int& count ) const
+{
+  count = _rows[ row+1 ] - _rows[ row ];
+  return count > 0 ? &_spans[ _rows[ row ] ] : 0;
+}
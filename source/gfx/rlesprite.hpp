@@ -0,0 +1,56 @@
+// This file is part of openCaesar3.
+//
+// openCaesar3 is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// openCaesar3 is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with openCaesar3.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __OPENCAESAR3_RLESPRITE_H_INCLUDED__
+#define __OPENCAESAR3_RLESPRITE_H_INCLUDED__
+
+#include "core/referencecounted.hpp"
+#include "picture.hpp"
+
+#include <vector>
+
+// Run-length description of picture: every row is a list of spans of visible pixels,
+// so blitter skips transparent parts of sprite without reading them.
+// Spans index pixels of picture surface, they don't keep own copy.
+class RleSprite : public ReferenceCounted
+{
+public:
+  struct Span
+  {
+    unsigned short x;       // first pixel of span in row
+    unsigned short length;
+    bool opaque;            // all pixels of span have full alpha
+  };
+
+  // builds spans from 32-bit pixels with alpha in high byte, pitch is count of pixels in row.
+  // returns null pointer when picture is mostly visible and plain blit is as fast
+  static RleSpritePtr create( const unsigned int* pixels, int width, int height, int pitch );
+
+  // picture must have 32-bit surface with alpha in high byte
+  static RleSpritePtr create( const Picture& picture );
+
+  int getHeight() const;
+
+  // spans of row, count returns number of spans
+  const Span* getSpans( int row, int& count ) const;
+
+private:
+  RleSprite();
+
+  std::vector< Span > _spans;
+  std::vector< unsigned int > _rows;  // spans of row y are _spans[ _rows[y] ] .. _spans[ _rows[y+1] ]
+};
+
+#endif //__OPENCAESAR3_RLESPRITE_H_INCLUDED__
@@ -23,6 +23,7 @@
 #include <sstream>
 #include <list>
 #include <vector>
+#include <algorithm>
 #include <SDL.h>
 #include <SDL_ttf.h>
 
@@ -35,6 +36,9 @@
 #include "core/stringhelper.hpp"
 #include "core/font.hpp"
 #include "core/eventconverter.hpp"
+#include "core/logger.hpp"
+#include "pixelblender.hpp"
+#include "rlesprite.hpp"
 
 class GfxSdlEngine::Impl
 {
@@ -47,6 +51,10 @@ public:
   unsigned int lastUpdateFps;
   Font debugFont;
   bool showDebugInfo;
+
+  // draws picture on screen with PixelBlender, masks are applied while blending.
+  // returns false if surfaces have format which blender doesn't support
+  bool blit( const Picture& picture, int dx, int dy );
 };
 
 
@@ -58,6 +66,7 @@ Picture& GfxSdlEngine::getScreen()
 GfxSdlEngine::GfxSdlEngine() : GfxEngine(), _d( new Impl )
 {
   resetTileDrawMask();
+  setFlag( rleSprites, 1 );
 }
 
 GfxSdlEngine::~GfxSdlEngine()
@@ -93,6 +102,7 @@ void GfxSdlEngine::init()
   }
 
   SDL_WM_SetCaption( "OpenCaesar 3: "OC3_VERSION, 0 );    
+  Logger::warning( "Pixel blending kernel: %s", PixelBlender::getKernelName().c_str() );
 
   SDL_EnableKeyRepeat(1, 100);
 }
@@ -109,6 +119,16 @@ void GfxSdlEngine::exit()
 
 void GfxSdlEngine::loadPicture( Picture& ioPicture )
 {
+  // pictures of pack already have display format, they stay in mapped file
+  const SDL_PixelFormat* format = ioPicture.getSurface()->format;
+  const SDL_PixelFormat* screenFormat = _d->screen.getSurface()->format;
+  if( format->BitsPerPixel == 32 && format->Amask == 0xff000000
+      && format->Rmask == screenFormat->Rmask && format->Gmask == screenFormat->Gmask
+      && format->Bmask == screenFormat->Bmask )
+  {
+    return;
+  }
+
   // convert pixel format
   SDL_Surface* newImage = SDL_DisplayFormatAlpha( ioPicture.getSurface() );
   
@@ -162,7 +182,11 @@ void GfxSdlEngine::drawPicture(const Picture &picture, const int dx, const int d
     SDL_SetClipRect( _d->screen.getSurface(), &r );
   }
 
-  if( _d->rmask || _d->gmask || _d->bmask  )
+  if( _d->blit( picture, dx, dy ) )
+  {
+    // drawn by own blender
+  }
+  else if( _d->rmask || _d->gmask || _d->bmask  )
   {
     PictureConverter::maskColor( _d->maskedPic, picture, _d->rmask, _d->gmask, _d->bmask, _d->amask );
 
@@ -179,9 +203,95 @@ void GfxSdlEngine::drawPicture(const Picture &picture, const int dx, const int d
   }
 }
 
+bool GfxSdlEngine::Impl::blit( const Picture& picture, int dx, int dy )
+{
+  SDL_Surface* src = picture.getSurface();
+  SDL_Surface* dst = screen.getSurface();
+  const SDL_PixelFormat* sf = src->format;
+  const SDL_PixelFormat* df = dst->format;
+
+  // only per-pixel alpha in high byte, like SDL_DisplayFormatAlpha makes it
+  if( sf->BitsPerPixel != 32 || df->BitsPerPixel != 32 || sf->Amask != 0xff000000
+      || sf->Rmask != df->Rmask || sf->Gmask != df->Gmask || sf->Bmask != df->Bmask
+      || (src->flags & SDL_SRCALPHA) == 0 || (src->flags & SDL_SRCCOLORKEY) != 0
+      || sf->alpha != SDL_ALPHA_OPAQUE )
+  {
+    return false;
+  }
+
+  // mask drops color channels, picture without alpha mask becomes opaque
+  unsigned int srcMask = 0xffffffff;
+  unsigned int alphaOr = 0;
+  if( rmask || gmask || bmask )
+  {
+    srcMask = (rmask ? sf->Rmask : 0) | (gmask ? sf->Gmask : 0) | (bmask ? sf->Bmask : 0) | sf->Amask;
+    alphaOr = amask ? 0 : sf->Amask;
+  }
+
+  int x = dx + picture.getOffset().getX();
+  int y = dy - picture.getOffset().getY();
+
+  const SDL_Rect& clip = dst->clip_rect;
+  int left = std::max<int>( x, clip.x );
+  int top = std::max<int>( y, clip.y );
+  int right = std::min<int>( x + src->w, clip.x + clip.w );
+  int bottom = std::min<int>( y + src->h, clip.y + clip.h );
+
+  if( left >= right || top >= bottom )
+    return true;
+
+  if( SDL_MUSTLOCK( src ) ) { SDL_LockSurface( src ); }
+  if( SDL_MUSTLOCK( dst ) ) { SDL_LockSurface( dst ); }
+
+  const RleSpritePtr& rle = picture.getRle();
+  if( rle.isValid() && alphaOr == 0 && rle->getHeight() == src->h )
+  {
+    // only visible spans are drawn, opaque ones are copied without blending
+    for( int row=top; row < bottom; row++ )
+    {
+      Uint32* dstRow = (Uint32*)( (Uint8*)dst->pixels + row * dst->pitch ) + x;
+      const Uint32* srcRow = (const Uint32*)( (const Uint8*)src->pixels + (row - y) * src->pitch );
+
+      int count = 0;
+      const RleSprite::Span* span = rle->getSpans( row - y, count );
+      for( ; count > 0; count--, span++ )
+      {
+        int start = std::max<int>( span->x, left - x );
+        int stop = std::min<int>( span->x + span->length, right - x );
+        if( start >= stop )
+          continue;
+
+        if( span->opaque )
+        {
+          PixelBlender::copyRow( dstRow + start, srcRow + start, stop - start, srcMask );
+        }
+        else
+        {
+          PixelBlender::blendRow( dstRow + start, srcRow + start, stop - start, srcMask );
+        }
+      }
+    }
+  }
+  else
+  {
+    for( int row=top; row < bottom; row++ )
+    {
+      Uint32* dstRow = (Uint32*)( (Uint8*)dst->pixels + row * dst->pitch ) + left;
+      const Uint32* srcRow = (const Uint32*)( (const Uint8*)src->pixels + (row - y) * src->pitch ) + (left - x);
+
+      PixelBlender::blendRow( dstRow, srcRow, right - left, srcMask, alphaOr );
+    }
+  }
+
+  if( SDL_MUSTLOCK( dst ) ) { SDL_UnlockSurface( dst ); }
+  if( SDL_MUSTLOCK( src ) ) { SDL_UnlockSurface( src ); }
+
+  return true;
+}
+
 void GfxSdlEngine::drawPicture( const Picture &picture, const Point& pos, Rect* clipRect )
 {
-  drawPicture( picture, pos.getX(), pos.getY() );
+  drawPicture( picture, pos.getX(), pos.getY(), clipRect );
 }
 
 void GfxSdlEngine::setTileDrawMask( int rmask, int gmask, int bmask, int amask )
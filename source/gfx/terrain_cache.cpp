@@ -0,0 +1,289 @@
+// This file is part of openCaesar3.
+//
+// openCaesar3 is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// openCaesar3 is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with openCaesar3.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "terrain_cache.hpp"
+#include "tile.hpp"
+#include "engine.hpp"
+#include "picture.hpp"
+#include "tileoverlay.hpp"
+#include "game/tilemap.hpp"
+#include "core/color.hpp"
+#include "core/rectangle.hpp"
+#include "core/logger.hpp"
+
+#include <vector>
+
+namespace {
+  // chunk covers 16x16 tiles of screen
+  static const int chunkWidth = 480;
+  static const int chunkHeight = 240;
+
+  // pictures of flat tiles may overhang their position, tiles around chunk
+  // are drawn into it too, so chunk borders look the same as on screen
+  static const int marginX = 90;
+  static const int marginY = 90;
+
+  // chunks which were not visible so many frames release their pictures
+  static const unsigned int unusedFrames = 64;
+}
+
+class TerrainCache::Impl
+{
+public:
+  typedef std::vector< const Picture* > TilePictures;
+
+  struct Chunk
+  {
+    Picture* picture;
+    bool actual;
+    unsigned int revision;  // revision of terrain storage, when chunk was checked last time
+    unsigned int lastFrame;
+  };
+
+  typedef std::vector< Chunk > Chunks;
+
+  Tilemap* tilemap;
+  Chunks chunks;
+  int cols, rows;
+  Point origin;  // map position of left top chunk corner
+  unsigned int frame;
+
+  // buffers for tiles of current chunk
+  TilePictures pictures;
+  std::vector< Point > positions;
+
+  Rect getChunkRect( int col, int row ) const
+  {
+    return Rect( origin + Point( col * chunkWidth, row * chunkHeight ), Size( chunkWidth, chunkHeight ) );
+  }
+
+  // s=i+j and d=i-j are screen axes of tilemap, returns range of them around rect
+  void getAxes( const Rect& rect, int& minS, int& maxS, int& minD, int& maxD ) const
+  {
+    minS = ( rect.getLeft() - marginX ) / 30 - 1;
+    maxS = ( rect.getRight() + marginX ) / 30 + 1;
+    minD = ( rect.getTop() - marginY ) / 15 - 1;
+    maxD = ( rect.getBottom() + marginY ) / 15 + 1;
+  }
+
+  // returns true if some tile around rect changed after chunk was checked
+  bool isChanged( const Chunk& chunk, const Rect& rect ) const;
+
+  // fills pictures of cached tiles around rect and their positions,
+  // order is the same as order of flat tiles on screen: by rows from far to near
+  void collectTiles( const Rect& rect );
+  void updateChunk( Chunk& chunk, const Rect& rect );
+  void releaseChunk( Chunk& chunk );
+};
+
+TerrainCache::TerrainCache() : _d( new Impl )
+{
+  _d->tilemap = 0;
+  _d->cols = _d->rows = 0;
+  _d->frame = 0;
+}
+
+TerrainCache::~TerrainCache()
+{
+  clear();
+}
+
+void TerrainCache::init( Tilemap& tilemap )
+{
+  clear();
+
+  int size = tilemap.getSize();
+  _d->tilemap = &tilemap;
+
+  // tile (i, j) is placed at x=30*(i+j), y=15*(i-j)
+  _d->origin = Point( -chunkWidth / 2, -15 * size - chunkHeight / 2 );
+  _d->cols = ( 60 * size + chunkWidth ) / chunkWidth + 1;
+  _d->rows = ( 30 * size + chunkHeight ) / chunkHeight + 1;
+
+  Impl::Chunk empty;
+  empty.picture = 0;
+  empty.actual = false;
+  empty.revision = 0;
+  empty.lastFrame = 0;
+  _d->chunks.resize( _d->cols * _d->rows, empty );
+}
+
+void TerrainCache::clear()
+{
+  for( Impl::Chunks::iterator it=_d->chunks.begin(); it != _d->chunks.end(); it++ )
+  {
+    _d->releaseChunk( *it );
+  }
+
+  _d->chunks.clear();
+  _d->cols = _d->rows = 0;
+  _d->tilemap = 0;
+}
+
+bool TerrainCache::isCached( const Tile& tile )
+{
+  return tile.isFlat() && tile.getMasterTile() == 0
+         && tile.getOverlay().isNull() && !tile.getAnimation().isValid();
+}
+
+void TerrainCache::draw( GfxEngine& engine, const Point& offset )
+{
+  if( _d->tilemap == 0 )
+    return;
+
+  _d->frame++;
+
+  // visible part of map
+  Point start = Point( 0, 0 ) - offset - _d->origin;
+  Point stop = start + Point( engine.getScreenWidth(), engine.getScreenHeight() );
+
+  int minCol = std::max( 0, start.getX() / chunkWidth );
+  int minRow = std::max( 0, start.getY() / chunkHeight );
+  int maxCol = std::min( _d->cols - 1, stop.getX() / chunkWidth );
+  int maxRow = std::min( _d->rows - 1, stop.getY() / chunkHeight );
+
+  for( int row=minRow; row <= maxRow; row++ )
+  {
+    for( int col=minCol; col <= maxCol; col++ )
+    {
+      Impl::Chunk& chunk = _d->chunks[ row * _d->cols + col ];
+      Rect rect = _d->getChunkRect( col, row );
+
+      _d->updateChunk( chunk, rect );
+      chunk.lastFrame = _d->frame;
+
+      if( chunk.picture )
+      {
+        engine.drawPicture( *chunk.picture, rect.UpperLeftCorner + offset );
+      }
+    }
+  }
+
+  if( _d->frame % unusedFrames == 0 )
+  {
+    for( Impl::Chunks::iterator it=_d->chunks.begin(); it != _d->chunks.end(); it++ )
+    {
+      if( it->picture && _d->frame - it->lastFrame > unusedFrames )
+      {
+        _d->releaseChunk( *it );
+      }
+    }
+  }
+}
+
+bool TerrainCache::Impl::isChanged( const Chunk& chunk, const Rect& rect ) const
+{
+  const TerrainStorage& terrain = tilemap->getTerrain();
+  if( terrain.getRevision() == chunk.revision )
+    return false;
+
+  int minS, maxS, minD, maxD;
+  getAxes( rect, minS, maxS, minD, maxD );
+
+  int lastIndex = tilemap->getSize() - 1;
+  int minI = std::max( ( minS + minD ) / 2, 0 );
+  int maxI = std::min( ( maxS + maxD ) / 2 + 1, lastIndex );
+  int minJ = std::max( ( minS - maxD ) / 2, 0 );
+  int maxJ = std::min( ( maxS - minD ) / 2 + 1, lastIndex );
+
+  for( int i=minI - minI % TerrainStorage::blockSize; i <= maxI; i += TerrainStorage::blockSize )
+  {
+    for( int j=minJ - minJ % TerrainStorage::blockSize; j <= maxJ; j += TerrainStorage::blockSize )
+    {
+      if( terrain.getBlockRevision( i, j ) > chunk.revision )
+        return true;
+    }
+  }
+
+  return false;
+}
+
+void TerrainCache::Impl::collectTiles( const Rect& rect )
+{
+  pictures.clear();
+  positions.clear();
+
+  int size = tilemap->getSize();
+
+  int minS, maxS, minD, maxD;
+  getAxes( rect, minS, maxS, minD, maxD );
+
+  for( int d=minD; d <= maxD; d++ )
+  {
+    for( int s=minS; s <= maxS; s++ )
+    {
+      if( (s + d) & 1 )
+        continue;
+
+      int i = (s + d) / 2;
+      int j = (s - d) / 2;
+      if( i < 0 || j < 0 || i >= size || j >= size )
+        continue;
+
+      const Tile& tile = tilemap->at( i, j );
+      if( TerrainCache::isCached( tile ) )
+      {
+        pictures.push_back( &tile.getPicture() );
+        positions.push_back( tile.getXY() - rect.UpperLeftCorner );
+      }
+    }
+  }
+}
+
+void TerrainCache::Impl::updateChunk( Chunk& chunk, const Rect& rect )
+{
+  // tiles are collected and drawn only after they changed, or when chunk became visible again
+  bool changed = !chunk.actual || isChanged( chunk, rect );
+  chunk.revision = tilemap->getTerrain().getRevision();
+
+  if( !changed )
+    return;
+
+  collectTiles( rect );
+
+  if( positions.empty() )
+  {
+    // nothing to draw, chunk stays without picture
+    releaseChunk( chunk );
+    chunk.actual = true;
+    return;
+  }
+
+  if( chunk.picture == 0 )
+  {
+    chunk.picture = Picture::create( rect.getSize() );
+  }
+
+  chunk.actual = true;
+  chunk.picture->fill( NColor( 255, 0, 0, 0 ), Rect() );
+
+  std::vector< Point >::iterator pos = positions.begin();
+  for( TilePictures::iterator it=pictures.begin(); it != pictures.end(); it++, pos++ )
+  {
+    chunk.picture->draw( **it, *pos );
+  }
+}
+
+void TerrainCache::Impl::releaseChunk( Chunk& chunk )
+{
+  if( chunk.picture )
+  {
+    Picture::destroy( chunk.picture );
+    delete chunk.picture;
+    chunk.picture = 0;
+  }
+
+  chunk.actual = false;
+}
@@ -0,0 +1,51 @@
+// This file is part of openCaesar3.
+//
+// openCaesar3 is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// openCaesar3 is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with openCaesar3.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __OPENCAESAR3_TERRAIN_CACHE_H_INCLUDED__
+#define __OPENCAESAR3_TERRAIN_CACHE_H_INCLUDED__
+
+#include "core/scopedptr.hpp"
+#include "core/position.hpp"
+
+class Tilemap;
+class Tile;
+class GfxEngine;
+
+// Keeps flat terrain of tilemap pre-drawn in off-screen pictures.
+// Map is divided into fixed screen-space chunks, chunk is drawn once and then
+// copied to screen by one blit. Chunk is redrawn only when tilemap blocks under it
+// were changed, camera moves just select other chunks. Tiles which have overlay or animation
+// are not cached and must be drawn over the chunks as usual, after all cached ones.
+class TerrainCache
+{
+public:
+  TerrainCache();
+  ~TerrainCache();
+
+  void init( Tilemap& tilemap );
+  void clear();
+
+  // returns true if tile is drawn by cache: flat single tile without overlay and animation
+  static bool isCached( const Tile& tile );
+
+  // draws chunks which are visible on screen, offset is position of map on screen
+  void draw( GfxEngine& engine, const Point& offset );
+
+private:
+  class Impl;
+  ScopedPtr< Impl > _d;
+};
+
+#endif //__OPENCAESAR3_TERRAIN_CACHE_H_INCLUDED__
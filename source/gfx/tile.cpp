@@ -20,38 +20,232 @@
 #include "game/resourcegroup.hpp"
 #include "core/stringhelper.hpp"
 
-void Tile::Terrain::reset()
+namespace {
+inline unsigned short bit( Tile::Type type ) { return (unsigned short)( 1 << type ); }
+
+static const unsigned short constructibleMask = bit( Tile::tlWater ) | bit( Tile::tlRock ) | bit( Tile::tlTree )
+                                                | bit( Tile::tlBuilding ) | bit( Tile::tlRoad );
+static const unsigned short destructibleMask = bit( Tile::tlTree ) | bit( Tile::tlBuilding ) | bit( Tile::tlRoad );
+
+// elevation is a part of landscape, clearing of tile keeps it
+static const unsigned short keptOnClearMask = bit( Tile::tlElevation );
+}
+
+TerrainStorage::TerrainStorage() : _side( 0 ), _blocks( 0 ), _revision( 0 )
+{
+  _terrain = TerrainArraysPtr( new TerrainArrays() );
+  _terrain->drop();
+  _terrain->side = 0;
+}
+
+TerrainStorage::~TerrainStorage()
+{
+  _clearAnimations();
+}
+
+void TerrainStorage::_clearAnimations()
+{
+  for( std::vector< Animation* >::iterator it=animations.begin(); it != animations.end(); it++ )
+  {
+    delete *it;
+  }
+}
+
+void TerrainStorage::resize( int side )
 {
-  clearFlags();
-  desirability = 0;
-  watersrvc = 0;
+  int count = side * side;
+
+  // snapshot keeps old arrays, new map gets own ones
+  _terrain = TerrainArraysPtr( new TerrainArrays() );
+  _terrain->drop();
+  _terrain->side = side;
+  _terrain->flags.assign( count, 0 );
+  _terrain->desirability.assign( count, 0 );
+  _terrain->waterService.assign( count, 0 );
+  _terrain->imgId.assign( count, 0 );
+
+  _clearAnimations();
+  pictures.assign( count, NULL );
+  masters.assign( count, NULL );
+  animations.assign( count, NULL );
+
+  // whole map is new for caches which saw old revisions
+  _side = side;
+  _blocks = ( side + blockSize - 1 ) / blockSize;
+  _revision++;
+  _blockRevisions.assign( _blocks * _blocks, _revision );
+}
+
+void TerrainStorage::touch( int index )
+{
+  _revision++;
+  _blockRevisions[ ( index / _side / blockSize ) * _blocks + ( index % _side ) / blockSize ] = _revision;
 }
 
-void Tile::Terrain::clearFlags()
+unsigned int TerrainStorage::getBlockRevision( int i, int j ) const
 {
-  water      = false;
-  rock       = false;
-  tree       = false;
-  building   = false;
-  road       = false;
-  aqueduct   = false;
-  garden     = false;
-  meadow     = false;
-  wall       = false;
-  gatehouse  = false;
+  return _blockRevisions[ ( i / blockSize ) * _blocks + j / blockSize ];
+}
+
+bool TerrainStorage::getFlag( unsigned short value, Tile::Type type )
+{
+  switch( type )
+  {
+  case Tile::isConstructible: return (value & constructibleMask) == 0;
+  case Tile::isDestructible: return (value & destructibleMask) != 0;
+  case Tile::clearAll: case Tile::wasDrawn: return false;
+  default: break;
+  }
+
+  return (value & bit( type )) != 0;
+}
+
+bool TerrainStorage::setFlag( unsigned short& value, Tile::Type type, bool on )
+{
+  unsigned short oldValue = value;
+  switch( type )
+  {
+  case Tile::isConstructible: case Tile::isDestructible: case Tile::wasDrawn: break;
+  case Tile::clearAll: value &= keptOnClearMask; break;
+  default:
+    if( on ) { value |= bit( type ); }
+    else { value &= ~bit( type ); }
+  break;
+  }
+
+  return value != oldValue;
+}
+
+bool TerrainStorage::getFlag( int index, Tile::Type type ) const
+{
+  return getFlag( _terrain->flags[ index ], type );
+}
+
+void TerrainStorage::setFlag( int index, Tile::Type type, bool on )
+{
+  unsigned short value = _terrain->flags[ index ];
+  if( setFlag( value, type, on ) )
+  {
+    editData().flags[ index ] = value;
+    touch( index );
+  }
+}
+
+TerrainArrays& TerrainStorage::editData()
+{
+  if( _terrain->getReferenceCount() > 1 )
+  {
+    // copy is made field by field, reference counter of copy starts from zero
+    const TerrainArrays& shared = *_terrain.object();
+    TerrainArraysPtr own( new TerrainArrays() );
+    own->drop();
+    own->side = shared.side;
+    own->flags = shared.flags;
+    own->desirability = shared.desirability;
+    own->waterService = shared.waterService;
+    own->imgId = shared.imgId;
+    _terrain = own;
+  }
+
+  return *_terrain.object();
 }
 
 Tile::Tile( const TilePos& pos) //: _terrain( 0, 0, 0, 0, 0, 0 )
+  : _pos( pos ), _storage( NULL ), _index( 0 ), _wasDrawn( false )
+{
+  Record empty = { 0, 0, 0, 0, NULL, NULL, NULL };
+  _own = empty;
+}
+
+Tile::Tile()
+  : _storage( NULL ), _index( 0 ), _wasDrawn( false )
+{
+  Record empty = { 0, 0, 0, 0, NULL, NULL, NULL };
+  _own = empty;
+}
+
+Tile::Tile( const Tile& other )
+  : _pos( other._pos ), _storage( NULL ), _index( 0 ), _wasDrawn( other._wasDrawn ),
+    _overlay( other._overlay )
+{
+  Record empty = { 0, 0, 0, 0, NULL, NULL, NULL };
+  _own = empty;
+  _copyRecord( other );
+}
+
+Tile::~Tile()
 {
+  if( _storage == NULL )
+  {
+    delete _own.animation;
+  }
+}
+
+Tile& Tile::operator=( const Tile& other )
+{
+  if( this == &other )
+    return *this;
+
+  _pos = other._pos;
+  _wasDrawn = other._wasDrawn;
+  _overlay = other._overlay;
+  _copyRecord( other );
+
+  return *this;
+}
+
+void Tile::_attach( const TilePos& pos, TerrainStorage& storage, int index )
+{
+  if( _storage == NULL )
+  {
+    delete _own.animation;
+    _own.animation = NULL;
+  }
+
   _pos = pos;
-  _picture = NULL;
-  _wasDrawn = false;
-  _master = NULL;
-  _overlay = NULL;
-  _terrain.reset();
-  _terrain.imgid = 0;
+  _storage = &storage;
+  _index = index;
+}
+
+void Tile::_copyRecord( const Tile& other )
+{
+  const Animation* animation = other._animation();
+
+  // copy keeps values of original, but never refers to its record
+  Record record = { other._flags(), other._desirability(), other._waterService(), other._imgId(),
+                    other._picture(), other._master(),
+                    animation ? new Animation( *animation ) : NULL };
+
+  if( _storage == NULL )
+  {
+    delete _own.animation;
+  }
+
+  _storage = NULL;
+  _index = 0;
+  _own = record;
 }
 
+void Tile::_touch()
+{
+  if( _storage )
+  {
+    _storage->touch( _index );
+  }
+}
+
+unsigned short Tile::_flags() const            { return _storage ? _storage->getData().flags[ _index ] : _own.flags; }
+short Tile::_desirability() const              { return _storage ? _storage->getData().desirability[ _index ] : _own.desirability; }
+unsigned short Tile::_waterService() const     { return _storage ? _storage->getData().waterService[ _index ] : _own.waterService; }
+unsigned short Tile::_imgId() const            { return _storage ? _storage->getData().imgId[ _index ] : _own.imgId; }
+unsigned short& Tile::_editFlags()             { return _storage ? _storage->editData().flags[ _index ] : _own.flags; }
+short& Tile::_editDesirability()               { return _storage ? _storage->editData().desirability[ _index ] : _own.desirability; }
+unsigned short& Tile::_editWaterService()      { return _storage ? _storage->editData().waterService[ _index ] : _own.waterService; }
+unsigned short& Tile::_editImgId()             { return _storage ? _storage->editData().imgId[ _index ] : _own.imgId; }
+const Picture*& Tile::_picture() const         { return _storage ? _storage->pictures[ _index ] : _own.picture; }
+Tile*& Tile::_master() const                   { return _storage ? _storage->masters[ _index ] : _own.master; }
+Animation*& Tile::_animation() const           { return _storage ? _storage->animations[ _index ] : _own.animation; }
+
 int Tile::getI() const    {   return _pos.getI();   }
 
 int Tile::getJ() const    {   return _pos.getJ();   }
@@ -59,7 +253,12 @@ int Tile::getJ() const    {   return _pos.getJ();   }
 
 void Tile::setPicture(const Picture *picture)
 {
-  _picture = picture;
+  const Picture*& current = _picture();
+  if( current != picture )
+  {
+    current = picture;
+    _touch();
+  }
 }
 
 void Tile::setPicture(const char* rc, const int index)
@@ -74,24 +273,31 @@ void Tile::setPicture(const std::string& name)
 
 const Picture& Tile::getPicture() const
 {
-  _OC3_DEBUG_BREAK_IF( !_picture && "error: picture is null");
+  const Picture* picture = _picture();
+  _OC3_DEBUG_BREAK_IF( !picture && "error: picture is null");
 
-  return *_picture;
+  return *picture;
 }
 
 Tile* Tile::getMasterTile() const
 {
-  return _master;
+  return _master();
 }
 
 void Tile::setMasterTile(Tile* master)
 {
-  _master = master;
+  Tile*& current = _master();
+  if( current != master )
+  {
+    current = master;
+    _touch();
+  }
 }
 
 bool Tile::isFlat() const
 {
-  return !(_terrain.rock || _terrain.tree || _terrain.building || _terrain.aqueduct);
+  static const unsigned short mask = bit( tlRock ) | bit( tlTree ) | bit( tlBuilding ) | bit( tlAqueduct );
+  return (_flags() & mask) == 0;
 }
 
 TilePos Tile::getIJ() const
@@ -101,7 +307,7 @@ TilePos Tile::getIJ() const
 
 bool Tile::isMasterTile() const
 {
-  return (_master == this);
+  return (_master() == this);
 }
 
 Point Tile::getXY() const
@@ -111,26 +317,46 @@ Point Tile::getXY() const
 
 void Tile::animate(unsigned int time)
 {
-  if( _overlay.isNull() && _animation.isValid() )
+  Animation* animation = _animation();
+  if( _overlay.isNull() && animation != NULL )
   {
-    _animation.update( time );
+    animation->update( time );
   }
 }
 
 const Animation&Tile::getAnimation() const
 {
-  return _animation;
+  static const Animation invalidAnimation;
+  const Animation* animation = _animation();
+  return animation ? *animation : invalidAnimation;
 }
 
 void Tile::setAnimation(const Animation& animation)
 {
-  _animation = animation;
+  _touch();
+
+  Animation*& current = _animation();
+  if( !animation.isValid() )
+  {
+    delete current;
+    current = NULL;
+  }
+  else if( current == NULL )
+  {
+    current = new Animation( animation );
+  }
+  else if( current != &animation )
+  {
+    *current = animation;
+  }
 }
 
 bool Tile::isWalkable( bool alllands ) const
 {
   // TODO: test building to allow garden, gatehouse, granary, ...
-  bool walkable = (_terrain.road || (alllands && !_terrain.water && !_terrain.tree && !_terrain.rock));
+  static const unsigned short landMask = bit( tlWater ) | bit( tlTree ) | bit( tlRock );
+  unsigned short flags = _flags();
+  bool walkable = ( (flags & bit( tlRoad )) != 0 || (alllands && (flags & landMask) == 0) );
   if( _overlay.isValid() )
   {
     walkable &= _overlay->isWalkable();
@@ -141,63 +367,37 @@ bool Tile::isWalkable( bool alllands ) const
 
 bool Tile::getFlag(Tile::Type type) const
 {
-  switch( type )
-  {
-  case tlRoad: return _terrain.road;
-  case tlWater: return _terrain.water;
-  case tlTree: return _terrain.tree;
-  case isConstructible:
-  {
-    return !(_terrain.water || _terrain.rock || _terrain.tree || _terrain.building || _terrain.road);
-  }
-  case tlMeadow: return _terrain.meadow;
-  case tlRock: return _terrain.rock;
-  case tlBuilding: return _terrain.building;
-  case tlAqueduct: return _terrain.aqueduct;
-  case isDestructible:
-  {
-    return (_terrain.tree || _terrain.building || _terrain.road);
-  }
-  case tlGarden: return _terrain.garden;
-  case tlElevation: return _terrain.elevation;
-  case tlWall: return _terrain.wall;
-  case tlGateHouse: return _terrain.gatehouse;
-  case wasDrawn: return _wasDrawn;
-  default: break;
-  }
+  if( type == wasDrawn )
+    return _wasDrawn;
 
-  return false;
+  return TerrainStorage::getFlag( _flags(), type );
 }
 
 void Tile::setFlag(Tile::Type type, bool value)
 {
-  switch( type )
+  if( type == wasDrawn )
   {
-  case tlRoad: _terrain.road = value; break;
-  case tlWater: _terrain.water = value; break;
-  case tlTree: _terrain.tree = value; break;
-  case tlMeadow: _terrain.meadow = value; break;
-  case tlRock: _terrain.rock = value; break;
-  case tlBuilding: _terrain.building = value; break;
-  case tlAqueduct: _terrain.aqueduct = value; break;
-  case tlGarden: _terrain.garden = value; break;
-  case tlElevation: _terrain.elevation = value; break;
-  case clearAll: _terrain.clearFlags(); break;
-  case tlWall: _terrain.wall = value; break;
-  case tlGateHouse: _terrain.gatehouse = value; break;
-  case wasDrawn: _wasDrawn = value; break;
-  default: break;
+    _wasDrawn = value;
+    return;
+  }
+
+  unsigned short flags = _flags();
+  if( TerrainStorage::setFlag( flags, type, value ) )
+  {
+    _editFlags() = flags;
+    _touch();
   }
 }
 
 void Tile::appendDesirability(int value)
 {
-   _terrain.desirability = math::clamp( _terrain.desirability += value, -0xff, 0xff );
+  short& desirability = _editDesirability();
+  desirability = math::clamp( desirability + value, -0xff, 0xff );
 }
 
 int Tile::getDesirability() const
 {
-  return _terrain.desirability;
+  return _desirability();
 }
 
 TileOverlayPtr Tile::getOverlay() const
@@ -207,37 +407,42 @@ TileOverlayPtr Tile::getOverlay() const
 
 void Tile::setOverlay(TileOverlayPtr overlay)
 {
-  _overlay = overlay;
+  if( _overlay != overlay )
+  {
+    _overlay = overlay;
+    _touch();
+  }
 }
 
 unsigned int Tile::getOriginalImgId() const
 {
-  return _terrain.imgid;
+  return _imgId();
 }
 
 void Tile::setOriginalImgId(unsigned short id)
 {
-  _terrain.imgid = id;
+  _editImgId() = id;
 }
 
 void Tile::fillWaterService(const WaterService type)
 {
-  _terrain.watersrvc |= (0xf << (type*4));
+  _editWaterService() |= (0xf << (type*4));
 }
 
 void Tile::decreaseWaterService(const WaterService type)
 {
-  int tmpSrvValue = (_terrain.watersrvc >> (type*4)) & 0xf;
+  unsigned short& watersrvc = _editWaterService();
+  int tmpSrvValue = (watersrvc >> (type*4)) & 0xf;
   //tmpSrvValue = math::clamp( tmpSrvValue-1, 0, 0xf );
   tmpSrvValue = 0;
 
-  _terrain.watersrvc &= ~(0xf<<(type*4));
-  _terrain.watersrvc |= tmpSrvValue << (type*4);
+  watersrvc &= ~(0xf<<(type*4));
+  watersrvc |= tmpSrvValue << (type*4);
 }
 
 int Tile::getWaterService(const WaterService type) const
 {
-  return (_terrain.watersrvc >> (type*4)) & 0xf;
+  return (_waterService() >> (type*4)) & 0xf;
 }
 
 std::string TileHelper::convId2PicName( const unsigned int imgId )
@@ -326,15 +531,25 @@ int TileHelper::convPicName2Id( const std::string &pic_name )
 
 int TileHelper::encode(const Tile& tt)
 {
-  int res = tt.getFlag( Tile::tlTree ) ? 0x11 : 0;
-  res += tt.getFlag( Tile::tlRock ) ? 0x2 : 0;
-  res += tt.getFlag( Tile::tlWater ) ? 0x4 : 0;
-  res += tt.getFlag( Tile::tlBuilding ) ? 0x8 : 0;
-  res += tt.getFlag( Tile::tlRoad ) ? 0x40 : 0;
-  res += tt.getFlag( Tile::tlMeadow ) ? 0x800 : 0;
-  res += tt.getFlag( Tile::tlWall ) ? 0x4000 : 0;
-  res += tt.getFlag( Tile::tlElevation ) ? 0x200 : 0;
-  res += tt.getFlag( Tile::tlGateHouse ) ? 0x8000 : 0;
+  return encode( tt._flags() );
+}
+
+int TileHelper::encode( const TerrainStorage& terrain, int index )
+{
+  return encode( terrain.getData().flags[ index ] );
+}
+
+int TileHelper::encode( unsigned short flags )
+{
+  int res = (flags & bit( Tile::tlTree )) ? 0x11 : 0;
+  res += (flags & bit( Tile::tlRock )) ? 0x2 : 0;
+  res += (flags & bit( Tile::tlWater )) ? 0x4 : 0;
+  res += (flags & bit( Tile::tlBuilding )) ? 0x8 : 0;
+  res += (flags & bit( Tile::tlRoad )) ? 0x40 : 0;
+  res += (flags & bit( Tile::tlMeadow )) ? 0x800 : 0;
+  res += (flags & bit( Tile::tlWall )) ? 0x4000 : 0;
+  res += (flags & bit( Tile::tlElevation )) ? 0x200 : 0;
+  res += (flags & bit( Tile::tlGateHouse )) ? 0x8000 : 0;
   return res;
 }
 
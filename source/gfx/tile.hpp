@@ -20,45 +20,33 @@
 #include "gfx/animation.hpp"
 #include "game/enums.hpp"
 #include "core/predefinitions.hpp"
+#include "core/referencecounted.hpp"
+
+#include <vector>
 
 class Picture;
+class TerrainStorage;
 
 // a Tile in the Tilemap
+// terrain and render data of tiles are kept by Tilemap in parallel arrays,
+// tile object itself is a light handle to its record in them.
+// Copy of tile is standalone: it keeps values of original in small own record,
+// so changes of copy don't reach tilemap
 class Tile
 {
-  struct Terrain
-  {
-    bool water;
-    bool rock;
-    bool tree;
-    bool building;
-    bool road;
-    bool garden;
-    bool aqueduct;
-    bool meadow;
-    bool elevation;
-    bool wall;
-    bool gatehouse;
-    int  desirability;
-    int  watersrvc;
-
-    /*
-     * original tile information
-     */
-    unsigned short int imgid;
-    unsigned short int terraininfo;
-
-    void reset();
-    void clearFlags();
-  };
-
 public:
   typedef enum { tlRoad=0, tlWater, tlTree, tlMeadow, tlRock, tlBuilding, tlAqueduct,
                  tlGarden, tlElevation, tlWall, tlGateHouse,
                  isConstructible, isDestructible, clearAll,
                  wasDrawn } Type;
 
-  Tile(const TilePos& pos);
+  // tile outside of tilemap, terrain is stored by tile
+  Tile( const TilePos& pos );
+
+  Tile( const Tile& other );
+  ~Tile();
+
+  Tile& operator=( const Tile& other );
 
   // tile coordinates
   int getI() const;
@@ -107,13 +95,110 @@ public:
   int getWaterService( const WaterService type ) const;
 
 private:
+  friend class TileHelper;
+  friend class Tilemap;
+
+  // values of standalone tile, tile of tilemap keeps them in storage
+  struct Record
+  {
+    unsigned short flags;
+    short desirability;
+    unsigned short waterService;
+    unsigned short imgId;
+    const Picture* picture;
+    Tile* master;
+    Animation* animation;
+  };
+
+  // tile without terrain, tilemap attaches its tiles to storage after creation
+  Tile();
+  void _attach( const TilePos& pos, TerrainStorage& storage, int index );
+  void _copyRecord( const Tile& other );
+  void _touch();
+
+  // terrain values, setters write through editable ones
+  unsigned short _flags() const;
+  short _desirability() const;
+  unsigned short _waterService() const;
+  unsigned short _imgId() const;
+  unsigned short& _editFlags();
+  short& _editDesirability();
+  unsigned short& _editWaterService();
+  unsigned short& _editImgId();
+
+  const Picture*& _picture() const;
+  Tile*& _master() const;
+  Animation*& _animation() const;
+
   TilePos _pos; // coordinates of the tile
-  Tile* _master;  // left-most tile if multi-tile, or "this" if single-tile
-  Terrain _terrain;    // infos about the tile (building, tree, road, water, rock...)
-  Picture const* _picture; // displayed picture
+  TerrainStorage* _storage; // arrays of tilemap, NULL for standalone tile
+  int _index;        // index of tile in storage
   bool _wasDrawn;
-  Animation _animation;
   TileOverlayPtr _overlay;
+  mutable Record _own;
+};
+
+// terrain arrays of tilemap, they may be shared with snapshot of background save.
+// TerrainStorage copies them before first change after that. Snapshot is grabbed
+// and dropped in main thread, worker only reads arrays
+class TerrainArrays : public ReferenceCounted
+{
+public:
+  int side;
+  std::vector< unsigned short > flags;         // bit per terrain type, see Tile::Type
+  std::vector< short > desirability;
+  std::vector< unsigned short > waterService;  // 4 bits per WaterService type
+  std::vector< unsigned short > imgId;         // original tile information
+};
+
+// terrain and render data of tiles, every field is stored in own array,
+// so scans over whole map read only the data they need
+class TerrainStorage
+{
+public:
+  // changes of terrain, picture, master or overlay of tiles are counted by square blocks of map,
+  // caches compare revisions of blocks which they use instead of scanning tiles
+  static const int blockSize = 16;
+
+  // render data, simulation doesn't read it
+  std::vector< const Picture* > pictures;
+  std::vector< Tile* > masters;
+  std::vector< Animation* > animations;        // only few tiles are animated, others keep null
+
+  TerrainStorage();
+  ~TerrainStorage();
+
+  // records for square map, index of tile (i, j) is i * side + j
+  void resize( int side );
+  bool getFlag( int index, Tile::Type type ) const;
+  void setFlag( int index, Tile::Type type, bool value );
+
+  const TerrainArrays& getData() const { return *_terrain.object(); }
+  // terrain for writing, detaches it from snapshot
+  TerrainArrays& editData();
+  // shares current terrain arrays, they are not changed while result is alive
+  TerrainArraysPtr share() const { return _terrain; }
+
+  static bool getFlag( unsigned short flags, Tile::Type type );
+  // returns true if flags were changed
+  static bool setFlag( unsigned short& flags, Tile::Type type, bool value );
+
+  // marks tile as changed, revision of storage and of tile block goes up
+  void touch( int index );
+  unsigned int getRevision() const { return _revision; }
+  // revision of last change in block which contains tile (i, j)
+  unsigned int getBlockRevision( int i, int j ) const;
+
+private:
+  TerrainStorage( const TerrainStorage& );
+  TerrainStorage& operator=( const TerrainStorage& );
+  void _clearAnimations();
+
+  TerrainArraysPtr _terrain;
+  int _side;
+  int _blocks;  // blocks on one side of map
+  unsigned int _revision;
+  std::vector< unsigned int > _blockRevisions;
 };
 
 class TileHelper
@@ -122,6 +207,8 @@ public:
   static std::string convId2PicName( const unsigned int imgId );
   static int convPicName2Id( const std::string &pic_name);
   static int encode( const Tile& tt );
+  static int encode( const TerrainStorage& terrain, int index );
+  static int encode( unsigned short flags );
 
   static void decode( Tile& tile, const int bitset);
   static Tile& getInvalid();
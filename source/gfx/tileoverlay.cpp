@@ -37,6 +37,7 @@ public:
   Animation animation;  // basic animation (if any)
   bool isDeleted;
   CityPtr city;
+  TileOverlay::IndexPosition indexPosition;
 };
 
 TileOverlay::TileOverlay(const Type type, const Size& size)
@@ -56,6 +57,11 @@ TileOverlay::~TileOverlay()
 }
 
 
+TileOverlay::IndexPosition& TileOverlay::indexPosition()
+{
+  return _d->indexPosition;
+}
+
 TileOverlay::Type TileOverlay::getType() const
 {
    return _d->overlayType;
@@ -71,6 +77,7 @@ void TileOverlay::setType(const Type type)
 }
 
 void TileOverlay::timeStep(const unsigned long time) {}
+void TileOverlay::scheduleJobs( TickScheduler& scheduler ) {}
 
 void TileOverlay::setPicture(Picture picture)
 {
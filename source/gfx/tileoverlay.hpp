@@ -24,6 +24,8 @@
 #include "core/scopedptr.hpp"
 #include "renderer.hpp"
 
+class TickScheduler;
+
 class TileOverlay : public Serializable, public ReferenceCounted
 {
 public:
@@ -50,6 +52,9 @@ public:
   virtual Point getOffset( const Point& subpos ) const;
   virtual void timeStep(const unsigned long time);  // perform one simulation step
 
+  // registers periodic work of overlay, city calls it when overlay is added
+  virtual void scheduleJobs( TickScheduler& scheduler );
+
   // graphic
   void setPicture(Picture picture);
   void setPicture(const char* resource, const int index);
@@ -70,6 +75,17 @@ public:
   virtual void save( VariantMap& stream) const;
   virtual void load( const VariantMap& stream );
 
+  // place of overlay in city lists by type and group, city removes it without search
+  struct IndexPosition
+  {
+    Type type;
+    Group group;
+    TileOverlayList::iterator byType;
+    TileOverlayList::iterator byGroup;
+  };
+
+  IndexPosition& indexPosition();
+
 protected:
   Animation& _animationRef();
   Tile* _getMasterTile();
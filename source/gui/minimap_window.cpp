@@ -41,7 +41,7 @@ public:
   int lastTimeUpdate;
   Point center;
 
-  void getTerrainColours(const Tile& tile, int &c1, int &c2);
+  void getTerrainColours(int i, int j, int &c1, int &c2);
   void getBuildingColours(const Tile& tile, int &c1, int &c2);
   void updateImage();
 };
@@ -64,50 +64,52 @@ Point getBitmapCoordinates(int x, int y, int mapsize )
 
 void getBuildingColours( const Tile& tile, int &c1, int &c2);
 
-void Minimap::Impl::getTerrainColours(const Tile& tile, int &c1, int &c2)
+void Minimap::Impl::getTerrainColours(int i, int j, int &c1, int &c2)
 {
-  int rndData = tile.getI() * tile.getJ();
+  const TerrainStorage& terrain = tilemap->getTerrain();
+  int index = i * tilemap->getSize() + j;
+  int rndData = i * j;
   int num3 = rndData & 3;
   int num7 = rndData & 7;
 
-  if (tile.getFlag( Tile::tlTree ))
+  if (terrain.getFlag( index, Tile::tlTree ))
   {
     c1 = colors->colour(MinimapColors::MAP_TREE1, num3);
     c2 = colors->colour(MinimapColors::MAP_TREE2, num3);
   }
-  else if (tile.getFlag( Tile::tlRock ))
+  else if (terrain.getFlag( index, Tile::tlRock ))
   {
     c1 = colors->colour(MinimapColors::MAP_ROCK1, num3);
     c2 = colors->colour(MinimapColors::MAP_ROCK2, num3);
   }
-  else if (tile.getFlag( Tile::tlWater ))
+  else if (terrain.getFlag( index, Tile::tlWater ))
   {
     c1 = colors->colour(MinimapColors::MAP_WATER1, num3);
     c2 = colors->colour(MinimapColors::MAP_WATER2, num3);
   }
-  else if (tile.getFlag( Tile::tlRoad ))
+  else if (terrain.getFlag( index, Tile::tlRoad ))
   {
     c1 = colors->colour(MinimapColors::MAP_ROAD, 0);
     c2 = colors->colour(MinimapColors::MAP_ROAD, 1);
   }
-  else if (tile.getFlag( Tile::tlMeadow ))
+  else if (terrain.getFlag( index, Tile::tlMeadow ))
   {
     c1 = colors->colour(MinimapColors::MAP_FERTILE1, num3);
     c2 = colors->colour(MinimapColors::MAP_FERTILE2, num3);
   }
-  else if (tile.getFlag( Tile::tlWall ))
+  else if (terrain.getFlag( index, Tile::tlWall ))
   {
     c1 = colors->colour(MinimapColors::MAP_WALL, 0);
     c2 = colors->colour(MinimapColors::MAP_WALL, 1);
   }
-  else if (tile.getFlag( Tile::tlAqueduct )) // and not tile.isRoad()
+  else if (terrain.getFlag( index, Tile::tlAqueduct )) // and not tile.isRoad()
   {
     c1 = colors->colour(MinimapColors::MAP_AQUA, 0);
     c2 = colors->colour(MinimapColors::MAP_AQUA, 1);
   }
-  else if (tile.getFlag( Tile::tlBuilding ))
+  else if (terrain.getFlag( index, Tile::tlBuilding ))
   {
-    getBuildingColours(tile, c1, c2);
+    getBuildingColours( tilemap->at( i, j ), c1, c2 );
   }
   else // plain terrain
   {
@@ -193,11 +195,9 @@ void Minimap::Impl::updateImage()
   {
     for (int x = border; x < max; x++)
     {
-      const Tile& tile = tilemap->at(x - border, y - border);
-
       Point pnt = getBitmapCoordinates(x - border, y - border, mapsize);
       int c1, c2;
-      getTerrainColours( tile, c1, c2);
+      getTerrainColours( x - border, y - border, c1, c2);
 
       if( pnt.getX() >= fullmap->getWidth()-1 || pnt.getY() >= fullmap->getHeight() )
         continue;
@@ -50,6 +50,16 @@ public:
   \return Returns a pointer to the created file on success, or 0 on failure. */
   virtual NFile createAndOpenFile( unsigned int index) =0;
 
+  //! Unpacks file into memory of caller
+  /** \param index The zero based index of the file.
+  \param size Size of buffer, must be equal to size of file in list
+  \return Returns true if whole file was read */
+  virtual bool extract( unsigned int index, void* buffer, unsigned int size )
+  {
+    NFile file = createAndOpenFile( index );
+    return file.isOpen() && file.read( buffer, size ) == (int)size;
+  }
+
   //! Returns the complete file tree
   /** \return Returns the complete directory tree for the archive,
   including all files and folders */
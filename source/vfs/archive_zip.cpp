@@ -69,6 +69,25 @@ bool ZipArchiveLoader::isALoadableFileFormat( Archive::Type fileType) const
 ArchivePtr ZipArchiveLoader::createArchive(const FilePath& filename, bool ignoreCase, bool ignorePaths) const
 {
   ArchivePtr archive;
+
+  // archive on disk is mapped, entries are read without seeks and extra copies
+  if( filename.isExist() )
+  {
+    MappedFile* mapping = new MappedFile();
+    if( mapping->open( filename.getAbsolutePath() ) && mapping->getSize() >= 4 )
+    {
+      const unsigned int sig = *(const unsigned int*)mapping->data();
+      if( sig == 0x04034b50 || (sig&0xffff) == 0x8b1f )
+      {
+        archive = new ZipArchiveReader( mapping, ignoreCase, ignorePaths );
+        archive->drop();
+        return archive;
+      }
+    }
+
+    delete mapping;
+  }
+
   NFile file = _fileSystem->createAndOpenFile(filename, FSEntity::fmRead );
 
   if( file.isOpen() )
@@ -133,16 +152,39 @@ ZipArchiveReader::ZipArchiveReader( NFile file, bool ignoreCase, bool ignorePath
 
     if( file.isOpen() )
 	{
-		// load file entries
-		if (IsGZip)
-			while (scanGZipHeader()) { }
-		else
-			while (scanZipHeader()) { }
-
-		sort();
+		scanEntries();
 	}
 }
 
+ZipArchiveReader::ZipArchiveReader( MappedFile* mapping, bool ignoreCase, bool ignorePaths )
+ : FileList( mapping->getFileName(), ignoreCase, ignorePaths ),
+   Mapping( mapping )
+{
+  #ifdef _DEBUG
+    FileList::setDebugName( "ZipReader");
+  #endif
+
+  File = MemoryFile::create( Mapping->data(), Mapping->getSize(), Mapping->getFileName(), false );
+
+  unsigned short sig = 0;
+  File.read( &sig, 2 );
+  File.seek( 0 );
+  IsGZip = (sig == 0x8b1f);
+
+  scanEntries();
+}
+
+void ZipArchiveReader::scanEntries()
+{
+  // load file entries
+  if (IsGZip)
+    while (scanGZipHeader()) { }
+  else
+    while (scanZipHeader()) { }
+
+  sort();
+}
+
 ZipArchiveReader::~ZipArchiveReader()
 {
 }
@@ -450,10 +492,15 @@ NFile ZipArchiveReader::createAndOpenFile(unsigned int index)
   //98 - PPMd - Compression Method, WinZip 10
   //99 - AES encryption, WinZip 9
 
-  const SZipFileEntry &e = FileInfo[ _getItems()[index].iD ];
+  if( index >= getFileCount() )
+  {
+    return NFile();
+  }
+
+  const FileListItem& item = getItems()[ index ];
+  const SZipFileEntry &e = FileInfo[ item.iD ];
 
   short actualCompressionMethod=e.header.CompressionMethod;
-  NFile decrypted;
   ByteArray decryptedBuf;
   unsigned int decryptedSize=e.header.DataDescriptor.CompressedSize;
 
@@ -514,7 +561,6 @@ NFile ZipArchiveReader::createAndOpenFile(unsigned int index)
       return NFile();
     }
 
-    decrypted = MemoryFile::create( decryptedBuf, _getItems()[ index ].fullName );
     actualCompressionMethod = (e.header.Sig & 0xffff);
 #if 0
     if ((e.header.Sig & 0xff000000)==0x01000000)
@@ -531,182 +577,198 @@ NFile ZipArchiveReader::createAndOpenFile(unsigned int index)
 #endif
   }
 
-  switch(actualCompressionMethod)
+
+  if( decryptedBuf.empty() )
   {
-    case 0: // no compression
+    // stored file of mapped archive is opened without copying
+    const char* mapped = getMappedData( e, decryptedSize );
+    if( actualCompressionMethod == 0 && mapped )
     {
-      if( decrypted.isOpen() )
-          return decrypted;
-      else
-      {
-          File.seek( e.Offset );
-          ByteArray data = File.read( decryptedSize );
-          return MemoryFile::create( data, _getItems()[ index ].fullName );
-      }
+      return MemoryFile::createView( mapped, decryptedSize, item.fullName, static_cast< Archive* >( this ) );
     }
-    break;
 
-    case 8:
+    char* buffer = new char[ item.size ];
+    if( !extract( index, buffer, item.size ) )
     {
-      const unsigned int uncompressedSize = e.header.DataDescriptor.UncompressedSize;
-      ByteArray pBuf;
-      pBuf.resize( uncompressedSize );
+      delete [] buffer;
+      return NFile();
+    }
 
-      ByteArray pcData;
-      pcData.resize( decryptedSize );
+    return MemoryFile::create( buffer, item.size, item.fullName, true );
+  }
 
-      if( pBuf.empty() || pcData.empty() )
-      {
-        Logger::warning( "Not enough memory for decompressing %s", _getItems()[ index ].fullName.toString().c_str() );
-        return NFile();
-      }
+  if( actualCompressionMethod == 0 )
+  {
+    return MemoryFile::create( decryptedBuf, item.fullName );
+  }
 
-      File.seek(e.Offset);
-      pcData = File.read(decryptedSize);
+  char* buffer = new char[ item.size ];
+  if( !decompress( e, actualCompressionMethod, decryptedBuf.data(), decryptedSize, buffer, item.size, item.fullName ) )
+  {
+    delete [] buffer;
+    return NFile();
+  }
 
-      // Setup the inflate stream.
-      z_stream stream;
-      int err;
+  return MemoryFile::create( buffer, item.size, item.fullName, true );
+}
 
-      stream.next_in = (Bytef*)pcData.data();
-                        stream.avail_in = (uInt)decryptedSize;
-      stream.next_out = (Bytef*)pBuf.data();
-			stream.avail_out = uncompressedSize;
-			stream.zalloc = (alloc_func)0;
-			stream.zfree = (free_func)0;
+bool ZipArchiveReader::extract( unsigned int index, void* buffer, unsigned int size )
+{
+  if( index >= getFileCount() || size != getFileSize( index ) )
+  {
+    return false;
+  }
 
-      // Perform inflation. wbits < 0 indicates no zlib header inside the data.
-      err = inflateInit2(&stream, -MAX_WBITS);
-      if (err == Z_OK)
-      {
-        err = inflate(&stream, Z_FINISH);
-        inflateEnd(&stream);
+  const FileListItem& item = getItems()[ index ];
+  const SZipFileEntry &e = FileInfo[ item.iD ];
 
-	if (err == Z_STREAM_END)
-			err = Z_OK;
-	err = Z_OK;
-	inflateEnd(&stream);
-      }
+  if( e.header.GeneralBitFlag & ZIP_FILE_ENCRYPTED )
+  {
+    Logger::warning( "Can't extract encrypted file %s", item.fullName.toString().c_str() );
+    return false;
+  }
 
-      if (err != Z_OK)
-      {
-        Logger::warning( "Error decompressing %s", _getItems()[index].fullName.toString().c_str() );
-        return NFile();
-      }
-      else
+  const unsigned int packedSize = e.header.DataDescriptor.CompressedSize;
+  const char* source = getMappedData( e, packedSize );
+
+  ByteArray packedData;
+  if( !source )
+  {
+    File.seek( e.Offset );
+    packedData = File.read( packedSize );
+    if( packedData.size() != packedSize )
+    {
+      Logger::warning( "Can't read file %s ", item.fullName.toString().c_str() );
+      return false;
+    }
+
+    source = packedData.data();
+  }
+
+  return decompress( e, e.header.CompressionMethod, source, packedSize, (char*)buffer, size, item.fullName );
+}
+
+const char* ZipArchiveReader::getMappedData( const SZipFileEntry& e, unsigned int size ) const
+{
+  if( Mapping.isNull() || e.Offset < 0
+      || (unsigned int)e.Offset > Mapping->getSize() || size > Mapping->getSize() - e.Offset )
+  {
+    return 0;
+  }
+
+  return Mapping->data() + e.Offset;
+}
+
+bool ZipArchiveReader::decompress( const SZipFileEntry& e, short method, const char* source, unsigned int sourceSize,
+                                   char* buffer, unsigned int size, const FilePath& name )
+{
+  switch( method )
+  {
+    case 0: // no compression
+    {
+      if( sourceSize >= size )
       {
-        return MemoryFile::create( pBuf, _getItems()[index].fullName );
+        memcpy( buffer, source, size );
+        return true;
       }
     }
     break;
 
-    case 12:
+    case 8:
     {
-      const unsigned int uncompressedSize = e.header.DataDescriptor.UncompressedSize;
-      ByteArray pBuf;
-      pBuf.resize( uncompressedSize );
-
-      ByteArray pcData;
-      pcData.resize( decryptedSize );
+      // Setup the inflate stream.
+      z_stream stream;
+      stream.next_in = (Bytef*)source;
+      stream.avail_in = (uInt)sourceSize;
+      stream.next_out = (Bytef*)buffer;
+      stream.avail_out = size;
+      stream.zalloc = (alloc_func)0;
+      stream.zfree = (free_func)0;
+      stream.opaque = (voidpf)0;
 
-      if( pBuf.empty() || pcData.empty() )
+      // Perform inflation. wbits < 0 indicates no zlib header inside the data.
+      if( inflateInit2(&stream, -MAX_WBITS) == Z_OK )
       {
-        Logger::warning( "Not enough memory for decompressing %s", _getItems()[index].fullName.toString().c_str() );
-        return NFile();
-      }
+        int err = inflate(&stream, Z_FINISH);
+        inflateEnd(&stream);
 
-      File.seek(e.Offset);
-      pcData = File.read(decryptedSize);
+        if( err == Z_STREAM_END || stream.avail_out == 0 )
+        {
+          return true;
+        }
+      }
+    }
+    break;
 
+    case 12:
+    {
       bz_stream bz_ctx={0};
-			/* use BZIP2's default memory allocation
-			bz_ctx->bzalloc = NULL;
-			bz_ctx->bzfree  = NULL;
-			bz_ctx->opaque  = NULL;
-			*/
+      /* use BZIP2's default memory allocation */
       int err = BZ2_bzDecompressInit(&bz_ctx, 0, 0); /* decompression */
       if(err != BZ_OK)
       {
         Logger::warning( "bzip2 decompression failed. File cannot be read." );
-        return NFile();
+        return false;
       }
 
-      bz_ctx.next_in = (char*)pcData.data();
-			bz_ctx.avail_in = decryptedSize;
-			/* pass all input to decompressor */
-      bz_ctx.next_out = pBuf.data();
-			bz_ctx.avail_out = uncompressedSize;
-			err = BZ2_bzDecompress(&bz_ctx);
-			err = BZ2_bzDecompressEnd(&bz_ctx);
+      /* pass all input to decompressor */
+      bz_ctx.next_in = (char*)source;
+      bz_ctx.avail_in = sourceSize;
+      bz_ctx.next_out = buffer;
+      bz_ctx.avail_out = size;
+      err = BZ2_bzDecompress(&bz_ctx);
+      BZ2_bzDecompressEnd(&bz_ctx);
 
-      if (err != BZ_OK)
+      if( err == BZ_STREAM_END || (err == BZ_OK && bz_ctx.avail_out == 0) )
       {
-        Logger::warning( "Error decompressing %s", _getItems()[index].fullName.toString().c_str() );
-        return NFile();
-      }
-      else
-      {
-        return MemoryFile::create( pBuf, _getItems()[index].fullName );
+        return true;
       }
     }
     break;
 
     case 14:
     {
-      unsigned int uncompressedSize = e.header.DataDescriptor.UncompressedSize;
-      ByteArray pBuf;
-      pBuf.resize( uncompressedSize );
-      ByteArray pcData;
-      pcData.resize( decryptedSize );
-      if( pBuf.empty() || pcData.empty() )
-      {
-        Logger::warning( "Not enough memory for decompressing %s", _getItems()[index].fullName.toString().c_str() );
-        return NFile();
-      }
-
-      File.seek(e.Offset);
-      pcData = File.read(decryptedSize);
-
-                          ELzmaStatus status;
-                          SizeT tmpDstSize = uncompressedSize;
-                          SizeT tmpSrcSize = decryptedSize;
-
-      unsigned int propSize = (pcData[3]<<8)+pcData[2];
-      int err = LzmaDecode((Byte*)pBuf.data(), &tmpDstSize,
-              (Byte*)pcData.data()+4+propSize, &tmpSrcSize,
-              (Byte*)pcData.data()+4, propSize,
-                                          e.header.GeneralBitFlag&0x1?LZMA_FINISH_END:LZMA_FINISH_ANY, &status,
-                                          &lzmaAlloc);
-                          uncompressedSize = tmpDstSize; // may be different to expected value
-
-      if (err != SZ_OK)
-      {
-        Logger::warning( "Error decompressing %s", _getItems()[index].fullName.toString().c_str() );
-        return NFile();
-      }
-      else
+      if( sourceSize < 4 )
+        break;
+
+      ELzmaStatus status;
+      SizeT tmpDstSize = size;
+      SizeT tmpSrcSize = sourceSize;
+
+      const unsigned char* props = (const unsigned char*)source;
+      unsigned int propSize = (props[3]<<8)+props[2];
+      if( 4 + propSize > sourceSize )
+        break;
+
+      tmpSrcSize -= 4 + propSize;
+      int err = LzmaDecode((Byte*)buffer, &tmpDstSize,
+                           props+4+propSize, &tmpSrcSize,
+                           props+4, propSize,
+                           e.header.GeneralBitFlag&0x1?LZMA_FINISH_END:LZMA_FINISH_ANY, &status,
+                           &lzmaAlloc);
+      if( err == SZ_OK )
       {
-        return MemoryFile::create( pBuf, _getItems()[index].fullName );
+        return true;
       }
     }
     break;
 
     case 99:
     {
-                // If we come here with an encrypted file, decryption support is missing
-            //os::Printer::log("Decryption support not enabled. File cannot be read.", ELL_ERROR);
-      return NFile();
+      // If we come here with an encrypted file, decryption support is missing
+      Logger::warning( "Decryption support not enabled. File %s cannot be read.", name.toString().c_str() );
+      return false;
     }
 
     default:
     {
-      Logger::warning( "file %s has unsupported compression method", _getItems()[index].fullName.toString().c_str() );
-      return NFile();
+      Logger::warning( "file %s has unsupported compression method", name.toString().c_str() );
+      return false;
     }
   }
 
-  Logger::warning( "Can't read file %s ", _getItems()[index].fullName.toString().c_str() );
-  return NFile();
+  Logger::warning( "Error decompressing %s", name.toString().c_str() );
+  return false;
 }
 
 std::string ZipArchiveReader::getTypeName() const
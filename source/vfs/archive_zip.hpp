@@ -20,6 +20,8 @@
 #include "file.hpp"
 #include "archive.hpp"
 #include "filelist.hpp"
+#include "mappedfile.hpp"
+#include "core/scopedptr.hpp"
 
 namespace io
 {
@@ -194,6 +196,10 @@ public:
   //! constructor
   ZipArchiveReader( NFile file, bool ignoreCase, bool ignorePaths, bool isGZip=false);
 
+  //! reads archive from memory mapped file, reader takes ownership of mapping.
+  //! Stored files are opened as views into mapping without copying
+  ZipArchiveReader( MappedFile* mapping, bool ignoreCase, bool ignorePaths );
+
   //! destructor
   virtual ~ZipArchiveReader();
 
@@ -203,6 +209,10 @@ public:
   //! opens a file by index
   virtual NFile createAndOpenFile(unsigned int index);
 
+  //! unpacks file into buffer of caller, size must be equal to size of file in list
+  /** Encrypted files can't be unpacked this way, use createAndOpenFile() for them. */
+  virtual bool extract( unsigned int index, void* buffer, unsigned int size );
+
   //! returns the list of files
   virtual const FileList* getFileList() const;
 
@@ -212,6 +222,9 @@ public:
   Archive::Type getType() const;
 protected:
 
+  //! fills file list from headers of archive
+  void scanEntries();
+
   //! reads the next file header from a ZIP file, returns false if there are no more headers.
   /* if ignoreGPBits is set, the item will be read despite missing
      file information. This is used when reading items from the central
@@ -223,8 +236,18 @@ protected:
 
   bool scanCentralDirectoryHeader();
 
+  //! unpacks data of entry from source into buffer, returns false on error
+  bool decompress( const SZipFileEntry& e, short method, const char* source, unsigned int sourceSize,
+                   char* buffer, unsigned int size, const FilePath& name );
+
+  //! returns packed data of entry when it lies in mapping, 0 otherwise
+  const char* getMappedData( const SZipFileEntry& e, unsigned int size ) const;
+
   NFile File;
 
+  //! whole archive in memory, File reads it when archive is mapped
+  ScopedPtr< MappedFile > Mapping;
+
   // holds extended info about files
   std::vector< SZipFileEntry > FileInfo;
 
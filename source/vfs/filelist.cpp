@@ -29,8 +29,56 @@ public:
   //! Path to the file list
   FilePath path;
   Items files;
+
+  //! Open addressing table with indexes of files by hash of full name,
+  //! -1 marks empty slot. Built by sort(), empty table means linear search
+  std::vector< int > index;
+
+  void rebuildIndex();
+  std::string normalize( const FilePath& filename ) const;
 };
 
+void FileList::Impl::rebuildIndex()
+{
+  unsigned int slotsCount = 16;
+  while( slotsCount < files.size() * 2 )
+  {
+    slotsCount <<= 1;
+  }
+
+  index.assign( slotsCount, -1 );
+  const unsigned int mask = slotsCount - 1;
+  for( unsigned int k=0; k < files.size(); k++ )
+  {
+    unsigned int slot = StringHelper::hash( files[ k ].fullName.toString() ) & mask;
+    while( index[ slot ] >= 0 )
+    {
+      slot = (slot + 1) & mask;
+    }
+
+    // items with same name keep order of list, so first of them is found
+    index[ slot ] = k;
+  }
+}
+
+std::string FileList::Impl::normalize( const FilePath& filename ) const
+{
+  FilePath ret = StringHelper::replace( filename.toString(), "\\", "/" );
+  ret = ret.removeEndSlash();
+
+  if( ignoreCase )
+  {
+    ret = StringHelper::localeLower( ret.toString() );
+  }
+
+  if( ignorePaths )
+  {
+    ret = ret.getBasename();
+  }
+
+  return ret.toString();
+}
+
 FileList::FileList( const FilePath& path, bool ignoreCase, bool ignorePaths )
  : _d( new Impl )
 {
@@ -54,6 +102,7 @@ FileList& FileList::operator=( const FileList& other )
   _d->path = other._d->path;
 
   _d->files.clear();
+  _d->index.clear();
 
   ItemIt it = other._d->files.begin();
   for( ; it != other._d->files.end(); it++ )
@@ -91,6 +140,7 @@ unsigned int FileList::getFileCount() const
 void FileList::sort()
 {
   std::sort( _d->files.begin(), _d->files.end() );
+  _d->rebuildIndex();
 }
 
 const FilePath& FileList::getFileName(unsigned int index) const
@@ -144,6 +194,7 @@ unsigned int FileList::addItem( const FilePath& fullPath, unsigned int offset, u
   }
 
   _d->files.push_back(entry);
+  _d->index.clear();
 
   return _d->files.size() - 1;
 }
@@ -178,31 +229,25 @@ unsigned int FileList::getFileOffset(unsigned int index) const
 //! Searches for a file or folder within the list, returns the index
 int FileList::findFile(const FilePath& filename, bool isDirectory) const
 {
-  FileListItem entry;
-  // we only need fullName to be set for the search
-  entry.fullName = StringHelper::replace( filename.toString(), "\\", "/" );
-  entry.isDirectory = isDirectory;
+  const std::string name = _d->normalize( filename );
 
-  // remove trailing slash
-  if( *entry.fullName.toString().rbegin() == '/' )
+  if( !_d->index.empty() )
   {
-    entry.isDirectory = true;
-  }
-  entry.fullName = entry.fullName.removeEndSlash();
-
-  if( _d->ignoreCase )
-  {
-    entry.fullName = StringHelper::localeLower( entry.fullName.toString() );
-  }
+    const unsigned int mask = _d->index.size() - 1;
+    for( unsigned int slot = StringHelper::hash( name ) & mask; _d->index[ slot ] >= 0; slot = (slot + 1) & mask )
+    {
+      if( _d->files[ _d->index[ slot ] ].fullName == name )
+      {
+        return _d->index[ slot ];
+      }
+    }
 
-  if( _d->ignorePaths )
-  {
-    entry.fullName = entry.fullName.getBasename();
+    return -1;
   }
 
   for( Items::iterator it=_d->files.begin(); it != _d->files.end(); it++ )
   {
-    if( (*it).fullName == entry.fullName )
+    if( (*it).fullName == name )
     {
       return std::distance( _d->files.begin(), it );
     }
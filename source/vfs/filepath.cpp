@@ -139,7 +139,7 @@ FilePath FilePath::removeEndSlash() const
 
   if( (*pathTo.rbegin()) == '/' || (*pathTo.rbegin()) == '\\' )
   {
-      pathTo.erase( pathTo.rbegin().base() );
+      pathTo.erase( pathTo.size() - 1 );
   }
 
   return pathTo;
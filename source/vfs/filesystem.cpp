@@ -20,6 +20,9 @@
 #include "filelist.hpp"
 #include "archive_zip.hpp"
 #include "core/logger.hpp"
+#include "core/stringhelper.hpp"
+
+#include <map>
 
 #if defined (OC3_PLATFORM_WIN)
 	#include <direct.h> // for _chdir
@@ -53,9 +56,88 @@ public:
 
   Mode fileSystemType;
 
+  //! file with number index in file list of archive with number archive
+  struct IndexEntry
+  {
+    unsigned int archive;
+    unsigned int index;
+  };
+
+  typedef std::multimap< unsigned int, IndexEntry > PathIndex;
+
+  //! files of all mounted archives by hash of their case folded names
+  PathIndex pathIndex;
+
   ArchivePtr changeArchivePassword( const FilePath& filename, const std::string& password );
+
+  //! adds files of last mounted archive to index
+  void appendArchive( ArchivePtr archive );
+
+  //! index refers archives by number, so it is rebuilt when they move
+  void rebuildPathIndex();
+
+  //! finds file in archive with the highest priority, returns false if no archive has it
+  bool findFile( const FilePath& filename, IndexEntry& entry ) const;
 };
 
+void FileSystem::Impl::appendArchive( ArchivePtr archive )
+{
+  openArchives.push_back( archive );
+
+  IndexEntry entry;
+  entry.archive = openArchives.size() - 1;
+
+  const FileList* files = archive->getFileList();
+  for( entry.index=0; entry.index < files->getFileCount(); entry.index++ )
+  {
+    std::string name = StringHelper::localeLower( files->getFullFileName( entry.index ).toString() );
+    pathIndex.insert( std::make_pair( StringHelper::hash( name ), entry ) );
+  }
+}
+
+void FileSystem::Impl::rebuildPathIndex()
+{
+  std::vector< ArchivePtr > archives;
+  archives.swap( openArchives );
+  pathIndex.clear();
+
+  for( unsigned int i=0; i < archives.size(); i++ )
+  {
+    appendArchive( archives[ i ] );
+  }
+}
+
+bool FileSystem::Impl::findFile( const FilePath& filename, IndexEntry& found ) const
+{
+  FilePath path = StringHelper::replace( filename.toString(), "\\", "/" );
+  std::string fullName = StringHelper::localeLower( path.removeEndSlash().toString() );
+  std::string baseName = FilePath( fullName ).getBasename().toString();
+
+  // archives which ignore paths keep only base names of files
+  unsigned int hashes[ 2 ] = { StringHelper::hash( fullName ), StringHelper::hash( baseName ) };
+  const int hashesCount = (fullName == baseName ? 1 : 2);
+
+  found.archive = openArchives.size();
+  for( int k=0; k < hashesCount; k++ )
+  {
+    std::pair< PathIndex::const_iterator, PathIndex::const_iterator > range = pathIndex.equal_range( hashes[ k ] );
+    for( PathIndex::const_iterator it=range.first; it != range.second; ++it )
+    {
+      const IndexEntry& entry = it->second;
+      if( entry.archive >= found.archive )
+        continue;
+
+      // archive checks name by own rules of case and paths, as before index was added
+      if( openArchives[ entry.archive ]->getFileList()->findFile( filename ) == (int)entry.index )
+      {
+        found = entry;
+      }
+    }
+  }
+
+  return found.archive < openArchives.size();
+}
+
 ArchivePtr FileSystem::Impl::changeArchivePassword(const FilePath& filename, const std::string& password )
 {
   for (int idx = 0; idx < (int)openArchives.size(); ++idx)
@@ -97,18 +179,38 @@ FileSystem::~FileSystem()
 
 NFile FileSystem::loadFileFromArchive( const FilePath& filePath )
 {
-  for( unsigned int i=0; i< _d->openArchives.size(); ++i)
+  Impl::IndexEntry entry;
+  if( _d->findFile( filePath, entry ) )
   {
-    NFile file = _d->openArchives[i]->createAndOpenFile( filePath );
-    if( file.isOpen() )
-    {
-      return file;
-    }
+    return _d->openArchives[ entry.archive ]->createAndOpenFile( entry.index );
   }
 
   return NFile();
 }
 
+bool FileSystem::readFile( const FilePath& filename, ByteArray& buffer )
+{
+  Impl::IndexEntry entry;
+  if( _d->findFile( filename, entry ) )
+  {
+    ArchivePtr archive = _d->openArchives[ entry.archive ];
+    unsigned int size = archive->getFileList()->getFileSize( entry.index );
+    buffer.resize( size );
+
+    return size == 0 || archive->extract( entry.index, buffer.data(), size );
+  }
+
+  NFile file( new FileNative( filename.getAbsolutePath(), FSEntity::fmRead ) );
+  if( !file.isOpen() )
+  {
+    buffer.clear();
+    return false;
+  }
+
+  buffer.resize( file.getSize() );
+  return buffer.empty() || file.read( buffer.data(), buffer.size() ) == (int)buffer.size();
+}
+
 //! opens a file for read access
 NFile FileSystem::createAndOpenFile(const FilePath& filename, FSEntity::Mode mode)
 {
@@ -171,6 +273,11 @@ bool FileSystem::moveFileArchive(unsigned int sourceIndex, int relative)
 		r = true;
 	}
 
+	if( r )
+	{
+		_d->rebuildPathIndex();
+	}
+
 	return r;
 }
 
@@ -271,7 +378,7 @@ ArchivePtr FileSystem::mountArchive(  const FilePath& filename,
 
   if( archive.isValid() )
   {
-    _d->openArchives.push_back( archive );
+    _d->appendArchive( archive );
     if( password.size() )
     {
         archive->Password=password;
@@ -366,7 +473,7 @@ ArchivePtr FileSystem::mountArchive(NFile file, Archive::Type archiveType,
     if( archive.isValid() )
     {
       Logger::warning( "Mount archive %s", file.getFileName().toString().c_str() );
-      _d->openArchives.push_back(archive);
+      _d->appendArchive( archive );
 
       if (password.size())
       {
@@ -396,7 +503,7 @@ ArchivePtr FileSystem::mountArchive( ArchivePtr archive)
 		}
 	}
 
-	_d->openArchives.push_back(archive);
+	_d->appendArchive( archive );
     return archive;
 }
 
@@ -407,8 +514,8 @@ bool FileSystem::unmountArchive(unsigned int index)
 	bool ret = false;
 	if (index < _d->openArchives.size())
 	{
-		_d->openArchives[index]->drop();
 		_d->openArchives.erase( _d->openArchives.begin() + index );
+		_d->rebuildPathIndex();
 		ret = true;
 	}
 
@@ -672,9 +779,9 @@ FileList FileSystem::getFileList()
 //! determines if a file exists and would be able to be opened.
 bool FileSystem::existFile(const FilePath& filename) const
 {
-  for (unsigned int i=0; i < _d->openArchives.size(); ++i)
-      if (_d->openArchives[i]->getFileList()->findFile(filename)!=-1)
-              return true;
+  Impl::IndexEntry entry;
+  if( _d->findFile( filename, entry ) )
+    return true;
 
 #if defined(OC3_PLATFORM_WIN)
   return ( _access( filename.toString().c_str(), 0) != -1);
@@ -49,6 +49,10 @@ public:
   //! opens a file in archive, if not exists return 0
   virtual NFile loadFileFromArchive( const FilePath& filePath );
 
+  //! reads whole file into buffer, memory of buffer is reused when it is big enough.
+  //! Files of archives are unpacked straight into buffer
+  bool readFile( const FilePath& filename, ByteArray& buffer );
+
   //! Adds an archive to the file system.
   virtual ArchivePtr mountArchive( const FilePath& filename,
                                    Archive::Type archiveType=Archive::unknown,
@@ -0,0 +1,163 @@
+// This file is part of openCaesar3.
+//
+// openCaesar3 is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// openCaesar3 is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with openCaesar3.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "mappedfile.hpp"
+#include "core/platform.hpp"
+#include "core/logger.hpp"
+
+#if defined(OC3_PLATFORM_WIN)
+  #include <windows.h>
+#elif defined(OC3_PLATFORM_UNIX)
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <fcntl.h>
+  #include <unistd.h>
+#endif
+
+namespace io
+{
+
+class MappedFile::Impl
+{
+public:
+  FilePath fileName;
+  char* data;
+  unsigned int size;
+
+#if defined(OC3_PLATFORM_WIN)
+  HANDLE file;
+  HANDLE mapping;
+#endif
+};
+
+MappedFile::MappedFile() : _d( new Impl )
+{
+  _d->data = 0;
+  _d->size = 0;
+#if defined(OC3_PLATFORM_WIN)
+  _d->file = INVALID_HANDLE_VALUE;
+  _d->mapping = NULL;
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+  close();
+}
+
+bool MappedFile::open( const FilePath& fileName )
+{
+  close();
+  _d->fileName = fileName;
+
+#if defined(OC3_PLATFORM_WIN)
+  _d->file = CreateFileA( fileName.toString().c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                          OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL );
+  if( _d->file == INVALID_HANDLE_VALUE )
+  {
+    Logger::warning( "MappedFile: can't open %s", fileName.toString().c_str() );
+    return false;
+  }
+
+  DWORD size = GetFileSize( _d->file, NULL );
+  if( size == 0 || size == INVALID_FILE_SIZE )
+  {
+    close();
+    return false;
+  }
+
+  _d->mapping = CreateFileMappingA( _d->file, NULL, PAGE_WRITECOPY, 0, 0, NULL );
+  if( _d->mapping != NULL )
+  {
+    _d->data = (char*)MapViewOfFile( _d->mapping, FILE_MAP_COPY, 0, 0, 0 );
+  }
+
+  _d->size = size;
+#elif defined(OC3_PLATFORM_UNIX)
+  int fd = ::open( fileName.toString().c_str(), O_RDONLY );
+  if( fd < 0 )
+  {
+    Logger::warning( "MappedFile: can't open %s", fileName.toString().c_str() );
+    return false;
+  }
+
+  struct stat info;
+  if( fstat( fd, &info ) == 0 && info.st_size > 0 )
+  {
+    void* ptr = mmap( 0, info.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0 );
+    if( ptr != MAP_FAILED )
+    {
+      _d->data = (char*)ptr;
+      _d->size = (unsigned int)info.st_size;
+    }
+  }
+
+  // mapping stays valid after descriptor is closed
+  ::close( fd );
+#endif
+
+  if( _d->data == 0 )
+  {
+    Logger::warning( "MappedFile: can't map %s", fileName.toString().c_str() );
+    close();
+    return false;
+  }
+
+  return true;
+}
+
+void MappedFile::close()
+{
+#if defined(OC3_PLATFORM_WIN)
+  if( _d->data ) { UnmapViewOfFile( _d->data ); }
+  if( _d->mapping != NULL ) { CloseHandle( _d->mapping ); }
+  if( _d->file != INVALID_HANDLE_VALUE ) { CloseHandle( _d->file ); }
+
+  _d->mapping = NULL;
+  _d->file = INVALID_HANDLE_VALUE;
+#elif defined(OC3_PLATFORM_UNIX)
+  if( _d->data ) { munmap( _d->data, _d->size ); }
+#endif
+
+  _d->data = 0;
+  _d->size = 0;
+}
+
+bool MappedFile::isOpen() const
+{
+  return _d->data != 0;
+}
+
+char* MappedFile::data()
+{
+  return _d->data;
+}
+
+const char* MappedFile::data() const
+{
+  return _d->data;
+}
+
+unsigned int MappedFile::getSize() const
+{
+  return _d->size;
+}
+
+const FilePath& MappedFile::getFileName() const
+{
+  return _d->fileName;
+}
+
+} //end namespace io
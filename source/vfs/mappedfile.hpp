@@ -0,0 +1,53 @@
+// This file is part of openCaesar3.
+//
+// openCaesar3 is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// openCaesar3 is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with openCaesar3.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __OC3_MAPPED_FILE_H_INCLUDED__
+#define __OC3_MAPPED_FILE_H_INCLUDED__
+
+#include "filepath.hpp"
+#include "core/scopedptr.hpp"
+
+namespace io
+{
+
+/*!
+  Native file mapped into memory. Pages are read by OS on first access,
+  writes go to private copy of page and never reach the file.
+*/
+class MappedFile
+{
+public:
+  MappedFile();
+  ~MappedFile();
+
+  bool open( const FilePath& fileName );
+  void close();
+
+  bool isOpen() const;
+
+  char* data();
+  const char* data() const;
+  unsigned int getSize() const;
+
+  const FilePath& getFileName() const;
+
+private:
+  class Impl;
+  ScopedPtr< Impl > _d;
+};
+
+} //end namespace io
+
+#endif //__OC3_MAPPED_FILE_H_INCLUDED__
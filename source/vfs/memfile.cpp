@@ -26,6 +26,7 @@ MemoryFile::MemoryFile()
     Len = 0;
     Pos = 0;
     deleteMemoryWhenDropped = false;
+    Owner = 0;
 
 #ifdef _DEBUG
         setDebugName(L"MemoryFile");
@@ -64,10 +65,31 @@ NFile MemoryFile::create( ByteArray data, const FilePath& fileName )
     return NFile( ret );
 }
 
+NFile MemoryFile::createView( const void* memory, long len, const FilePath& fileName, const ReferenceCounted* owner )
+{
+    MemoryFile* mf = new MemoryFile();
+    mf->Buffer = const_cast< void* >( memory );
+    mf->Len  = len;
+    mf->Pos = 0;
+    mf->Filename = fileName;
+    mf->Owner = owner;
+
+    if( owner )
+        owner->grab();
+
+    FSEntityPtr ret( mf );
+    ret->drop();
+
+    return NFile( ret );
+}
+
 MemoryFile::~MemoryFile()
 {
 	if (deleteMemoryWhenDropped)
         delete [] (char*)Buffer;
+
+    if( Owner )
+        Owner->drop();
 }
 
 
@@ -138,6 +160,10 @@ ByteArray MemoryFile::readLine()
 //! returns how much was written
 int MemoryFile::write(const void* buffer, unsigned int sizeToWrite)
 {
+    // views share memory of owner and are read only
+    if( Owner )
+        return 0;
+
     int amount = static_cast<int>(sizeToWrite);
 	if (Pos + amount > Len)
 		amount -= Pos + amount - Len;
@@ -66,6 +66,9 @@ public:
   static NFile create( void* memory, long len, const FilePath& fileName, bool deleteMemoryWhenDropped );
   static NFile create( ByteArray data, const FilePath& fileName );
 
+  //! reads memory of owner without copying, owner is grabbed while file exists
+  static NFile createView( const void* memory, long len, const FilePath& fileName, const ReferenceCounted* owner );
+
 private:
   MemoryFile();
 
@@ -74,6 +77,7 @@ private:
   long Pos;
   FilePath Filename;
   bool deleteMemoryWhenDropped;
+  const ReferenceCounted* Owner;
 };
 
 } //end namespace io
@@ -112,16 +112,16 @@ void ServiceWalker::_computeWalkerPath()
 {  
   Propagator pathPropagator( _getCity() );
   pathPropagator.init( _d->base.as<Construction>() );
-  Propagator::PathWayList pathWayList = pathPropagator.getWays(_d->maxDistance);
+  const Propagator::PathWayList& pathWayList = pathPropagator.getWays(_d->maxDistance);
 
   float maxPathValue = 0.0;
-  Pathway* bestPath = NULL;
-  foreach( Pathway& current, pathWayList )
+  const Pathway* bestPath = NULL;
+  for( Propagator::PathWayList::const_iterator it=pathWayList.begin(); it != pathWayList.end(); it++ )
   {
-    float pathValue = evaluatePath(current);
+    float pathValue = evaluatePath(*it);
     if (pathValue > maxPathValue)
     {
-      bestPath = &current;
+      bestPath = &(*it);
       maxPathValue = pathValue;
     }
   }
@@ -158,8 +158,8 @@ ServiceWalker::ReachedBuildings ServiceWalker::getReachedBuildings(const TilePos
   int reachDistance = getReachDistance();
   TilePos start = pos - TilePos( reachDistance, reachDistance );
   TilePos stop = pos + TilePos( reachDistance, reachDistance );
-  TilemapArea reachedTiles = _getCity()->getTilemap().getArea( start, stop );
-  foreach( Tile* tile, reachedTiles )
+  Tilemap& tilemap = _getCity()->getTilemap();
+  for( TileRange tile=TileRange::area( tilemap, start, stop ); tile.isValid(); tile.next() )
   {
     BuildingPtr building = tile->getOverlay().as<Building>();
     if( building.isValid() )
@@ -171,15 +171,15 @@ ServiceWalker::ReachedBuildings ServiceWalker::getReachedBuildings(const TilePos
   return res;
 }
 
-float ServiceWalker::evaluatePath( Pathway& pathWay )
+float ServiceWalker::evaluatePath( const Pathway& pathWay )
 {
   // evaluate all buildings along the path
   ServiceWalker::ReachedBuildings doneBuildings;  // list of evaluated building: don't do them again
-  ConstTilemapTiles& pathTileList = pathWay.getAllTiles();
+  const ConstTilemapTiles& pathTileList = pathWay.getAllTiles();
 
   int distance = 0;
   float res = 0.0;
-  for( ConstTilemapTiles::iterator itTile = pathTileList.begin(); itTile != pathTileList.end(); ++itTile)
+  for( ConstTilemapTiles::const_iterator itTile = pathTileList.begin(); itTile != pathTileList.end(); ++itTile)
   {
     ServiceWalker::ReachedBuildings reachedBuildings = getReachedBuildings( (*itTile)->getIJ() );
     foreach( BuildingPtr building, reachedBuildings )
@@ -201,13 +201,13 @@ float ServiceWalker::evaluatePath( Pathway& pathWay )
   return res;
 }
 
-void ServiceWalker::reservePath(Pathway &pathWay)
+void ServiceWalker::reservePath( const Pathway& pathWay )
 {
   // reserve all buildings along the path
   ReachedBuildings doneBuildings;  // list of evaluated building: don't do them again
-  ConstTilemapTiles& pathTileList = pathWay.getAllTiles();
+  const ConstTilemapTiles& pathTileList = pathWay.getAllTiles();
 
-  for( ConstTilemapTiles::iterator itTile = pathTileList.begin(); itTile != pathTileList.end(); ++itTile)
+  for( ConstTilemapTiles::const_iterator itTile = pathTileList.begin(); itTile != pathTileList.end(); ++itTile)
   {
     ReachedBuildings reachedBuildings = getReachedBuildings( (*itTile)->getIJ() );
     foreach( BuildingPtr building, reachedBuildings )
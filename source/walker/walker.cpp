@@ -34,6 +34,29 @@
 
 using namespace constants;
 
+// Movement of walker for one tick. City computes it on worker threads before
+// walkers are updated: it depends only on walker's own state. Sub-tile steps
+// stop on first crossing of tile border or middle, crossing is kept here and
+// walk() applies it later on game thread, in order of walkers list.
+struct WalkStep
+{
+  bool ready;
+
+  // state that step was computed from
+  Direction direction;
+  TilePos pos;
+  Point tileOffset;
+  PointF remainMove;
+  float speed;
+
+  // state after step
+  TilePos nextPos;
+  Point nextOffset;
+  PointF nextRemainMove;
+  int amountI, amountJ;   // movement left after crossing
+  bool newTile, midTile;  // crossing found on the way
+};
+
 class Walker::Impl
 {
 public:
@@ -55,12 +78,21 @@ public:
   std::string name;
   int health;
   AbilityList abilities;
+  WalkStep step;
 
   float getSpeed() const
   {
     return speedMultiplier * speed;
   }
 
+  // walker may be moved or turned after step was prepared
+  bool isActual( const WalkStep& s ) const
+  {
+    return s.ready && s.direction == action.direction && s.pos == pos && s.tileOffset == tileOffset
+           && s.remainMove.getX() == remainMove.getX() && s.remainMove.getY() == remainMove.getY()
+           && s.speed == getSpeed();
+  }
+
   void updateSpeedMultiplier( const Tile& tile ) 
   {
     speedMultiplier = (tile.getFlag( Tile::tlRoad ) || tile.getFlag( Tile::tlGarden )) ? 1.f : 0.5f;
@@ -82,6 +114,7 @@ Walker::Walker( CityPtr city ) : _d( new Impl )
 
   _d->midTilePos = Point( 7, 7 );
   _d->remainMove = PointF( 0, 0 );
+  _d->step.ready = false;
 }
 
 Walker::~Walker()
@@ -132,11 +165,17 @@ bool Walker::isDeleted() const
 
 void Walker::setIJ( const TilePos& pos )
 {
+   TilePos oldPos = _d->pos;
    _d->pos = pos;
 
    _d->tileOffset = _d->midTilePos;
 
    _d->posOnMap = Point( _d->pos.getI(), _d->pos.getJ() ) * 15 + _d->tileOffset;
+
+   if( oldPos != _d->pos )
+   {
+     _d->city->updateWalkerPos( this, oldPos );
+   }
 }
 
 int Walker::getI() const
@@ -227,105 +266,190 @@ void Walker::dec(int &ioSI, int &ioI, int &ioAmount, const int iMidPos, bool &oN
    ioSI -= delta;
 }
 
-void Walker::walk()
+bool Walker::_walkSegment( int& amountI, int& amountJ, int& x, int& y, int& i, int& j,
+                           bool& newTile, bool& midTile )
 {
-   if( constants::noneDirection == _d->action.direction )
-   {
-      // nothing to do
-      return;
-   }
+  switch (_d->action.direction)
+  {
+  case constants::north:
+     inc(y, j, amountJ, _d->midTilePos.getY(), newTile, midTile);
+  break;
 
-   Tile& tile = _d->city->getTilemap().at( getIJ() );
-    
-   switch (_d->action.direction)
+  case constants::northEast:
+     inc(y, j, amountJ, _d->midTilePos.getY(), newTile, midTile);
+     inc(x, i, amountI, _d->midTilePos.getX(), newTile, midTile);
+  break;
+
+  case constants::east:
+     inc(x, i, amountI, _d->midTilePos.getX(), newTile, midTile);
+  break;
+
+  case constants::southEast:
+     dec(y, j, amountJ, _d->midTilePos.getY(), newTile, midTile);
+     inc(x, i, amountI, _d->midTilePos.getX(), newTile, midTile);
+  break;
+
+  case constants::south:
+     dec(y, j, amountJ, _d->midTilePos.getY(), newTile, midTile);
+  break;
+
+  case constants::southWest:
+     dec(y, j, amountJ, _d->midTilePos.getY(), newTile, midTile);
+     dec(x, i, amountI, _d->midTilePos.getX(), newTile, midTile);
+  break;
+
+  case constants::west:
+     dec(x, i, amountI, _d->midTilePos.getX(), newTile, midTile);
+  break;
+
+  case constants::northWest:
+     inc(y, j, amountJ, _d->midTilePos.getY(), newTile, midTile);
+     dec(x, i, amountI, _d->midTilePos.getX(), newTile, midTile);
+  break;
+
+  default:
+     return false;
+  }
+
+  return true;
+}
+
+bool Walker::_computeStep()
+{
+   WalkStep& step = _d->step;
+   step.ready = false;
+   step.direction = _d->action.direction;
+   step.pos = _d->pos;
+   step.tileOffset = _d->tileOffset;
+   step.remainMove = _d->remainMove;
+   step.speed = _d->getSpeed();
+
+   PointF move = step.remainMove;
+   switch( step.direction )
    {
    case constants::north:
    case constants::south:
-     _d->remainMove += PointF( 0, _d->getSpeed() );
+     move += PointF( 0, step.speed );
    break;
 
    case constants::east:
    case constants::west:
-     _d->remainMove += PointF( _d->getSpeed(), 0 );
+     move += PointF( step.speed, 0 );
    break;
 
    case constants::northEast:
    case constants::southWest:
    case constants::southEast:
    case constants::northWest:
-      _d->remainMove += PointF( _d->getSpeed() * 0.7f, _d->getSpeed() * 0.7f );
+     move += PointF( step.speed * 0.7f, step.speed * 0.7f );
    break;
 
    default:
+     return false;
+   }
+
+   step.amountI = int( move.getX() );
+   step.amountJ = int( move.getY() );
+   step.nextRemainMove = move - Point( step.amountI, step.amountJ ).toPointF();
+
+   int x = step.tileOffset.getX();
+   int y = step.tileOffset.getY();
+   int i = step.pos.getI();
+   int j = step.pos.getJ();
+   step.newTile = false;
+   step.midTile = false;
+   while( step.amountI + step.amountJ > 0 && !(step.newTile || step.midTile) )
+   {
+     _walkSegment( step.amountI, step.amountJ, x, y, i, j, step.newTile, step.midTile );
+   }
+
+   step.nextPos = TilePos( i, j );
+   step.nextOffset = Point( x, y );
+   step.ready = true;
+
+   return true;
+}
+
+void Walker::prepareWalk()
+{
+  _d->step.ready = false;
+  if( _d->action.action == acMove )
+  {
+    _computeStep();
+  }
+}
+
+void Walker::walk()
+{
+   if( constants::noneDirection == _d->action.direction )
+   {
+      // nothing to do
+      return;
+   }
+
+   Tile& tile = _d->city->getTilemap().at( getIJ() );
+
+   if( !_d->isActual( _d->step ) && !_computeStep() )
+   {
       Logger::warning( "Invalid move direction: %d", _d->action.direction );
       _d->action.direction = constants::noneDirection;
-   break;
    }
-   
 
    bool newTile = false;
    bool midTile = false;
-   int amountI = int(_d->remainMove.getX());
-   int amountJ = int(_d->remainMove.getY());
-   _d->remainMove -= Point( amountI, amountJ ).toPointF();
+   int amountI = 0;
+   int amountJ = 0;
 
-   // std::cout << "walker step, amount :" << amount << std::endl;
+   if( _d->step.ready )
+   {
+     WalkStep& step = _d->step;
+     step.ready = false;
+
+     newTile = step.newTile;
+     midTile = step.midTile;
+     amountI = step.amountI;
+     amountJ = step.amountJ;
+
+     _d->remainMove = step.nextRemainMove;
+     _d->tileOffset = step.nextOffset;
+     TilePos oldPos = _d->pos;
+     _d->pos = step.nextPos;
+
+     // side effects of crossing found by worker are applied here,
+     // in order of walkers list
+     if (newTile)
+     {
+        _d->city->updateWalkerPos( this, oldPos );
+        onNewTile();
+     }
+
+     if (midTile)
+     {
+        onMidTile();
+     }
+   }
+
+   // movement left after first crossing, direction may be changed by it
    int tmpX = _d->tileOffset.getX();
    int tmpY = _d->tileOffset.getY();
    int tmpJ = _d->pos.getJ();
    int tmpI = _d->pos.getI();
    while (amountI+amountJ > 0)
    {
-      switch (_d->action.direction)
+      if( !_walkSegment( amountI, amountJ, tmpX, tmpY, tmpI, tmpJ, newTile, midTile ) )
       {
-      case constants::north:
-         inc(tmpY, tmpJ, amountJ, _d->midTilePos.getY(), newTile, midTile);
-      break;
-
-      case constants::northEast:
-         inc(tmpY, tmpJ, amountJ, _d->midTilePos.getY(), newTile, midTile);
-         inc(tmpX, tmpI, amountI, _d->midTilePos.getX(), newTile, midTile);
-      break;
-
-      case constants::east:
-         inc(tmpX, tmpI, amountI, _d->midTilePos.getX(), newTile, midTile);
-      break;
-
-      case constants::southEast:
-         dec(tmpY, tmpJ, amountJ, _d->midTilePos.getY(), newTile, midTile);
-         inc(tmpX, tmpI, amountI, _d->midTilePos.getX(), newTile, midTile);
-      break;
-
-      case constants::south:
-         dec(tmpY, tmpJ, amountJ, _d->midTilePos.getY(), newTile, midTile);
-      break;
-
-      case constants::southWest:
-         dec(tmpY, tmpJ, amountJ, _d->midTilePos.getY(), newTile, midTile);
-         dec(tmpX, tmpI, amountI, _d->midTilePos.getX(), newTile, midTile);
-      break;
-
-      case constants::west:
-         dec(tmpX, tmpI, amountI, _d->midTilePos.getX(), newTile, midTile);
-      break;
-
-      case constants::northWest:
-         inc(tmpY, tmpJ, amountJ, _d->midTilePos.getY(), newTile, midTile);
-         dec(tmpX, tmpI, amountI, _d->midTilePos.getX(), newTile, midTile);
-      break;
-
-      default:
          Logger::warning( "Invalid move direction: %d", _d->action.direction);
          _d->action.direction = constants::noneDirection;
-      break;
       }
 
       _d->tileOffset = Point( tmpX, tmpY );
+      TilePos oldPos = _d->pos;
       _d->pos = TilePos( tmpI, tmpJ );
 
       if (newTile)
       {
          // walker is now on a new tile!
+         _d->city->updateWalkerPos( this, oldPos );
          onNewTile();
       }
 
@@ -334,10 +458,6 @@ void Walker::walk()
          // walker is now on the middle of the tile!
          onMidTile();
       }
-
-      // if (midTile) std::cout << "walker mid tile" << std::endl;
-      // if (newTile) std::cout << "walker new tile" << std::endl;
-      // if (amount != 0) std::cout << "walker remaining step :" << amount << std::endl;
    }
 
    Point overlayOffset = tile.getOverlay().isValid()
@@ -70,6 +70,9 @@ public:
   virtual void onNewDirection(); // called when the walker changes direction
   void computeDirection();
   void walk();
+  // computes movement of next walk(), reads and writes only walker's own state,
+  // so it may be called from worker thread
+  void prepareWalk();
   void setUniqueId( const UniqueId uid );
 
   constants::Direction getDirection();
@@ -124,6 +127,12 @@ private:
   void inc(int &ioSI, int &ioI, int &ioAmount, const int iMidPos, bool &oNewTile, bool &oMidTile);
   void dec(int &ioSI, int &ioI, int &ioAmount, const int iMidPos, bool &oNewTile, bool &oMidTile);
 
+  // one inc/dec move in current direction, returns false for invalid direction
+  bool _walkSegment( int& amountI, int& amountJ, int& x, int& y, int& i, int& j,
+                     bool& newTile, bool& midTile );
+  // fills prepared step from current state, returns false for invalid direction
+  bool _computeStep();
+
 private:   
   class Impl;
   ScopedPtr< Impl > _d;